@@ -86,6 +86,119 @@
 
 // Wi-Fi Configuration
 #define WIFI_TIMEOUT_MS     10000
+#define WIFI_RETRY_MIN_MS   1000    // First retry after a failed attempt or dropped link
+#define WIFI_RETRY_MAX_MS   60000   // Backoff cap
+#define WIFI_RETRY_JITTER   25      // +/- percent applied to each backoff delay
+#define NETWORK_MAX_LISTENERS 4
+#define WIFI_FAST_CONNECT_ENABLED   1       // Directed association from cached BSSID/channel
+#define WIFI_FAST_CONNECT_TIMEOUT_MS 4000   // Give up on the cached AP sooner than a full scan
+#define WIFI_REUSE_DHCP_LEASE       1       // Reapply a still-valid lease on reconnect instead of waiting for DHCP
+#define WIFI_LEASE_REUSE_MAX_MS     3600000 // Cap on the reuse window (also used when DHCP reports no T1)
+#define WIFI_NVS_NAMESPACE          "netcache"
+
+// HTTP / API Configuration
+#define HTTP_TIMEOUT_MS             5000
+#define API_POOL_MAX_CONNECTIONS    4       // Kept-alive connections (one per host in practice)
+#define API_POOL_IDLE_TIMEOUT_MS    60000   // Close connections idle longer than this
+#define API_STREAM_DRAIN_MAX_BYTES  2048    // Unread body to skip before dropping a kept-alive connection
+#define API_CACHE_MAX_ENTRIES       8       // URLs with cached ETag / Last-Modified validators
+#define API_ACCEPT_COMPRESSED       1       // Ask for gzip/deflate bodies on streamed requests
+#define INFLATE_INPUT_BUFFER_SIZE   512     // Compressed bytes read from the socket at a time
+
+// Streaming JSON ingestion (per-element document sizes, after filtering)
+#define HA_ENTITY_DOC_SIZE          1024
+#define SLACK_MESSAGE_DOC_SIZE      1536
+#define SPOTIFY_PLAYER_DOC_SIZE     2048
+
+// Home Assistant WebSocket API (state_changed subscription, REST polling as fallback)
+#define HA_WEBSOCKET_ENABLED        1
+#define HA_WS_PATH                  "/api/websocket"
+#define HA_WS_RETRY_MIN_MS          5000    // First reconnect after a drop, doubled per failure
+#define HA_WS_RETRY_MAX_MS          120000
+#define HA_WS_CONNECT_TIMEOUT_MS    10000   // Per step (connect, auth, subscribe) before the attempt counts as failed
+#define HA_WS_HEARTBEAT_MS          30000   // Ping interval; 2 missed pongs drop the socket
+#define HA_EVENT_DOC_SIZE           2048
+
+// Home Assistant entity store (hash-indexed by entity id, in PSRAM when available)
+#define HA_MAX_ENTITIES             2048    // At most 32767; tables and string pool are sized from it
+#define HA_MAX_ENTITIES_NO_PSRAM    256     // Capacity when the board has no PSRAM (internal RAM only)
+#define HA_VIEW_MAX_DEVICES         20      // Device icons shown per type
+#define HA_STRING_BYTES_PER_ENTITY  56      // String arena per entity slot: room for a name and an id that differs
+#define HA_STRINGS_PER_ENTITY       3       // Distinct interned strings per entity slot
+#define HA_CHANGE_LISTENERS         2       // Views notified of changed entities
+
+// Home Assistant entity subscription (per user; empty = every entity)
+#define HA_SUBSCRIPTION_MAX_ENTITIES 64     // Pinned entities plus members of subscribed areas
+#define HA_SUBSCRIPTION_MAX_DOMAINS  8
+#define HA_SUBSCRIPTION_MAX_AREAS    8
+
+// Slack Socket Mode (needs an app-level xapp- token, REST polling as fallback)
+#define SLACK_SOCKET_MODE_ENABLED       1
+#define SLACK_SOCKET_RETRY_MIN_MS       2000
+#define SLACK_SOCKET_RETRY_MAX_MS       60000
+#define SLACK_SOCKET_CONNECT_TIMEOUT_MS 15000
+#define SLACK_SOCKET_HEARTBEAT_MS       30000
+#define SLACK_EVENT_DOC_SIZE            2048
+
+// Slack incremental history sync (per-channel high-water ts)
+#define SLACK_SYNC_MAX_CHANNELS         16      // Channels with a stored cursor
+#define SLACK_SYNC_INITIAL_LIMIT        10      // Messages fetched for a channel without a cursor
+#define SLACK_SYNC_PAGE_LIMIT           50      // Messages per page when catching up
+#define SLACK_SYNC_MAX_PAGES            4       // Pages per channel per pass; the rest is skipped
+#define SLACK_SEEN_MESSAGES             256     // Message fingerprints kept for dedupe (power of two)
+
+// Slack notification history (ring buffer, in PSRAM when available)
+#define SLACK_NOTIFICATION_CAPACITY     64
+
+// Slack user / channel directory (names for notifications)
+#define SLACK_DIRECTORY_MAX_ENTRIES     512
+#define SLACK_DIRECTORY_ARENA_SIZE      12288   // Interned ids and names
+#define SLACK_DIRECTORY_PAGE_LIMIT      200     // users.list page size
+#define SLACK_DIRECTORY_TTL_MS          21600000    // Full users.list refresh (6 h)
+#define SLACK_DIRECTORY_MISS_REFRESH_MS 300000  // Earliest early refresh after an unknown user
+
+// Control command coalescing (sliders)
+#define COMMAND_COALESCE_INTERVAL_MS    250     // At most one control request per target per interval
+#define HA_CONTROL_SLOTS                4       // Entities with a live coalesced control
+#define HA_PENDING_OPS_MAX              16      // Optimistic Home Assistant commands awaiting confirmation
+#define HA_BATCH_MAX_ENTITIES           16      // Entities merged into one service call
+
+// Adaptive polling (see PollingPolicy)
+#define POLL_CONTEXT_REFRESH_MS         1000    // Route / screen / battery sampling
+#define POLL_HIDDEN_FACTOR              4.0f    // Consuming page not on screen
+#define POLL_SCREEN_OFF_FACTOR          10.0f   // Locked or backlight off
+#define POLL_BATTERY_LOW_FACTOR         2.0f    // Below 20%, not charging
+#define POLL_BATTERY_CRITICAL_FACTOR    4.0f    // Below 5%, not charging
+#define POLL_IDLE_FACTOR                2.0f    // Polls keep returning nothing new
+#define POLL_ACTIVE_FACTOR              0.5f    // Polls keep returning changes
+#define POLL_CHANGE_SMOOTHING           0.3f    // Weight of the latest poll in the change rate
+#define POLL_ABSOLUTE_MAX_MS            900000  // Never poll less than every 15 min
+#define SPOTIFY_POLL_INTERVAL_MS        15000   // Now playing while a track plays (the clock fills the gaps)
+#define SPOTIFY_PAUSED_POLL_MS          15000   // Now playing while paused / idle
+#define SPOTIFY_TRACK_END_SLACK_MS      1500    // Poll this long after the predicted track end
+#define SPOTIFY_CLOCK_DRIFT_MS          1500    // Larger drift between clock and server counts as a change
+#define SPOTIFY_CLOCK_VERIFY_MS         3000    // Follow-up poll after a drift
+#define SPOTIFY_VERIFY_INITIAL_MS       300     // First poll after a skip, doubled per retry
+#define SPOTIFY_VERIFY_MAX_DELAY_MS     2000    // Longest gap between skip verification polls
+#define SPOTIFY_VERIFY_TIMEOUT_MS       8000    // Stop verifying a skip after this long
+
+// Circuit breakers (per API origin)
+#define CIRCUIT_FAILURE_THRESHOLD       3       // Consecutive failures before opening
+#define CIRCUIT_OPEN_MIN_MS             5000    // First open period
+#define CIRCUIT_OPEN_MAX_MS             300000  // Backoff cap (also caps Retry-After)
+#define CIRCUIT_JITTER_PERCENT          20
+#define API_CIRCUIT_MAX_ORIGINS         6
+
+// Outbound request scheduler
+#define REQUEST_QUEUE_SIZE              12      // Queued jobs across all priority classes
+
+// TLS Session Resumption
+#define TLS_SESSION_CACHE_SIZE              4
+#define TLS_SESSION_MAX_BYTES               4096        // Serialized session incl. peer cert
+#define TLS_SESSION_TTL_MS                  (2UL * 60 * 60 * 1000)
+#define TLS_SESSION_PERSIST                 1           // Persist sessions (encrypted) to SD
+#define TLS_SESSION_PERSIST_INTERVAL_MS     60000
+#define TLS_SESSION_NVS_NAMESPACE           "tlscache"  // Device secret for the persisted-session key
 
 // Debug Configuration
 #define DEBUG_ENABLED       1
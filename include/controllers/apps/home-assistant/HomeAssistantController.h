@@ -12,36 +12,62 @@
 #include <Arduino.h>
 #include <HTTPClient.h>
 #include <ArduinoJson.h>
+#include <WebSocketsClient.h>
 #include "services/DatabaseService.h"
 #include "services/AuthService.h"
 #include "services/NetworkService.h"
+#include "services/ApiService.h"
+#include "services/RequestScheduler.h"
+#include "services/PollingPolicy.h"
+#include "utils/CommandCoalescer.h"
 #include "models/home-assistant/HomeAssistantDevice.h"
+#include "models/home-assistant/HomeAssistantEntityStore.h"
+#include "models/home-assistant/HomeAssistantSubscription.h"
 
 /**
- * @enum HomeAssistantDeviceType
- * @brief Types of Home Assistant devices
+ * @enum HomeAssistantOperationKind
+ * @brief Device commands tracked by the optimistic update journal
  */
-enum class HomeAssistantDeviceType {
-    LIGHT,
-    SWITCH,
-    SENSOR,
-    CLIMATE,
-    MEDIA_PLAYER,
-    COVER,
-    FAN,
-    LOCK,
-    UNKNOWN
+enum class HomeAssistantOperationKind : uint8_t {
+    TURN_ON,
+    TURN_OFF,
+    BRIGHTNESS,
+    COLOR,
+    COLOR_TEMP,
+    VOLUME,
+    SCENE
 };
 
 /**
- * @enum HomeAssistantDeviceState
- * @brief Device state
+ * @enum HomeAssistantSocketState
+ * @brief WebSocket API connection state
  */
-enum class HomeAssistantDeviceState {
-    ON,
-    OFF,
-    UNAVAILABLE,
-    UNKNOWN
+enum class HomeAssistantSocketState {
+    DISABLED,        // WebSocket mode off, REST polling only
+    DISCONNECTED,    // Waiting for (re)connect, REST polling fallback active
+    CONNECTING,      // Connect and upgrade in progress, REST polling fallback active
+    AUTHENTICATING,  // Connected, auth handshake in progress
+    SUBSCRIBING,     // Authenticated, waiting for the subscription result
+    LIVE             // Receiving state updates
+};
+
+/**
+ * @brief Device change listener
+ * @param slot Store slot of the changed device (see getDeviceAt)
+ * @param context User context pointer
+ */
+typedef void (*HomeAssistantChangeCallback)(uint16_t slot, void* context);
+
+/**
+ * @struct HomeAssistantSyncStats
+ * @brief Outcome of the last full state sync
+ */
+struct HomeAssistantSyncStats {
+    uint16_t received;    // Entities in the server listing
+    uint16_t changed;     // Stored entities whose state or attributes changed (new ones included)
+    uint16_t unchanged;   // Stored entities left as they were
+    uint16_t skipped;     // Not subscribed
+    uint16_t removed;     // Gone from the listing or no longer subscribed
 };
 
 /**
@@ -51,11 +77,15 @@ enum class HomeAssistantDeviceState {
  * Features:
  * - Device discovery and management
  * - Real-time state monitoring
- * - Device control (on/off, brightness, color)
+ * - Device control (on/off, brightness, color) with optimistic local updates
  * - Scene activation
  * - Automation triggers
  * - API authentication
- * - WebSocket support (future)
+ * - WebSocket event subscription (state_changed) with REST polling fallback
+ * - Per-user entity subscription (pinned entities, domains, areas) applied
+ *   while streaming, and as a server-side filter when it is a plain entity list
+ * - Diff-based state application: only entities whose state hash changed are
+ *   rewritten, and each of those is reported to change listeners
  */
 class HomeAssistantController {
 public:
@@ -111,6 +141,24 @@ public:
      */
     bool isAuthenticated();
 
+    /**
+     * @brief Check if the service is backed off (circuit breaker open)
+     * @return true while requests are refused locally
+     */
+    bool isDegraded();
+
+    /**
+     * @brief Get time until the backed-off service is probed again
+     * @return Milliseconds, 0 if not backed off
+     */
+    uint32_t getRetryDelay();
+
+    /**
+     * @brief Get WebSocket connection state
+     * @return Current socket state (LIVE when receiving push updates)
+     */
+    HomeAssistantSocketState getSocketState() const { return m_socketState; }
+
     /**
      * @brief Fetch all devices
      * @return true if successful
@@ -118,47 +166,114 @@ public:
     bool fetchDevices();
 
     /**
-     * @brief Get devices by type
+     * @brief Get the entities this user tracks
+     */
+    const HomeAssistantSubscription& getSubscription() const { return m_subscription; }
+
+    /**
+     * @brief Replace the tracked entities, save them for the current user and resync
+     *
+     * Entities no longer covered are dropped at the next sync; an empty
+     * subscription tracks every entity.
+     * @param subscription Pinned entities, domains and areas
+     */
+    void setSubscription(const HomeAssistantSubscription& subscription);
+
+    /**
+     * @brief Get number of entities the last full sync skipped (not subscribed)
+     */
+    int getSkippedEntityCount() const { return m_syncStats.skipped; }
+
+    /**
+     * @brief Get change counts of the last full sync
+     */
+    const HomeAssistantSyncStats& getLastSyncStats() const { return m_syncStats; }
+
+    /**
+     * @brief Register a device change listener
+     *
+     * Called once per device whose server state changed (sync, event or
+     * service response) and for local optimistic updates and rollbacks.
+     * Additions and removals change getDeviceVersion() instead.
+     * @param callback Listener function
+     * @param context Passed to callback
+     * @return true if registered
+     */
+    bool addChangeListener(HomeAssistantChangeCallback callback, void* context);
+
+    /**
+     * @brief Remove a device change listener
+     * @param callback Listener function
+     * @param context Context it was registered with
+     */
+    void removeChangeListener(HomeAssistantChangeCallback callback, void* context);
+
+    /**
+     * @brief Get devices by type (no copies)
      * @param type Device type filter
-     * @param devices Output array
-     * @param maxDevices Maximum devices to return
-     * @return Number of devices
+     * @return Span over the stored devices, valid until getDeviceVersion() changes
      */
-    int getDevicesByType(HomeAssistantDeviceType type, HomeAssistantDevice* devices, int maxDevices);
+    HomeAssistantDeviceSpan getDevicesByType(HomeAssistantDeviceType type) const;
 
     /**
-     * @brief Get all devices
-     * @param devices Output array
-     * @param maxDevices Maximum devices to return
-     * @return Number of devices
+     * @brief Get all devices (no copies), grouped by type
+     * @return Span over the stored devices, valid until getDeviceVersion() changes
      */
-    int getAllDevices(HomeAssistantDevice* devices, int maxDevices);
+    HomeAssistantDeviceSpan getAllDevices() const;
 
     /**
-     * @brief Get device by entity ID
+     * @brief Get number of known devices
+     */
+    int getDeviceCount() const { return m_entities.size(); }
+
+    /**
+     * @brief Get device membership version
+     *
+     * Changes whenever devices are added or removed; spans and slot numbers
+     * obtained before a change must be fetched again.
+     */
+    uint32_t getDeviceVersion() const { return m_entities.getVersion(); }
+
+    /**
+     * @brief Get device by entity ID (hash lookup)
      * @param entityId Entity ID (e.g., "light.living_room")
      * @return Pointer to device (or nullptr)
      */
     HomeAssistantDevice* getDevice(const String& entityId);
 
+    /**
+     * @brief Get device by store slot (see HomeAssistantDeviceSpan::slotAt)
+     * @return Pointer to device (or nullptr if the slot is free)
+     */
+    const HomeAssistantDevice* getDeviceAt(uint16_t slot) const { return m_entities.getSlot(slot); }
+
+    // Device commands are optimistic: the local device is patched right away
+    // and the call is queued in a pending-operations journal that update()
+    // drains. Server state (service response, events, polls) is reconciled
+    // with the journal, and a failed call rolls the device back.
+    //
+    // Queued commands that only differ in entity (same domain, service and
+    // data) are sent as one service call with an entity_id array. Each entity
+    // keeps its own journal entry, so confirmation and rollback stay per entity.
+
     /**
      * @brief Turn device on
      * @param entityId Entity ID
-     * @return true if successful
+     * @return true if queued
      */
     bool turnOn(const String& entityId);
 
     /**
      * @brief Turn device off
      * @param entityId Entity ID
-     * @return true if successful
+     * @return true if queued
      */
     bool turnOff(const String& entityId);
 
     /**
      * @brief Toggle device state
      * @param entityId Entity ID
-     * @return true if successful
+     * @return true if queued
      */
     bool toggle(const String& entityId);
 
@@ -166,7 +281,7 @@ public:
      * @brief Set light brightness
      * @param entityId Entity ID
      * @param brightness Brightness (0-255)
-     * @return true if successful
+     * @return true if queued
      */
     bool setBrightness(const String& entityId, uint8_t brightness);
 
@@ -174,7 +289,7 @@ public:
      * @brief Set light brightness (alias for setBrightness)
      * @param entityId Entity ID
      * @param brightness Brightness (0-255)
-     * @return true if successful
+     * @return true if queued
      */
     bool setLightBrightness(const String& entityId, uint8_t brightness) { return setBrightness(entityId, brightness); }
 
@@ -184,7 +299,7 @@ public:
      * @param r Red (0-255)
      * @param g Green (0-255)
      * @param b Blue (0-255)
-     * @return true if successful
+     * @return true if queued
      */
     bool setColor(const String& entityId, uint8_t r, uint8_t g, uint8_t b);
 
@@ -192,14 +307,14 @@ public:
      * @brief Set light color temperature
      * @param entityId Entity ID
      * @param colorTemp Color temperature in mireds
-     * @return true if successful
+     * @return true if queued
      */
     bool setColorTemp(const String& entityId, uint16_t colorTemp);
 
     /**
      * @brief Activate a scene
      * @param sceneId Scene entity ID (e.g., "scene.movie_time")
-     * @return true if successful
+     * @return true if queued
      */
     bool activateScene(const String& sceneId);
 
@@ -207,10 +322,76 @@ public:
      * @brief Set media player volume
      * @param entityId Entity ID
      * @param volume Volume level (0.0-1.0)
-     * @return true if successful
+     * @return true if queued
      */
     bool setMediaPlayerVolume(const String& entityId, float volume);
 
+    /**
+     * @brief Turn a group of devices on or off (e.g. every light in a room)
+     * @param entityIds Entity IDs (any mix of domains)
+     * @param count Number of entity IDs
+     * @param on Target state
+     * @return Number of entities queued
+     */
+    int setPowerForEntities(const String* entityIds, int count, bool on);
+
+    /**
+     * @brief Set the same brightness on a group of lights
+     * @param entityIds Light entity IDs
+     * @param count Number of entity IDs
+     * @param brightness Brightness (0-255)
+     * @return Number of entities queued
+     */
+    int setBrightnessForEntities(const String* entityIds, int count, uint8_t brightness);
+
+    /**
+     * @brief Get number of service calls sent for journal commands
+     */
+    uint32_t getServiceCallCount() const { return m_serviceCalls; }
+
+    /**
+     * @brief Get number of journal commands those calls carried
+     */
+    uint32_t getBatchedOperationCount() const { return m_batchedOperations; }
+
+    /**
+     * @brief Request light brightness from a continuous control (slider)
+     *
+     * Updates the local device immediately; requests are rate-limited per
+     * entity and only the latest value is sent.
+     * @param entityId Entity ID
+     * @param brightness Brightness (0-255)
+     */
+    void requestBrightness(const String& entityId, uint8_t brightness);
+
+    /**
+     * @brief Request media player volume from a continuous control (slider)
+     * @param entityId Entity ID
+     * @param volume Volume level (0.0-1.0)
+     */
+    void requestMediaPlayerVolume(const String& entityId, float volume);
+
+    /**
+     * @brief Send pending slider values now (call when the drag ends)
+     */
+    void flushControls();
+
+    /**
+     * @brief Get number of commands not yet confirmed by the server
+     */
+    int getPendingOperationCount() const;
+
+    /**
+     * @brief Check if an entity has unconfirmed commands (e.g. show "syncing")
+     * @param entityId Entity ID
+     */
+    bool hasPendingOperation(const String& entityId) const;
+
+    /**
+     * @brief Get number of optimistic updates rolled back after a failed call
+     */
+    uint32_t getRolledBackCount() const { return m_rolledBackCount; }
+
     /**
      * @brief Get device state by entity ID
      * @param entityId Entity ID
@@ -235,22 +416,116 @@ private:
     HomeAssistantController(const HomeAssistantController&) = delete;
     HomeAssistantController& operator=(const HomeAssistantController&) = delete;
 
-    bool makeAPIRequest(const String& endpoint, const String& method, const String& payload, String& response);
-    void parseDevices(const String& jsonResponse);
+    bool makeAPIRequest(const String& endpoint, const String& method, const String& payload, String& response,
+                        bool conditional = false);
+    bool makeStreamRequest(const String& endpoint, const String& method, const String& payload,
+                           ApiStreamHandler handler, void* context, bool conditional = false);
+    bool checkResponse(int httpCode);
+    static bool handleStatesStream(Stream& body, void* context);
+    static bool handleStateEntity(JsonObject state, void* context);
+    void parseDevice(HomeAssistantDevice& device, const String& stateStr, JsonObject attributes);
+    bool applyState(HomeAssistantDevice& device, const String& stateStr, JsonObject attributes);
+    void markLocalChange(HomeAssistantDevice& device);
+    void publishChange(const HomeAssistantDevice& device);
+    static uint32_t hashState(const String& stateStr, JsonObjectConst attributes);
     void updateDeviceState(const String& entityId, const String& state, const JsonObject& attributes);
     HomeAssistantDeviceType getDeviceTypeFromEntityId(const String& entityId);
+    static void buildEntityFilter(JsonObject attributes);
+
+    // Entity subscription
+    void loadSubscription();
+    bool resolveSubscriptionAreas();
+
+    // Optimistic update journal
+    struct PendingOperation {
+        uint32_t id;                    // 0 = free slot
+        HomeAssistantOperationKind kind;
+        String entityId;
+        float value;
+        uint8_t r, g, b;
+        HomeAssistantDevice snapshot;   // Device before this command, rebased on server state (rollback)
+        bool hasSnapshot;
+        bool inFlight;
+    };
+
+    bool enqueueOperation(HomeAssistantOperationKind kind, const String& entityId,
+                          float value = 0.0f, uint8_t r = 0, uint8_t g = 0, uint8_t b = 0);
+    void processPendingOperations();
+    void scheduleOperations();
+    static bool runPendingOperations(void* context);
+    static bool runFetchDevices(void* context);
+    void rollbackOperation(PendingOperation* op);
+    bool reapplyPendingOperations(HomeAssistantDevice& device);
+    static void applyOperation(HomeAssistantDevice& device, const PendingOperation& op);
+    static bool isSameControl(HomeAssistantOperationKind a, HomeAssistantOperationKind b);
+    static void describeOperation(const PendingOperation& op, String& domain, String& service, JsonObject data);
+    static bool canBatch(const PendingOperation& a, const PendingOperation& b);
+    bool sendServiceCall(const String& domain, const String& service, JsonDocument& payload);
+    static bool handleServiceResponse(Stream& body, void* context);
+    static bool handleChangedState(JsonObject state, void* context);
+
+    // Coalesced slider controls
+    enum class ControlKind : uint8_t {
+        BRIGHTNESS,
+        VOLUME
+    };
+
+    struct ControlSlot {
+        String entityId;
+        ControlKind kind;
+        CommandCoalescer coalescer;
+    };
+
+    ControlSlot* getControlSlot(const String& entityId, ControlKind kind);
+    static bool sendControl(float value, void* context);
+
+    // WebSocket API
+    void startSocket();
+    bool openSocket();
+    void stopSocket();
+    void scheduleSocketRetry();
+    void sendSocketMessage(JsonDocument& doc);
+    void subscribeSocket();
+    void handleSocketMessage(const uint8_t* payload, size_t length);
+    static void onSocketEvent(WStype_t type, uint8_t* payload, size_t length);
 
     String m_serverUrl;
     String m_accessToken;
     bool m_authenticated;
     bool m_initialized;
-
-    HomeAssistantDevice* m_devices;
-    int m_deviceCount;
-    int m_maxDevices;
-
-    uint32_t m_lastPollTime;
-    uint32_t m_pollInterval;  // Polling interval in ms
+    int m_lastHttpCode;
+
+    HomeAssistantEntityStore m_entities;
+    bool m_entitiesFullLogged;
+    HomeAssistantSubscription m_subscription;
+    HomeAssistantSyncStats m_syncStats;  // Current/last full sync
+    bool m_subscriptionChanged;   // Next full sync must not be answered from the cache
+
+    struct ChangeListener {
+        HomeAssistantChangeCallback callback;
+        void* context;
+    };
+    ChangeListener m_changeListeners[HA_CHANGE_LISTENERS];
+
+    PollSchedule m_pollSchedule;  // Fallback polling while the socket isn't live
+
+    WebSocketsClient m_socket;
+    HomeAssistantSocketState m_socketState;
+    uint32_t m_socketStateSince;
+    uint32_t m_socketRetryAt;
+    uint32_t m_socketBackoff;
+    uint32_t m_socketMessageId;   // Last id sent on the socket (ids must increase per connection)
+    uint32_t m_subscribeId;       // Id of the pending/active subscription command
+    bool m_serverFiltered;        // Subscription is a server-side entity filter (subscribe_trigger)
+    bool m_resyncPending;         // Re-fetch full state after (re)subscribing
+
+    ControlSlot m_controls[HA_CONTROL_SLOTS];
+
+    PendingOperation m_operations[HA_PENDING_OPS_MAX];
+    uint32_t m_lastOperationId;
+    uint32_t m_rolledBackCount;
+    uint32_t m_serviceCalls;
+    uint32_t m_batchedOperations;
 };
 
 #endif // HOME_ASSISTANT_CONTROLLER_H
@@ -12,10 +12,17 @@
 #include <Arduino.h>
 #include <HTTPClient.h>
 #include <ArduinoJson.h>
+#include <WebSocketsClient.h>
 #include "services/DatabaseService.h"
 #include "services/AuthService.h"
 #include "services/NetworkService.h"
+#include "services/ApiService.h"
+#include "services/RequestScheduler.h"
+#include "services/PollingPolicy.h"
 #include "models/slack/SlackNotification.h"
+#include "models/slack/SlackDirectory.h"
+#include "utils/FingerprintSet.h"
+#include "utils/RingBuffer.h"
 
 /**
  * @enum SlackNotificationType
@@ -31,14 +38,34 @@ enum class SlackNotificationType {
     UNKNOWN
 };
 
+/**
+ * @brief Stable reference to a buffered notification
+ *
+ * Stays valid until the notification is evicted by newer ones or cleared;
+ * resolving a stale handle yields nullptr.
+ */
+typedef RingBuffer<SlackNotification>::Handle SlackNotificationHandle;
+
+/**
+ * @enum SlackSocketState
+ * @brief Socket Mode connection state
+ */
+enum class SlackSocketState {
+    DISABLED,       // No app token (or rejected), REST polling only
+    DISCONNECTED,   // Waiting to reconnect, REST polling fallback active
+    CONNECTING,     // WebSocket opening, waiting for hello
+    LIVE            // Receiving events
+};
+
 /**
  * @class SlackController
  * @brief Singleton controller for Slack integration
  * 
  * Features:
- * - Real-time notifications
- * - Message monitoring
+ * - Real-time notifications (Socket Mode, REST polling fallback)
+ * - Message monitoring (incremental per-channel sync, deduplicated)
  * - Channel tracking
+ * - User / channel name directory (batched list refresh, persisted)
  * - Mention alerts
  * - Call notifications
  * - API authentication
@@ -74,6 +101,29 @@ public:
      */
     String getToken();
 
+    /**
+     * @brief Set app-level token (xapp-...) used to open Socket Mode connections
+     * @param token App-level token with connections:write scope
+     */
+    void setAppToken(const String& token);
+
+    /**
+     * @brief Set Web API base URL (e.g. a local stand-in server)
+     * @param apiBase Base URL without trailing slash
+     */
+    void setApiBase(const String& apiBase);
+
+    /**
+     * @brief Get Web API base URL
+     */
+    String getApiBase() const { return m_apiBase; }
+
+    /**
+     * @brief Get Socket Mode connection state
+     * @return Current state (LIVE when events are pushed)
+     */
+    SlackSocketState getSocketState() const { return m_socketState; }
+
     /**
      * @brief Authenticate with Slack
      * @return true if authenticated
@@ -86,6 +136,18 @@ public:
      */
     bool isAuthenticated();
 
+    /**
+     * @brief Check if the service is backed off (circuit breaker open)
+     * @return true while requests are refused locally
+     */
+    bool isDegraded();
+
+    /**
+     * @brief Get time until the backed-off service is probed again
+     * @return Milliseconds, 0 if not backed off
+     */
+    uint32_t getRetryDelay();
+
     /**
      * @brief Get unread notification count
      * @return Number of unread notifications
@@ -96,10 +158,34 @@ public:
      * @brief Get latest notification
      * @return Pointer to notification (or nullptr)
      */
-    SlackNotification* getLatestNotification();
+    const SlackNotification* getLatestNotification() const;
+
+    /**
+     * @brief Get number of buffered notifications
+     */
+    int getNotificationCount() const { return m_notifications.size(); }
+
+    /**
+     * @brief Get a buffered notification without copying it
+     * @param index 0 = newest
+     * @return Notification, or nullptr if out of range
+     */
+    const SlackNotification* getNotification(int index) const;
 
     /**
-     * @brief Get all notifications
+     * @brief Get the stable handle of a buffered notification
+     * @param index 0 = newest
+     */
+    SlackNotificationHandle getNotificationHandle(int index) const;
+
+    /**
+     * @brief Resolve a handle
+     * @return Notification, or nullptr if it has been evicted
+     */
+    const SlackNotification* findNotification(SlackNotificationHandle handle) const;
+
+    /**
+     * @brief Get all notifications (copies; prefer getNotification for display)
      * @param notifications Output array
      * @param maxNotifications Maximum notifications to return
      * @return Number of notifications
@@ -113,6 +199,12 @@ public:
 
     /**
      * @brief Mark notification as read
+     * @param handle Notification handle
+     */
+    void markAsRead(SlackNotificationHandle handle);
+
+    /**
+     * @brief Mark notification as read by message ts (linear search)
      * @param notificationId Notification ID
      */
     void markAsRead(const String& notificationId);
@@ -136,12 +228,43 @@ public:
     bool fetchConversations();
 
     /**
-     * @brief Fetch messages from a channel
+     * @brief Fetch messages from a channel posted since its last sync
+     *
+     * Only messages newer than the channel's stored high-water ts are
+     * requested (all pages up to SLACK_SYNC_MAX_PAGES); a channel without
+     * one gets its latest SLACK_SYNC_INITIAL_LIMIT messages.
      * @param channelId Channel ID
      * @return true if successful
      */
     bool fetchMessages(const String& channelId);
 
+    /**
+     * @brief Forget all sync cursors (next sync refetches recent history)
+     */
+    void resetSyncCursors();
+
+    /**
+     * @brief Get number of messages skipped as already seen
+     */
+    uint32_t getDuplicateCount() const { return m_duplicateCount; }
+
+    /**
+     * @brief Resolve a user id from the local directory (never blocks on the network)
+     * @return Display name, or empty if not known yet
+     */
+    String getUserName(const String& userId);
+
+    /**
+     * @brief Resolve a conversation id from the local directory
+     * @return "#channel" / "@user" name, or empty if not known yet
+     */
+    String getChannelName(const String& channelId);
+
+    /**
+     * @brief Get user / channel directory
+     */
+    const SlackDirectory& getDirectory() const { return m_directory; }
+
     /**
      * @brief Send a message
      * @param channelId Channel ID
@@ -157,23 +280,87 @@ private:
     SlackController& operator=(const SlackController&) = delete;
 
     bool makeAPIRequest(const String& endpoint, const String& method, const String& payload, String& response);
-    void parseNotifications(const String& jsonResponse);
-    void addNotification(const SlackNotification& notification);
+    bool makeStreamRequest(const String& endpoint, const String& method, const String& payload,
+                           ApiStreamHandler handler, void* context, bool conditional = false);
+    bool checkResponse(int httpCode);
+    static bool readOkFlag(Stream& body, String& error);
+    void handleApiError(const String& error);
+    static bool handleMessagesStream(Stream& body, void* context);
+    static bool handleMessage(JsonObject msg, void* context);
+    static bool handleConversationsStream(Stream& body, void* context);
+    static bool handleChannel(JsonObject channel, void* context);
+    static bool runFetchConversations(void* context);
+    static bool runSyncHistory(void* context);
+    bool acceptMessage(const String& channelId, const String& ts);
+    static String readNextCursor(Stream& body);
+
+    // Directory
+    static bool runRefreshDirectory(void* context);
+    static bool handleMembersStream(Stream& body, void* context);
+    static bool handleMember(JsonObject member, void* context);
+    void putChannelName(const String& channelId, const String& name);
+    void resolveNames(SlackNotification& notification);
+    void noteDirectoryMiss();
+    void loadDirectory();
+    void saveDirectory();
+    static int compareTs(const String& a, const String& b);
+
+    // Sync cursors
+    struct ChannelCursor {
+        String channelId;       // Empty = free slot
+        String latestTs;        // Newest message seen, empty until the first sync
+        bool seen;              // Listed by the last conversations.list
+    };
+
+    ChannelCursor* findCursor(const String& channelId, bool create);
+    void loadSyncCursors();
+    void saveSyncCursors();
+    void addNotification(SlackNotification&& notification);
+
+    // Socket Mode
+    bool openSocket();
+    void stopSocket();
+    void scheduleSocketRetry();
+    void handleSocketMessage(const uint8_t* payload, size_t length);
+    void handleSocketEvent(JsonObject event);
+    static void onSocketEvent(WStype_t type, uint8_t* payload, size_t length);
 
     String m_token;
+    String m_appToken;
+    String m_apiBase;
     String m_workspaceName;
     String m_userDisplayName;
     String m_userId;
     bool m_authenticated;
     bool m_initialized;
 
-    SlackNotification* m_notifications;
-    int m_notificationCount;
-    int m_maxNotifications;
+    RingBuffer<SlackNotification> m_notifications;
     int m_unreadCount;
 
-    uint32_t m_lastPollTime;
-    uint32_t m_pollInterval;  // Polling interval in ms
+    ChannelCursor m_cursors[SLACK_SYNC_MAX_CHANNELS];
+    bool m_cursorsDirty;
+    int m_syncIndex;              // Next cursor slot of the running history pass
+    int m_syncUnreadBefore;
+    String m_syncChannel;         // Channel of the history page being streamed
+    String m_syncNewestTs;        // Newest ts on the pages streamed so far
+    String m_syncNextCursor;
+    FingerprintSet<SLACK_SEEN_MESSAGES> m_seenMessages;
+    uint32_t m_duplicateCount;
+
+    SlackDirectory m_directory;
+    bool m_directoryDirty;
+    bool m_directoryRefreshing;
+    uint32_t m_directoryRefreshedAt;  // millis() of the last complete users.list, 0 = not this session
+    uint32_t m_directoryNextRefresh;
+    String m_directoryCursor;         // users.list page cursor of the running refresh
+
+    PollSchedule m_pollSchedule;  // Fallback polling while Socket Mode isn't live
+
+    WebSocketsClient m_socket;
+    SlackSocketState m_socketState;
+    uint32_t m_socketStateSince;
+    uint32_t m_socketRetryAt;
+    uint32_t m_socketBackoff;
 };
 
 #endif // SLACK_CONTROLLER_H
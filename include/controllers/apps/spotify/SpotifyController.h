@@ -15,6 +15,10 @@
 #include "models/spotify/SpotifyTrack.h"
 #include "services/DatabaseService.h"
 #include "services/AuthService.h"
+#include "services/ApiService.h"
+#include "services/RequestScheduler.h"
+#include "services/PollingPolicy.h"
+#include "utils/CommandCoalescer.h"
 
 /**
  * @class SpotifyController
@@ -24,8 +28,8 @@
  * - OAuth authentication
  * - Now playing updates
  * - Playback control (play/pause/skip)
- * - Volume control
- * - Seek control
+ * - Volume control (coalesced for sliders)
+ * - Seek control (coalesced for sliders)
  * - Playlist/album context
  */
 class SpotifyController {
@@ -41,6 +45,11 @@ public:
      */
     bool init();
 
+    /**
+     * @brief Update controller (sends coalesced slider commands, call each frame)
+     */
+    void update();
+
     /**
      * @brief Set access token
      * @param token OAuth access token
@@ -52,12 +61,62 @@ public:
      */
     String getAccessToken() const { return m_accessToken; }
 
+    /**
+     * @brief Point the controller at another Web API host (e.g. a recorded-payload server)
+     * @param apiBase Base URL including the /v1 prefix, without trailing slash
+     */
+    void setApiBase(const String& apiBase);
+
+    /**
+     * @brief Get Web API base URL
+     */
+    String getApiBase() const { return m_apiBase; }
+
     /**
      * @brief Update now playing information
      * @return true if successful
      */
     bool updateNowPlaying();
 
+    /**
+     * @brief Queue a now playing refresh on the request scheduler
+     * @param deadlineMs Drop the refresh if it hasn't started within this time
+     * @return true if queued
+     */
+    bool requestNowPlaying(uint32_t deadlineMs);
+
+    /**
+     * @brief Poll now playing on the next update (e.g. when the view opens)
+     */
+    void refreshNowPlaying() { m_pollSchedule.pollNow(); }
+
+    /**
+     * @brief Get time of the last successful now playing update
+     * @return millis() timestamp, 0 if never
+     */
+    uint32_t getLastUpdateTime() const { return m_lastUpdateTime; }
+
+    /**
+     * @brief Get round trip time of the last now playing request
+     */
+    uint32_t getLastRtt() const { return m_lastRtt; }
+
+    /**
+     * @brief Get difference between reported and extrapolated position at the last sync
+     * @return Milliseconds (positive = server ahead of the local clock)
+     */
+    int getLastClockDrift() const { return m_lastClockDrift; }
+
+    /**
+     * @brief Get number of syncs where the drift exceeded SPOTIFY_CLOCK_DRIFT_MS
+     */
+    uint32_t getClockResyncCount() const { return m_clockResyncCount; }
+
+    /**
+     * @brief Check if a skip is still waiting for the new track to show up
+     */
+    bool isVerifying() const { return m_verifying; }
+
     /**
      * @brief Get current track
      */
@@ -83,13 +142,16 @@ public:
 
     /**
      * @brief Skip to next track
-     * @return true if successful
+     *
+     * Returns as soon as Spotify accepts the command. The new track is picked
+     * up by follow-up polls on the request scheduler.
+     * @return true if the command was accepted
      */
     bool skipNext();
 
     /**
-     * @brief Skip to previous track
-     * @return true if successful
+     * @brief Skip to previous track (see skipNext)
+     * @return true if the command was accepted
      */
     bool skipPrevious();
 
@@ -107,6 +169,26 @@ public:
      */
     bool seek(int position);
 
+    /**
+     * @brief Request volume from a continuous control (slider)
+     *
+     * Updates the local track immediately; the request itself is rate-limited
+     * and only the latest value is sent.
+     * @param volume Volume level (0-100)
+     */
+    void requestVolume(int volume);
+
+    /**
+     * @brief Request seek from a continuous control (slider)
+     * @param position Position in milliseconds
+     */
+    void requestSeek(int position);
+
+    /**
+     * @brief Send pending slider values now (call when the drag ends)
+     */
+    void flushControls();
+
     /**
      * @brief Set shuffle mode
      * @param shuffle true to enable shuffle
@@ -126,6 +208,18 @@ public:
      */
     bool isAuthenticated() const { return m_accessToken.length() > 0; }
 
+    /**
+     * @brief Check if the service is backed off (circuit breaker open)
+     * @return true while requests are refused locally
+     */
+    bool isDegraded();
+
+    /**
+     * @brief Get time until the backed-off service is probed again
+     * @return Milliseconds, 0 if not backed off
+     */
+    uint32_t getRetryDelay();
+
     /**
      * @brief Get last error message
      */
@@ -139,18 +233,45 @@ private:
 
     bool makeApiRequest(const String& endpoint, const String& method, 
                        const String& body, String& response);
-    bool parseNowPlaying(const String& json);
+    bool makeStreamRequest(const String& endpoint, const String& method, const String& body,
+                           ApiStreamHandler handler, void* context, bool conditional = false);
+    bool checkResponse(int httpCode);
+    static bool handleNowPlayingStream(Stream& body, void* context);
+    bool parseNowPlaying(Stream& json);
     void loadAccessToken();
     void saveAccessToken();
+    static bool sendVolume(float value, void* context);
+    static bool sendSeek(float value, void* context);
+    static bool runNowPlaying(void* context);
+    void startVerification();
+    void continueVerification();
 
     String m_accessToken;
+    String m_apiBase;
     SpotifyTrack m_currentTrack;
     String m_lastError;
-    HTTPClient m_http;
     bool m_initialized;
+    bool m_nowPlayingReceived;
+    int m_lastHttpCode;
+    uint32_t m_lastUpdateTime;
+    uint32_t m_lastRtt;
+    int m_lastClockDrift;
+    uint32_t m_clockResyncCount;
+    bool m_clockDriftDetected;
+
+    // Post-command verification: poll until the track id moves off m_verifyFromId
+    bool m_verifying;
+    String m_verifyFromId;
+    uint8_t m_verifyAttempts;
+    uint32_t m_verifyStarted;
+
+    PollSchedule m_pollSchedule;
+
+    CommandCoalescer m_volumeCoalescer;
+    CommandCoalescer m_seekCoalescer;
 
     // Spotify Web API endpoints
-    static constexpr const char* API_BASE = "https://api.spotify.com/v1";
+    static constexpr const char* DEFAULT_API_BASE = "https://api.spotify.com/v1";
     static constexpr const char* EP_NOW_PLAYING = "/me/player/currently-playing";
     static constexpr const char* EP_PLAY = "/me/player/play";
     static constexpr const char* EP_PAUSE = "/me/player/pause";
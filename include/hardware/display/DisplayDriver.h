@@ -38,6 +38,12 @@ public:
      */
     void setBrightness(uint8_t brightness);
 
+    /**
+     * @brief Get display brightness
+     * @return Level 0-255 (0 = backlight off)
+     */
+    uint8_t getBrightness() const { return m_brightness; }
+
     /**
      * @brief Get TFT instance for direct drawing
      */
@@ -105,6 +111,7 @@ private:
 
     TFT_eSPI m_tft;
     TFT_eSprite* m_sprite;
+    uint8_t m_brightness;
     bool m_initialized;
 };
 
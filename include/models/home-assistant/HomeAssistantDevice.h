@@ -1,8 +1,13 @@
 /**
  * @file HomeAssistantDevice.h
  * @brief Home Assistant device data model - MVC Model Layer
- * 
- * Data structure for Home Assistant devices.
+ *
+ * Data structure for Home Assistant devices. Strings are interned into a
+ * shared pool (two bytes per field) and type-specific attributes share
+ * one tagged union, so a device record is 16 bytes with no heap blocks of
+ * its own. The entity id is not stored whole: its domain follows from the
+ * type, and the object id is only pooled when the friendly name doesn't
+ * spell it (Home Assistant derives default ids from names).
  * Part of MVC architecture - Model layer.
  */
 
@@ -10,64 +15,202 @@
 #define HOME_ASSISTANT_DEVICE_H
 
 #include <Arduino.h>
+#include "utils/StringPool.h"
 
-// Forward declarations
-enum class HomeAssistantDeviceType;
-enum class HomeAssistantDeviceState;
+/**
+ * @enum HomeAssistantDeviceType
+ * @brief Types of Home Assistant devices
+ */
+enum class HomeAssistantDeviceType : uint8_t {
+    LIGHT,
+    SWITCH,
+    SENSOR,
+    CLIMATE,
+    MEDIA_PLAYER,
+    COVER,
+    FAN,
+    LOCK,
+    UNKNOWN
+};
+
+/**
+ * @enum HomeAssistantDeviceState
+ * @brief Device state
+ */
+enum class HomeAssistantDeviceState : uint8_t {
+    ON,
+    OFF,
+    UNAVAILABLE,
+    UNKNOWN
+};
+
+/**
+ * @class HomeAssistantString
+ * @brief Two-byte reference to a string in the Home Assistant string pool
+ *
+ * Copies share the pooled characters; equal strings always have equal ids.
+ * c_str() stays valid until the next string is interned.
+ */
+class HomeAssistantString {
+public:
+    HomeAssistantString() : m_id(StringPool::EMPTY_ID) {}
+    HomeAssistantString(const HomeAssistantString& other) : m_id(other.m_id) { pool().retain(m_id); }
+    ~HomeAssistantString() { pool().release(m_id); }
+
+    HomeAssistantString& operator=(const HomeAssistantString& other) {
+        pool().retain(other.m_id);
+        pool().release(m_id);
+        m_id = other.m_id;
+        return *this;
+    }
+
+    HomeAssistantString& operator=(const String& text) { return assign(text.c_str(), text.length()); }
+    HomeAssistantString& operator=(const char* text) { return assign(text, text ? strlen(text) : 0); }
+
+    HomeAssistantString& assign(const char* text, size_t length) {
+        // Intern first so re-assigning the same text never frees it in between
+        uint16_t id = pool().intern(text, length);
+        pool().release(m_id);
+        m_id = id;
+        return *this;
+    }
+
+    const char* c_str() const { return pool().get(m_id); }
+    size_t length() const { return pool().length(m_id); }
+    String toString() const { return String(c_str()); }
+
+    bool operator==(const HomeAssistantString& other) const { return m_id == other.m_id; }
+    bool operator==(const String& text) const {
+        return text.length() == length() && memcmp(text.c_str(), c_str(), text.length()) == 0;
+    }
+    bool operator!=(const String& text) const { return !(*this == text); }
+
+    /**
+     * @brief Shared pool behind every HomeAssistantString
+     */
+    static StringPool& pool();
+
+    /**
+     * @brief Size the shared pool for a number of entities (first call only)
+     * @return false if out of memory
+     */
+    static bool allocatePool(uint16_t entities);
+
+private:
+    uint16_t m_id;
+};
+
+inline bool operator==(const String& text, const HomeAssistantString& pooled) { return pooled == text; }
+inline bool operator!=(const String& text, const HomeAssistantString& pooled) { return !(pooled == text); }
 
 /**
  * @struct HomeAssistantDevice
  * @brief Home Assistant device data
+ *
+ * Attribute accessors only apply to their device type: getters return 0 /
+ * empty and setters are ignored for other types.
  */
 struct HomeAssistantDevice {
-    String entityId;
-    String friendlyName;
     HomeAssistantDeviceType type;
     HomeAssistantDeviceState state;
-    
-    // Light-specific attributes
-    uint8_t brightness;      // 0-255
-    uint8_t colorR;          // 0-255
-    uint8_t colorG;          // 0-255
-    uint8_t colorB;          // 0-255
-    uint16_t colorTemp;      // Color temperature in mireds
-    bool hasColor;
-    bool hasColorTemp;
-    
-    // Climate-specific attributes
-    float temperature;
-    float targetTemperature;
-    String hvacMode;
-    
-    // Media player-specific attributes
-    String mediaTitle;
-    String mediaArtist;
-    float volume;
-    
-    // Sensor-specific attributes
-    String sensorValue;
-    String unit;
-    
+
     HomeAssistantDevice()
-        : entityId("")
-        , friendlyName("")
-        , brightness(0)
-        , colorR(0)
-        , colorG(0)
-        , colorB(0)
-        , colorTemp(0)
-        , hasColor(false)
-        , hasColorTemp(false)
-        , temperature(0.0f)
-        , targetTemperature(0.0f)
-        , hvacMode("")
-        , mediaTitle("")
-        , mediaArtist("")
-        , volume(0.0f)
-        , sensorValue("")
-        , unit("") {}
-};
+        : type(HomeAssistantDeviceType::UNKNOWN)
+        , state(HomeAssistantDeviceState::UNKNOWN) {
+        memset(&m_attributes, 0, sizeof(m_attributes));
+    }
 
-#endif // HOME_ASSISTANT_DEVICE_H
+    // Identity
+    String getEntityId() const;
+    bool hasEntityId(const String& entityId) const;     // Compares without building the id
+    const HomeAssistantString& getFriendlyName() const { return m_name; }
+
+    /**
+     * @brief Set the entity id (set type first; the id's domain must match it)
+     * @return false if the domain doesn't match or the string pool is full
+     */
+    bool setEntityId(const String& entityId);
+    void setFriendlyName(const String& name);
+
+    // Light
+    uint8_t getBrightness() const { return isType(HomeAssistantDeviceType::LIGHT) ? m_attributes.light.brightness : 0; }
+    bool hasColor() const { return isType(HomeAssistantDeviceType::LIGHT) && (m_attributes.light.flags & LIGHT_HAS_COLOR); }
+    uint8_t getColorR() const { return hasColor() ? m_attributes.light.r : 0; }
+    uint8_t getColorG() const { return hasColor() ? m_attributes.light.g : 0; }
+    uint8_t getColorB() const { return hasColor() ? m_attributes.light.b : 0; }
+    bool hasColorTemp() const { return isType(HomeAssistantDeviceType::LIGHT) && (m_attributes.light.flags & LIGHT_HAS_COLOR_TEMP); }
+    uint16_t getColorTemp() const { return hasColorTemp() ? m_attributes.light.colorTemp : 0; }    // Mireds
+
+    void setBrightness(uint8_t brightness);
+    void setColor(uint8_t r, uint8_t g, uint8_t b);
+    void clearColor();
+    void setColorTemp(uint16_t mireds);
+    void clearColorTemp();
+
+    // Climate (stored in tenths of a degree)
+    float getTemperature() const { return isType(HomeAssistantDeviceType::CLIMATE) ? m_attributes.climate.current / 10.0f : 0.0f; }
+    float getTargetTemperature() const { return isType(HomeAssistantDeviceType::CLIMATE) ? m_attributes.climate.target / 10.0f : 0.0f; }
+    const HomeAssistantString& getHvacMode() const { return textFor(HomeAssistantDeviceType::CLIMATE, 0); }
+
+    void setTemperature(float temperature);
+    void setTargetTemperature(float temperature);
+    void setHvacMode(const String& mode);
+
+    // Media player (volume stored in thousandths)
+    const HomeAssistantString& getMediaTitle() const { return textFor(HomeAssistantDeviceType::MEDIA_PLAYER, 0); }
+    const HomeAssistantString& getMediaArtist() const { return textFor(HomeAssistantDeviceType::MEDIA_PLAYER, 1); }
+    float getVolume() const { return isType(HomeAssistantDeviceType::MEDIA_PLAYER) ? m_attributes.media.volume / 1000.0f : 0.0f; }
 
+    void setMediaTitle(const String& title);
+    void setMediaArtist(const String& artist);
+    void setVolume(float volume);
 
+    // Sensor (decimal states are kept as fixed point, anything else as text)
+    String getSensorValue() const;
+    const HomeAssistantString& getUnit() const { return textFor(HomeAssistantDeviceType::SENSOR, 1); }
+
+    void setSensorValue(const String& value);
+    void setUnit(const String& unit);
+
+private:
+    static constexpr uint8_t LIGHT_HAS_COLOR = 0x01;
+    static constexpr uint8_t LIGHT_HAS_COLOR_TEMP = 0x02;
+
+    bool isType(HomeAssistantDeviceType t) const { return type == t; }
+    const HomeAssistantString& textFor(HomeAssistantDeviceType t, int index) const;
+    void setText(HomeAssistantDeviceType t, int index, const String& text);
+    const char* getDomain() const;
+    String getObjectId() const;
+    void dropDerivedObjectId();
+
+    HomeAssistantString m_objectId;     // Entity id after the domain, empty while the name spells it
+    HomeAssistantString m_name;
+
+    // Meaning depends on type: climate [hvac mode], media [title, artist],
+    // sensor [text value, unit], unknown [domain]
+    HomeAssistantString m_text[2];
+
+    union {
+        struct {
+            uint8_t brightness;     // 0-255
+            uint8_t r, g, b;
+            uint16_t colorTemp : 12;    // Mireds
+            uint16_t flags : 4;
+        } light;
+        struct {
+            int16_t current;
+            int16_t target;
+        } climate;
+        struct {
+            uint16_t volume;        // 0-1000
+        } media;
+        struct {
+            uint16_t low;           // Value * 10^decimals, split to keep the union 2-byte aligned
+            int16_t high;
+            uint8_t decimals;
+            bool numeric;           // false: the value is text in m_text[0]
+        } sensor;
+    } m_attributes;
+};
+
+#endif // HOME_ASSISTANT_DEVICE_H
@@ -0,0 +1,197 @@
+/**
+ * @file HomeAssistantEntityStore.h
+ * @brief Hash-indexed Home Assistant entity table - MVC Model Layer
+ *
+ * Owns every known HomeAssistantDevice. Entities live in fixed slots (in
+ * PSRAM when available) and are found through an open-addressing index on
+ * the entity id, so lookups stay O(1) however many entities the server
+ * has. Queries by type return spans of slot numbers instead of copies.
+ * Each slot also keeps a hash of the server state last applied to it, so
+ * unchanged entities can be skipped on the next sync.
+ * Part of MVC architecture - Model layer.
+ */
+
+#ifndef HOME_ASSISTANT_ENTITY_STORE_H
+#define HOME_ASSISTANT_ENTITY_STORE_H
+
+#include <Arduino.h>
+#include "config/Config.h"
+#include "models/home-assistant/HomeAssistantDevice.h"
+
+class HomeAssistantEntityStore;
+
+/**
+ * @class HomeAssistantDeviceSpan
+ * @brief Read-only view of a group of entities in the store
+ *
+ * Valid until the store's membership changes (see
+ * HomeAssistantEntityStore::getVersion); device contents behind it are
+ * live and reflect every later state update.
+ */
+class HomeAssistantDeviceSpan {
+public:
+    HomeAssistantDeviceSpan()
+        : m_store(nullptr)
+        , m_slots(nullptr)
+        , m_count(0) {}
+
+    HomeAssistantDeviceSpan(const HomeAssistantEntityStore* store, const uint16_t* slots, uint16_t count)
+        : m_store(store)
+        , m_slots(slots)
+        , m_count(count) {}
+
+    int size() const { return m_count; }
+    bool isEmpty() const { return m_count == 0; }
+
+    /**
+     * @brief Get store slot of the i-th entity (stable while the entity exists)
+     */
+    uint16_t slotAt(int index) const { return m_slots[index]; }
+
+    const HomeAssistantDevice& operator[](int index) const;
+
+private:
+    const HomeAssistantEntityStore* m_store;
+    const uint16_t* m_slots;
+    uint16_t m_count;
+};
+
+/**
+ * @class HomeAssistantEntityStore
+ * @brief Fixed-capacity entity table with an id index and a per-type order
+ */
+class HomeAssistantEntityStore {
+public:
+    static constexpr uint16_t INVALID_SLOT = 0xFFFF;
+
+    HomeAssistantEntityStore();
+    ~HomeAssistantEntityStore();
+    HomeAssistantEntityStore(const HomeAssistantEntityStore&) = delete;
+    HomeAssistantEntityStore& operator=(const HomeAssistantEntityStore&) = delete;
+
+    /**
+     * @brief Allocate slots, index and the shared string pool
+     * @param capacity Maximum number of entities
+     * @return false if out of memory
+     */
+    bool allocate(uint16_t capacity);
+
+    /**
+     * @brief Find an entity
+     * @return Device, or nullptr if unknown
+     */
+    HomeAssistantDevice* find(const String& entityId);
+    const HomeAssistantDevice* find(const String& entityId) const;
+
+    /**
+     * @brief Find an entity, adding an empty one if it is new
+     * @param entityId Entity ID
+     * @param type Device type for a new entity
+     * @return Device, or nullptr if the store or string pool is full
+     */
+    HomeAssistantDevice* findOrInsert(const String& entityId, HomeAssistantDeviceType type);
+
+    /**
+     * @brief Remove an entity
+     * @return true if it existed
+     */
+    bool remove(const String& entityId);
+
+    /**
+     * @brief Remove every entity
+     */
+    void clear();
+
+    /**
+     * @brief Get the device in a slot
+     * @return Device, or nullptr if the slot is free
+     */
+    const HomeAssistantDevice* getSlot(uint16_t slot) const;
+
+    /**
+     * @brief Get the slot a device lives in
+     */
+    uint16_t slotOf(const HomeAssistantDevice& device) const { return (uint16_t)(&device - m_devices); }
+
+    /**
+     * @brief Record the hash of the server state applied to a device
+     * @param device Device in this store
+     * @param hash State hash (0 is reserved for "unknown")
+     * @return true if it differs from the recorded hash (the state changed)
+     */
+    bool updateStateHash(const HomeAssistantDevice& device, uint32_t hash);
+
+    /**
+     * @brief Forget a device's state hash so the next server state is applied
+     *
+     * For local changes (optimistic updates) the server has not reported yet.
+     */
+    void invalidateStateHash(const HomeAssistantDevice& device) { m_stateHashes[slotOf(device)] = 0; }
+
+    /**
+     * @brief Get every entity, grouped by type
+     */
+    HomeAssistantDeviceSpan all() const;
+
+    /**
+     * @brief Get entities of one type
+     */
+    HomeAssistantDeviceSpan byType(HomeAssistantDeviceType type) const;
+
+    /**
+     * @brief Start a full resync: every entity is "unseen" until touched again
+     */
+    void beginSweep();
+
+    /**
+     * @brief Finish a full resync, removing entities the server no longer listed
+     * @return Number of entities removed
+     */
+    int endSweep();
+
+    uint16_t size() const { return m_count; }
+    uint16_t capacity() const { return m_capacity; }
+
+    /**
+     * @brief Get bytes owned by the store (records, hashes, index), excluding pooled strings
+     */
+    size_t getFootprint() const;
+
+    /**
+     * @brief Get membership version (changes whenever entities are added or removed)
+     */
+    uint32_t getVersion() const { return m_version; }
+
+private:
+    friend class HomeAssistantDeviceSpan;
+
+    static constexpr int TYPE_COUNT = (int)HomeAssistantDeviceType::UNKNOWN + 1;
+
+    int findSlot(const String& entityId, uint32_t hash) const;
+    void eraseIndex(uint16_t slot);
+    void rebuildTypeOrder() const;
+    static uint32_t hashId(const char* id);
+
+    HomeAssistantDevice* m_devices;     // m_capacity slots
+    uint32_t* m_hashes;                 // Entity id hash per slot
+    uint32_t* m_stateHashes;            // Hash of the last applied server state per slot, 0 = none
+    uint8_t* m_flags;                   // SLOT_USED / SLOT_SEEN per slot
+    uint16_t* m_index;                  // Open addressing on the id hash: slot + 1, 0 = empty
+    uint16_t m_indexMask;
+    uint16_t* m_freeSlots;              // Stack of free slots
+    uint16_t m_freeCount;
+    uint16_t m_capacity;
+    uint16_t m_count;
+    uint32_t m_version;
+
+    // Used slots sorted by type, rebuilt on the first query after a membership change
+    mutable uint16_t* m_typeOrder;
+    mutable uint16_t m_typeStart[TYPE_COUNT + 1];
+    mutable uint32_t m_typeOrderVersion;
+};
+
+inline const HomeAssistantDevice& HomeAssistantDeviceSpan::operator[](int index) const {
+    return m_store->m_devices[m_slots[index]];
+}
+
+#endif // HOME_ASSISTANT_ENTITY_STORE_H
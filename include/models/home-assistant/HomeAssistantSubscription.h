@@ -0,0 +1,133 @@
+/**
+ * @file HomeAssistantSubscription.h
+ * @brief Per-user set of Home Assistant entities to track - MVC Model Layer
+ *
+ * Pinned entities, whole domains and areas the user wants on the device.
+ * Ingestion checks every incoming entity against it before anything is
+ * stored, so a server with thousands of entities only costs what the user
+ * actually looks at. An empty subscription accepts everything.
+ * Part of MVC architecture - Model layer.
+ */
+
+#ifndef HOME_ASSISTANT_SUBSCRIPTION_H
+#define HOME_ASSISTANT_SUBSCRIPTION_H
+
+#include <Arduino.h>
+#include "config/Config.h"
+
+/**
+ * @class HomeAssistantSubscription
+ * @brief Entity allowlist: pinned entity ids, domains and areas
+ *
+ * Areas are resolved to entity ids by the controller (the state API does
+ * not carry them); until then entities are only matched by pin or domain.
+ */
+class HomeAssistantSubscription {
+public:
+    HomeAssistantSubscription();
+
+    /**
+     * @brief Check if nothing is selected (every entity is accepted)
+     */
+    bool isEmpty() const { return m_pinnedCount == 0 && m_domainCount == 0 && m_areaCount == 0; }
+
+    /**
+     * @brief Check if an entity should be tracked
+     * @param entityId Entity ID (e.g., "light.kitchen")
+     */
+    bool matches(const char* entityId) const;
+
+    /**
+     * @brief Pin an entity
+     * @return false if the list is full
+     */
+    bool addEntity(const String& entityId);
+
+    /**
+     * @brief Unpin an entity
+     * @return true if it was pinned
+     */
+    bool removeEntity(const String& entityId);
+
+    /**
+     * @brief Track every entity of a domain (e.g., "light")
+     * @return false if the list is full
+     */
+    bool addDomain(const String& domain);
+
+    /**
+     * @brief Track every entity assigned to an area (area id or name)
+     * @return false if the list is full
+     */
+    bool addArea(const String& area);
+
+    /**
+     * @brief Remove every pin, domain and area
+     */
+    void clear();
+
+    int getDomainCount() const { return m_domainCount; }
+    const String& getDomain(int index) const { return m_domains[index]; }
+    int getAreaCount() const { return m_areaCount; }
+    const String& getArea(int index) const { return m_areas[index]; }
+
+    /**
+     * @brief Get number of tracked entity ids (pinned plus resolved area members)
+     */
+    int getEntityCount() const { return m_entityCount; }
+    const String& getEntity(int index) const { return m_entities[index].entityId; }
+
+    /**
+     * @brief Replace the resolved area members
+     * @param entityIds Comma-separated entity ids
+     * @return Number of entities added
+     */
+    int setAreaEntities(const String& entityIds);
+
+    /**
+     * @brief Check if area members must be (re)resolved
+     */
+    bool needsAreaResolve() const { return m_areaCount > 0 && !m_areasResolved; }
+
+    /**
+     * @brief Check if the server can do the filtering (explicit entity list only)
+     *
+     * Domains cannot be expressed as a server-side entity filter, and areas
+     * can only once they are resolved.
+     */
+    bool canFilterOnServer() const { return m_entityCount > 0 && m_domainCount == 0 && !needsAreaResolve(); }
+
+    /**
+     * @brief Serialize as "E\tid\n" / "D\tdomain\n" / "A\tarea\n" lines
+     */
+    String serialize() const;
+
+    /**
+     * @brief Replace the contents with serialized data
+     * @return Number of lines loaded
+     */
+    int deserialize(const String& data);
+
+private:
+    struct Entry {
+        String entityId;
+        uint32_t hash;
+        bool fromArea;
+    };
+
+    int findEntity(const char* entityId, uint32_t hash) const;
+    bool addEntry(const String& entityId, bool fromArea);
+    void removeAt(int index);
+    static uint32_t hashId(const char* id);
+
+    Entry m_entities[HA_SUBSCRIPTION_MAX_ENTITIES];
+    int m_entityCount;
+    int m_pinnedCount;
+    String m_domains[HA_SUBSCRIPTION_MAX_DOMAINS];
+    int m_domainCount;
+    String m_areas[HA_SUBSCRIPTION_MAX_AREAS];
+    int m_areaCount;
+    bool m_areasResolved;
+};
+
+#endif // HOME_ASSISTANT_SUBSCRIPTION_H
@@ -0,0 +1,98 @@
+/**
+ * @file SlackDirectory.h
+ * @brief Slack user and channel name directory - MVC Model Layer
+ *
+ * Maps Slack user and conversation ids to display names so notifications
+ * can be rendered without a network call. Ids and names are interned into
+ * one character arena; each entry is a fixed 12-byte record of offsets.
+ * Part of MVC architecture - Model layer.
+ */
+
+#ifndef SLACK_DIRECTORY_H
+#define SLACK_DIRECTORY_H
+
+#include <Arduino.h>
+#include "config/Config.h"
+
+/**
+ * @enum SlackDirectoryKind
+ * @brief Namespace of a directory entry
+ */
+enum class SlackDirectoryKind : uint8_t {
+    USER,
+    CHANNEL
+};
+
+/**
+ * @class SlackDirectory
+ * @brief Interned id -> name table with serialization for the database
+ */
+class SlackDirectory {
+public:
+    SlackDirectory();
+    ~SlackDirectory();
+    SlackDirectory(const SlackDirectory&) = delete;
+    SlackDirectory& operator=(const SlackDirectory&) = delete;
+
+    /**
+     * @brief Add or rename an entry
+     * @param kind User or channel
+     * @param id Slack id (U.../C.../D...)
+     * @param name Display name
+     * @return false if the table or arena is full
+     */
+    bool put(SlackDirectoryKind kind, const char* id, const char* name);
+
+    /**
+     * @brief Look up a name
+     * @return Name, or nullptr if the id is unknown
+     */
+    const char* lookup(SlackDirectoryKind kind, const String& id) const;
+
+    /**
+     * @brief Remove every entry
+     */
+    void clear();
+
+    /**
+     * @brief Serialize as "U\tid\tname\n" / "C\tid\tname\n" lines
+     */
+    String serialize() const;
+
+    /**
+     * @brief Replace the contents with serialized data
+     * @return Number of entries loaded
+     */
+    int deserialize(const String& data);
+
+    /**
+     * @brief Get number of entries
+     */
+    uint16_t getEntryCount() const { return m_entryCount; }
+
+    /**
+     * @brief Get arena bytes in use (including names replaced by a rename)
+     */
+    size_t getArenaUsed() const { return m_arenaUsed; }
+
+private:
+    struct Entry {
+        uint32_t idHash;
+        uint16_t idOffset;
+        uint16_t nameOffset;
+        SlackDirectoryKind kind;
+    };
+
+    int find(SlackDirectoryKind kind, const char* id, uint32_t idHash) const;
+    bool reserve(size_t bytes);
+    uint16_t append(const char* text);
+    void compact();
+    static uint32_t hashId(const char* id);
+
+    char* m_arena;
+    size_t m_arenaUsed;
+    Entry m_entries[SLACK_DIRECTORY_MAX_ENTRIES];
+    uint16_t m_entryCount;
+};
+
+#endif // SLACK_DIRECTORY_H
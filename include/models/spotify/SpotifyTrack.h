@@ -36,7 +36,9 @@ enum class RepeatMode {
  * @class SpotifyTrack
  * @brief Model representing a Spotify track
  * 
- * Contains track metadata and playback information
+ * Contains track metadata and playback information. The position is a
+ * playback clock: the last known position plus the local time it was valid
+ * at, extrapolated while playing so the UI can advance smoothly between polls.
  */
 class SpotifyTrack {
 public:
@@ -58,7 +60,9 @@ public:
     String getAlbum() const { return m_album; }
     String getAlbumArtUrl() const { return m_albumArtUrl; }
     int getDuration() const { return m_duration; }  // milliseconds
-    int getPosition() const { return m_position; }  // milliseconds
+    int getPosition() const { return m_position; }  // milliseconds, as of getPositionSyncedAt()
+    uint32_t getPositionSyncedAt() const { return m_positionSyncedAt; }  // millis()
+    uint64_t getServerTimestamp() const { return m_serverTimestamp; }  // Unix ms
     PlaybackState getPlaybackState() const { return m_playbackState; }
     int getVolume() const { return m_volume; }  // 0-100
     bool isShuffle() const { return m_shuffle; }
@@ -72,14 +76,22 @@ public:
     void setAlbum(const String& album) { m_album = album; }
     void setAlbumArtUrl(const String& url) { m_albumArtUrl = url; }
     void setDuration(int duration) { m_duration = duration; }
-    void setPosition(int position) { m_position = position; }
-    void setPlaybackState(PlaybackState state) { m_playbackState = state; }
+    void setPosition(int position) { setPosition(position, millis()); }
+    void setPosition(int position, uint32_t syncedAt);
+    void setPlaybackState(PlaybackState state);  // Freezes the clock when playback stops
+    void setServerTimestamp(uint64_t timestamp) { m_serverTimestamp = timestamp; }
     void setVolume(int volume);  // Clamps to 0-100
     void setShuffle(bool shuffle) { m_shuffle = shuffle; }
     void setRepeatMode(RepeatMode mode) { m_repeatMode = mode; }
     void setContextUri(const String& uri) { m_contextUri = uri; }
 
     // Utility methods
+    /**
+     * @brief Get position extrapolated to now
+     * @return Milliseconds (clamped to the duration)
+     */
+    int getEstimatedPosition() const;
+
     /**
      * @brief Get progress as percentage (0-100)
      */
@@ -129,7 +141,9 @@ private:
     String m_album;
     String m_albumArtUrl;
     int m_duration;          // Total duration in ms
-    int m_position;          // Current position in ms
+    int m_position;          // Position in ms at m_positionSyncedAt
+    uint32_t m_positionSyncedAt;  // Local millis() the position was valid at
+    uint64_t m_serverTimestamp;   // Spotify "timestamp" of the last sync
     PlaybackState m_playbackState;
     int m_volume;            // 0-100
     bool m_shuffle;
@@ -0,0 +1,291 @@
+/**
+ * @file ApiService.h
+ * @brief Shared HTTP(S) client with keep-alive connection pooling - MVC Service Layer
+ *
+ * Owns every outbound HTTP connection used by the app controllers. Connections
+ * are pooled per scheme/host/port so repeated polls reuse an established
+ * TCP/TLS session instead of paying a full handshake on every request.
+ * Part of MVC architecture - Service layer.
+ */
+
+#ifndef API_SERVICE_H
+#define API_SERVICE_H
+
+#include <Arduino.h>
+#include <WiFiClient.h>
+#include <WiFiClientSecure.h>
+#include <HTTPClient.h>
+#include "config/Config.h"
+#include "utils/LatencyHistogram.h"
+#include "utils/CircuitBreaker.h"
+#include "utils/InflateStream.h"
+
+class HttpBodyStream;
+
+// Request refused locally because the origin's circuit breaker is open
+#define API_ERROR_CIRCUIT_OPEN  (-100)
+
+/**
+ * @struct ApiHeader
+ * @brief Extra request header
+ */
+struct ApiHeader {
+    const char* name;
+    String value;
+};
+
+/**
+ * @brief Response body handler for streamed requests
+ * @param body Response body (already de-chunked), read directly from the socket
+ * @param context User context pointer
+ * @return true if the body was handled successfully
+ */
+typedef bool (*ApiStreamHandler)(Stream& body, void* context);
+
+/**
+ * @struct ApiPoolStats
+ * @brief Connection pool metrics
+ */
+struct ApiPoolStats {
+    uint32_t requests;          // Requests sent through the pool
+    uint32_t handshakes;        // New TCP/TLS connections opened
+    uint32_t handshakesSaved;   // Requests served on a kept-alive connection
+    uint32_t tlsResumed;        // TLS handshakes that resumed a cached session
+    uint32_t reconnects;        // Kept-alive connections found closed by the server
+    uint32_t evictions;         // Idle connections closed by the pool
+    uint32_t bytesStreamed;     // Body bytes consumed by stream handlers (as received)
+    uint32_t compressedResponses;   // Streamed bodies that arrived gzip/deflate encoded
+    uint32_t bytesInflated;     // Decompressed size of those bodies
+    uint32_t circuitRejected;   // Requests refused by an open circuit breaker
+    uint8_t openConnections;    // Currently open pooled connections
+};
+
+/**
+ * @struct ApiCacheStats
+ * @brief Conditional GET (ETag / Last-Modified) metrics
+ */
+struct ApiCacheStats {
+    uint32_t conditionalRequests;   // GETs sent with If-None-Match / If-Modified-Since
+    uint32_t notModified;           // 304 responses (parsing skipped)
+    uint32_t bytesSaved;            // Body bytes not transferred thanks to 304s
+    uint8_t entries;                // Validators currently cached
+};
+
+/**
+ * @class ApiService
+ * @brief Singleton HTTP client with a per-host keep-alive connection pool
+ *
+ * Features:
+ * - Connection pool keyed by scheme, host and port
+ * - HTTP keep-alive (TLS session stays up between requests)
+ * - Idle connection limit and idle timeout eviction
+ * - Transparent reconnect when the server closed a kept-alive socket
+ * - TLS session resumption on reconnect (see TlsSessionCache)
+ * - Handshake metrics and latency histograms (full vs resumed)
+ * - Conditional GET validator cache (ETag / Last-Modified)
+ * - Per-origin circuit breakers honouring Retry-After and 429s
+ */
+class ApiService {
+public:
+    /**
+     * @brief Get singleton instance
+     */
+    static ApiService& getInstance();
+
+    /**
+     * @brief Initialize service
+     * @return true if successful
+     */
+    bool init();
+
+    /**
+     * @brief Update service (evicts idle connections, call periodically)
+     */
+    void update();
+
+    /**
+     * @brief Perform an HTTP request on a pooled connection
+     * @param method HTTP method (GET, POST, PUT, DELETE)
+     * @param url Absolute URL (http:// or https://)
+     * @param body Request body (empty for none)
+     * @param headers Extra headers (may be nullptr)
+     * @param headerCount Number of extra headers
+     * @param response Output response body (left empty on 304)
+     * @param conditional Send cached validators for this GET; the caller must
+     *                    treat HTTP_CODE_NOT_MODIFIED as "keep what you have"
+     * @return HTTP status code, or negative HTTPClient error code
+     *         (API_ERROR_CIRCUIT_OPEN if the origin is backed off)
+     */
+    int request(const String& method, const String& url, const String& body,
+                const ApiHeader* headers, int headerCount, String& response,
+                bool conditional = false);
+
+    /**
+     * @brief Perform an HTTP request and hand the body to a stream handler
+     *
+     * The body is never buffered: the handler reads it straight off the
+     * connection (chunked encoding is decoded transparently). The handler is
+     * only called for 2xx responses that carry a body (never for HEAD, 204 or
+     * 205, nor for an empty Content-Length). Whatever the handler
+     * leaves unread is drained so the connection can be kept alive.
+     *
+     * @param method HTTP method
+     * @param url Absolute URL
+     * @param body Request body (empty for none)
+     * @param headers Extra headers (may be nullptr)
+     * @param headerCount Number of extra headers
+     * @param handler Body handler
+     * @param context Passed to handler
+     * @param conditional Send cached validators for this GET; on 304 the
+     *                    handler is not called
+     * @return HTTP status code, or negative HTTPClient error code
+     *         (HTTPC_ERROR_STREAM_WRITE if the handler returned false,
+     *         API_ERROR_CIRCUIT_OPEN if the origin is backed off)
+     */
+    int requestStream(const String& method, const String& url, const String& body,
+                      const ApiHeader* headers, int headerCount,
+                      ApiStreamHandler handler, void* context,
+                      bool conditional = false);
+
+    /**
+     * @brief Close all pooled connections
+     */
+    void closeAll();
+
+    /**
+     * @brief Get pool metrics
+     * @return ApiPoolStats snapshot
+     */
+    ApiPoolStats getStats() const;
+
+    /**
+     * @brief Get conditional GET cache metrics
+     * @return ApiCacheStats snapshot
+     */
+    ApiCacheStats getCacheStats() const;
+
+    /**
+     * @brief Drop all cached validators (e.g. on user switch)
+     */
+    void clearCache();
+
+    /**
+     * @brief Reset pool and cache metrics
+     */
+    void resetStats();
+
+    /**
+     * @brief Get TLS handshake latency histogram
+     * @param resumed true for resumed (abbreviated) handshakes, false for full
+     * @return Histogram of handshake durations
+     */
+    const LatencyHistogram& getHandshakeHistogram(bool resumed) const {
+        return resumed ? m_resumedHandshakes : m_fullHandshakes;
+    }
+
+    /**
+     * @brief Get circuit breaker state of a URL's origin
+     * @param url Absolute URL (path ignored)
+     * @return CLOSED if the origin has no breaker yet
+     */
+    CircuitState getCircuitState(const String& url);
+
+    /**
+     * @brief Get time until a backed-off origin is probed again
+     * @param url Absolute URL (path ignored)
+     * @return Milliseconds, 0 if requests may go out
+     */
+    uint32_t getCircuitRetryDelay(const String& url);
+
+    /**
+     * @brief Report an application-level failure (e.g. HTTP 200 with an auth error)
+     * @param url Absolute URL (path ignored)
+     * @param retryAfterMs Server-specified delay, or 0 for the next backoff step
+     */
+    void reportFailure(const String& url, uint32_t retryAfterMs = 0);
+
+    /**
+     * @brief Split an absolute http(s)/ws(s) URL into its origin parts
+     * @param url Absolute URL
+     * @param secure Output: true for https/wss
+     * @param host Output host name
+     * @param port Output port (scheme default if not given)
+     * @return true if the URL was valid
+     */
+    static bool parseUrl(const String& url, bool& secure, String& host, uint16_t& port);
+
+private:
+    ApiService();
+    ~ApiService();
+    ApiService(const ApiService&) = delete;
+    ApiService& operator=(const ApiService&) = delete;
+
+    /**
+     * @struct PooledConnection
+     * @brief One kept-alive connection to a scheme/host/port
+     */
+    struct PooledConnection {
+        bool secure;
+        String host;
+        uint16_t port;
+        WiFiClient* client;     // ResumableTlsClient when secure
+        HTTPClient http;
+        uint32_t lastUsed;
+        bool inUse;
+    };
+
+    /**
+     * @struct CacheEntry
+     * @brief Validators from the last 200 response for a URL
+     */
+    struct CacheEntry {
+        String url;
+        uint32_t headerHash;    // Requests with other credentials don't share validators
+        String etag;
+        String lastModified;
+        uint32_t bodySize;      // Size of the cached representation (for bytesSaved)
+        uint32_t lastUsed;
+    };
+
+    /**
+     * @struct OriginCircuit
+     * @brief Circuit breaker for one scheme/host/port
+     */
+    struct OriginCircuit {
+        String host;
+        uint16_t port;
+        CircuitBreaker breaker;
+    };
+
+    int execute(const String& method, const String& url, const String& body,
+                const ApiHeader* headers, int headerCount, const CacheEntry* validators,
+                PooledConnection*& conn, bool acceptCompressed = false);
+    bool consumeStream(PooledConnection* conn, ApiStreamHandler handler, void* context, size_t& bodySize);
+    CacheEntry* findCacheEntry(const String& url, uint32_t headerHash);
+    void updateCache(PooledConnection* conn, const String& url, uint32_t headerHash, size_t bodySize);
+    void recordNotModified(CacheEntry* entry);
+    CircuitBreaker* findCircuit(const String& host, uint16_t port, bool create);
+    CircuitBreaker* findCircuit(const String& url);
+    void recordOutcome(CircuitBreaker* circuit, PooledConnection* conn, int httpCode);
+    static uint32_t hashHeaders(const ApiHeader* headers, int headerCount);
+    static bool isRetryable(const String& method, int httpCode);
+    static bool hasBody(const String& method, int httpCode);
+    PooledConnection* acquire(bool secure, const String& host, uint16_t port);
+    void release(PooledConnection* conn);
+    void closeConnection(PooledConnection* conn);
+    int sendOnConnection(PooledConnection* conn, const String& method, const String& url,
+                         const String& body, const ApiHeader* headers, int headerCount,
+                         const CacheEntry* validators, bool acceptCompressed);
+
+    PooledConnection m_pool[API_POOL_MAX_CONNECTIONS];
+    ApiPoolStats m_stats;
+    CacheEntry m_cache[API_CACHE_MAX_ENTRIES];
+    ApiCacheStats m_cacheStats;
+    OriginCircuit m_circuits[API_CIRCUIT_MAX_ORIGINS];
+    LatencyHistogram m_fullHandshakes;
+    LatencyHistogram m_resumedHandshakes;
+    InflateStream m_inflate;    // Shared: only one streamed response is read at a time
+    bool m_initialized;
+};
+
+#endif // API_SERVICE_H
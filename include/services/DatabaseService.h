@@ -178,6 +178,7 @@ private:
 
     bool createTables();
     bool executeSQL(const String& sql);
+    static String escapeSQL(const String& value);
     
     // Encryption helpers
     String encrypt(const String& plaintext);
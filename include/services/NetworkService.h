@@ -12,6 +12,7 @@
 #include <Arduino.h>
 #include <WiFi.h>
 #include "config/Config.h"
+#include "utils/LatencyHistogram.h"
 
 /**
  * @enum NetworkStatus
@@ -22,9 +23,29 @@ enum class NetworkStatus {
     CONNECTING,
     CONNECTED,
     FAILED,
-    NO_SSID
+    NO_SSID,
+    RETRY_WAIT      // Waiting out the backoff before the next attempt
 };
 
+/**
+ * @enum NetworkEvent
+ * @brief Connection events published to listeners
+ */
+enum class NetworkEvent {
+    CONNECTING,         // Association attempt started
+    CONNECTED,          // Associated and got an IP address
+    DISCONNECTED,       // Lost an established connection
+    CONNECT_FAILED,     // Attempt failed (timeout, auth, AP not found)
+    RETRY_SCHEDULED     // Next attempt scheduled after backoff
+};
+
+/**
+ * @brief Network event listener
+ * @param event Event that occurred
+ * @param context User context pointer
+ */
+typedef void (*NetworkEventCallback)(NetworkEvent event, void* context);
+
 /**
  * @struct WiFiNetwork
  * @brief Wi-Fi network information
@@ -40,10 +61,23 @@ struct WiFiNetwork {
  * @class NetworkService
  * @brief Singleton service for network management
  * 
+ * Connection management is a non-blocking state machine driven by ESP
+ * Wi-Fi events: connect() only starts an attempt, and the outcome is
+ * published to listeners from update() on the main loop. Failed attempts
+ * and dropped connections are retried with exponential backoff and jitter.
+ *
+ * The BSSID and channel of the last good connection are kept in NVS. The
+ * next attempt associates directly with that AP (skipping the scan); if
+ * that fails it falls back to a full scan-and-associate. A reconnect before
+ * the DHCP lease's renewal time (T1) also reapplies the leased address,
+ * skipping DHCP, and hands back to DHCP at T1. The lease is only tracked in
+ * RAM: without a wall clock its age can't be known after a reboot.
+ *
  * Features:
  * - Wi-Fi connection management
  * - Network scanning
- * - Auto-reconnect
+ * - Auto-reconnect with backoff
+ * - Fast reconnect from cached BSSID/channel/lease
  * - Signal strength monitoring
  * - Credential storage
  */
@@ -61,16 +95,16 @@ public:
     bool init();
 
     /**
-     * @brief Connect to Wi-Fi network
+     * @brief Start connecting to a Wi-Fi network (returns immediately)
      * @param ssid Network SSID
      * @param password Network password
-     * @param timeout Connection timeout in milliseconds
-     * @return true if connected
+     * @param timeout Per-attempt timeout in milliseconds
+     * @return true if the attempt was started
      */
     bool connect(const String& ssid, const String& password, uint32_t timeout = WIFI_TIMEOUT_MS);
 
     /**
-     * @brief Disconnect from Wi-Fi
+     * @brief Disconnect from Wi-Fi (no reconnect until connect() is called)
      */
     void disconnect();
 
@@ -145,10 +179,80 @@ public:
     void setAutoReconnect(bool enable);
 
     /**
-     * @brief Update connection status (call periodically)
+     * @brief Process Wi-Fi events and retry timers (call periodically)
      */
     void update();
 
+    /**
+     * @brief Register a connection event listener
+     * @param callback Listener function
+     * @param context Passed to callback
+     * @return true if registered
+     */
+    bool addListener(NetworkEventCallback callback, void* context);
+
+    /**
+     * @brief Remove a connection event listener
+     * @param callback Listener function
+     * @param context Context it was registered with
+     */
+    void removeListener(NetworkEventCallback callback, void* context);
+
+    /**
+     * @brief Get time until the next connection attempt
+     * @return Milliseconds, or 0 if no retry is scheduled
+     */
+    uint32_t getRetryDelay() const;
+
+    /**
+     * @brief Get number of consecutive failed attempts
+     */
+    uint8_t getFailedAttempts() const { return m_failedAttempts; }
+
+    /**
+     * @brief Use a fixed IP configuration instead of DHCP (persisted in NVS)
+     * @param ip Local IP
+     * @param gateway Gateway
+     * @param subnet Subnet mask
+     * @param dns DNS server
+     */
+    void setStaticIP(const IPAddress& ip, const IPAddress& gateway,
+                     const IPAddress& subnet, const IPAddress& dns);
+
+    /**
+     * @brief Go back to DHCP
+     */
+    void clearStaticIP();
+
+    /**
+     * @brief Check if a static IP configuration is set
+     */
+    bool hasStaticIP() const { return m_staticIP.valid; }
+
+    /**
+     * @brief Forget the cached BSSID/channel/lease (next attempt does a full scan)
+     */
+    void clearConnectionCache();
+
+    /**
+     * @brief Get time from boot to the first connection
+     * @return Milliseconds, or 0 if not connected yet
+     */
+    uint32_t getBootToOnlineMs() const { return m_bootToOnlineMs; }
+
+    /**
+     * @brief Check if the first connection used the cached fast path
+     */
+    bool wasBootFastPath() const { return m_bootFastPath; }
+
+    /**
+     * @brief Get attempt-to-online latency histogram
+     * @param fastPath true for cached directed attempts, false for full scans
+     */
+    const LatencyHistogram& getConnectHistogram(bool fastPath) const {
+        return fastPath ? m_fastConnects : m_fullConnects;
+    }
+
     /**
      * @brief Save Wi-Fi credentials
      * @param ssid Network SSID
@@ -170,15 +274,82 @@ private:
     NetworkService(const NetworkService&) = delete;
     NetworkService& operator=(const NetworkService&) = delete;
 
-    void handleAutoReconnect();
+    struct Listener {
+        NetworkEventCallback callback;
+        void* context;
+    };
+
+    /**
+     * @struct IPConfig
+     * @brief Static IP or remembered DHCP lease
+     */
+    struct IPConfig {
+        bool valid;
+        uint32_t ip;
+        uint32_t gateway;
+        uint32_t subnet;
+        uint32_t dns;
+    };
+
+    /**
+     * @struct ConnectionCache
+     * @brief Last good association, persisted in NVS
+     */
+    struct ConnectionCache {
+        bool valid;
+        String ssid;
+        uint8_t bssid[6];
+        uint8_t channel;
+        IPConfig lease;
+        uint32_t leaseObtainedAt;   // millis() when DHCP granted the lease
+        uint32_t leaseRenewMs;      // Lease renewal time (T1), capped
+    };
+
+    // Pending event bits, set from the Wi-Fi event task
+    static const uint32_t EVENT_GOT_IP = 0x01;
+    static const uint32_t EVENT_DISCONNECTED = 0x02;
+
+    static void onWiFiEvent(arduino_event_id_t event, arduino_event_info_t info);
+
+    void startAttempt();
+    void handleAttemptFailed(uint8_t reason);
+    void handleConnectionLost(uint8_t reason);
+    void scheduleRetry();
+    void publish(NetworkEvent event);
+
+    void loadConnectionCache();
+    void storeConnectionCache();
+    void applyIPConfig(const IPConfig& config);
+    bool isLeaseReusable() const;
 
     NetworkStatus m_status;
     String m_ssid;
     String m_password;
     bool m_autoReconnect;
-    uint32_t m_lastReconnectAttempt;
-    uint32_t m_reconnectInterval;
     bool m_initialized;
+
+    // Attempt state (main loop only)
+    uint32_t m_attemptTimeout;
+    uint32_t m_attemptStart;
+    uint32_t m_retryAt;
+    uint32_t m_retryDelay;
+    uint8_t m_failedAttempts;
+    bool m_fastAttempt;
+    bool m_leaseReused;         // Address is a reapplied lease; DHCP is off until T1
+
+    // Fast reconnect
+    ConnectionCache m_cache;
+    IPConfig m_staticIP;
+    uint32_t m_bootToOnlineMs;
+    bool m_bootFastPath;
+    LatencyHistogram m_fastConnects;
+    LatencyHistogram m_fullConnects;
+
+    // Event hand-off from the Wi-Fi task (guarded by a spinlock in the .cpp)
+    volatile uint32_t m_pendingEvents;
+    volatile uint8_t m_disconnectReason;
+
+    Listener m_listeners[NETWORK_MAX_LISTENERS];
 };
 
 #endif // NETWORK_SERVICE_H
@@ -0,0 +1,137 @@
+/**
+ * @file PollingPolicy.h
+ * @brief Adaptive polling intervals - MVC Service Layer
+ *
+ * Each polled resource owns a PollSchedule with a base interval. The
+ * schedule stretches or shrinks that interval based on how often polls
+ * actually return changes, and PollingPolicy scales it by the device
+ * context: whether the consuming page is on screen, whether the screen is
+ * on at all (lock screen / backlight off) and the battery level. Callers
+ * can also hint a known future change (e.g. the end of the current track).
+ * Part of MVC architecture - Service layer.
+ */
+
+#ifndef POLLING_POLICY_H
+#define POLLING_POLICY_H
+
+#include <Arduino.h>
+#include "config/Config.h"
+
+/**
+ * @class PollingPolicy
+ * @brief Singleton snapshot of the device context used to scale poll intervals
+ */
+class PollingPolicy {
+public:
+    /**
+     * @brief Get singleton instance
+     */
+    static PollingPolicy& getInstance();
+
+    /**
+     * @brief Refresh route, screen and battery state (call periodically)
+     */
+    void update();
+
+    /**
+     * @brief Check if a page is currently shown
+     * @param routePath Route path of the page (e.g. "/app/slack")
+     */
+    bool isVisible(const char* routePath) const;
+
+    /**
+     * @brief Check if the user can see anything (backlight on, not locked)
+     */
+    bool isScreenOn() const { return m_screenOn; }
+
+    /**
+     * @brief Get the context multiplier for a consumer
+     * @param routePath Route path of the consuming page
+     * @return Factor applied to the poll interval (1.0 = visible, on mains)
+     */
+    float getScale(const char* routePath) const;
+
+private:
+    PollingPolicy();
+    ~PollingPolicy() = default;
+    PollingPolicy(const PollingPolicy&) = delete;
+    PollingPolicy& operator=(const PollingPolicy&) = delete;
+
+    String m_currentRoute;
+    bool m_screenOn;
+    float m_batteryScale;
+    uint32_t m_lastUpdate;
+};
+
+/**
+ * @class PollSchedule
+ * @brief Next-poll bookkeeping for one polled resource
+ */
+class PollSchedule {
+public:
+    /**
+     * @brief Constructor
+     * @param routePath Page that displays this data
+     * @param baseIntervalMs Interval while visible with a normal change rate
+     * @param minIntervalMs Lower bound
+     * @param maxIntervalMs Upper bound
+     */
+    PollSchedule(const char* routePath, uint32_t baseIntervalMs,
+                 uint32_t minIntervalMs, uint32_t maxIntervalMs);
+
+    /**
+     * @brief Check if a poll is due now
+     */
+    bool isDue() const;
+
+    /**
+     * @brief Mark a poll as started (resets the interval timer, clears any hint)
+     */
+    void start();
+
+    /**
+     * @brief Record the outcome of a poll
+     * @param changed true if the poll returned new data
+     */
+    void recordResult(bool changed);
+
+    /**
+     * @brief Request a poll at a known future point (earlier of this and the normal schedule)
+     * @param delayMs Time from now
+     */
+    void pollAt(uint32_t delayMs);
+
+    /**
+     * @brief Make the next isDue() return true
+     */
+    void pollNow();
+
+    /**
+     * @brief Change the base interval
+     */
+    void setBaseInterval(uint32_t intervalMs) { m_baseInterval = intervalMs; }
+
+    /**
+     * @brief Get the effective interval under the current context
+     */
+    uint32_t getInterval() const;
+
+    /**
+     * @brief Get the request priority class this poll should use
+     * @return true if its page is visible (refresh), false for background
+     */
+    bool isVisible() const;
+
+private:
+    const char* m_routePath;
+    uint32_t m_baseInterval;
+    uint32_t m_minInterval;
+    uint32_t m_maxInterval;
+    uint32_t m_lastStart;
+    uint32_t m_hintAt;
+    bool m_hasHint;
+    bool m_started;
+    float m_changeRate;     // Moving average of polls that returned changes (0..1)
+};
+
+#endif // POLLING_POLICY_H
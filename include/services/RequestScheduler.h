@@ -0,0 +1,156 @@
+/**
+ * @file RequestScheduler.h
+ * @brief Priority scheduler for outbound API requests - MVC Service Layer
+ *
+ * App controllers submit their requests here instead of issuing them
+ * inline from update(). Each main-loop frame the scheduler runs every
+ * queued interactive request (user commands) and, only if none were
+ * waiting, a single refresh or background poll. A tap therefore waits for
+ * at most the one poll already on the wire, never for a chain of them.
+ * Polls that were not started before their deadline are dropped as stale.
+ * Part of MVC architecture - Service layer.
+ */
+
+#ifndef REQUEST_SCHEDULER_H
+#define REQUEST_SCHEDULER_H
+
+#include <Arduino.h>
+#include "config/Config.h"
+#include "utils/LatencyHistogram.h"
+
+/**
+ * @enum RequestPriority
+ * @brief Request classes, highest priority first
+ */
+enum class RequestPriority {
+    INTERACTIVE,    // User-initiated command (play/pause, toggle light)
+    VISIBLE,        // Refresh of data currently on screen
+    BACKGROUND      // Poll for data not on screen
+};
+
+static const int REQUEST_PRIORITY_COUNT = 3;
+
+/**
+ * @brief Performs one scheduled request
+ * @param context User context pointer
+ * @return true if the request succeeded
+ */
+typedef bool (*ScheduledRequestFunction)(void* context);
+
+/**
+ * @struct RequestClassStats
+ * @brief Per-class scheduler metrics
+ */
+struct RequestClassStats {
+    uint32_t submitted;     // Jobs accepted
+    uint32_t coalesced;     // Submissions merged into an already queued job
+    uint32_t executed;      // Jobs run
+    uint32_t failed;        // Jobs whose function returned false
+    uint32_t expired;       // Jobs dropped after their deadline
+    uint32_t rejected;      // Submissions refused (queue full)
+};
+
+/**
+ * @class RequestScheduler
+ * @brief Singleton cooperative request scheduler
+ *
+ * Features:
+ * - Three priority classes with strict ordering (FIFO within a class)
+ * - Interactive requests jump ahead of any queued poll
+ * - Keyed jobs: resubmitting a queued key merges instead of duplicating
+ * - Deadlines: stale polls are cancelled before they hit the network
+ * - Queue-wait histogram per class
+ */
+class RequestScheduler {
+public:
+    /**
+     * @brief Get singleton instance
+     */
+    static RequestScheduler& getInstance();
+
+    /**
+     * @brief Queue a request
+     * @param priority Request class
+     * @param function Function that performs the request
+     * @param context Passed to function
+     * @param key Job identity (string literal); a queued job with the same key
+     *            is updated instead of queueing a duplicate. nullptr for none.
+     * @param deadlineMs Drop the job if it hasn't started within this time (0 = never)
+     * @return true if queued (or merged)
+     */
+    bool submit(RequestPriority priority, ScheduledRequestFunction function, void* context,
+                const char* key = nullptr, uint32_t deadlineMs = 0);
+
+    /**
+     * @brief Remove a queued job
+     * @param key Job key
+     * @return true if a job was removed
+     */
+    bool cancel(const char* key);
+
+    /**
+     * @brief Check if a job is queued
+     * @param key Job key
+     */
+    bool isQueued(const char* key) const;
+
+    /**
+     * @brief Run due jobs (call once per frame, after the controllers)
+     */
+    void update();
+
+    /**
+     * @brief Get number of queued jobs
+     * @param priority Request class
+     */
+    uint8_t getQueuedCount(RequestPriority priority) const;
+
+    /**
+     * @brief Get class metrics
+     */
+    const RequestClassStats& getStats(RequestPriority priority) const {
+        return m_stats[(int)priority];
+    }
+
+    /**
+     * @brief Get queue-wait histogram (submit to start) of a class
+     */
+    const LatencyHistogram& getQueueWaitHistogram(RequestPriority priority) const {
+        return m_queueWait[(int)priority];
+    }
+
+    /**
+     * @brief Get class name for logging
+     */
+    static const char* getPriorityName(RequestPriority priority);
+
+private:
+    RequestScheduler();
+    ~RequestScheduler() = default;
+    RequestScheduler(const RequestScheduler&) = delete;
+    RequestScheduler& operator=(const RequestScheduler&) = delete;
+
+    struct Job {
+        bool used;
+        RequestPriority priority;
+        ScheduledRequestFunction function;
+        void* context;
+        const char* key;
+        uint32_t sequence;      // Submission order, for FIFO within a class
+        uint32_t enqueuedAt;
+        uint32_t deadline;      // Absolute millis, 0 = none
+    };
+
+    Job* findJob(const char* key);
+    Job* nextJob(bool interactiveOnly);
+    Job* allocateJob(RequestPriority priority);
+    void expireJobs();
+    void run(Job* job);
+
+    Job m_jobs[REQUEST_QUEUE_SIZE];
+    uint32_t m_sequence;
+    RequestClassStats m_stats[REQUEST_PRIORITY_COUNT];
+    LatencyHistogram m_queueWait[REQUEST_PRIORITY_COUNT];
+};
+
+#endif // REQUEST_SCHEDULER_H
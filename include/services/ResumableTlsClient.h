@@ -0,0 +1,51 @@
+/**
+ * @file ResumableTlsClient.h
+ * @brief WiFiClientSecure with TLS session resumption - MVC Service Layer
+ *
+ * WiFiClientSecure performs TLS setup and handshake in one call, leaving no
+ * hook to offer a previous session. This client runs the same connect
+ * sequence itself so it can offer the session cached in TlsSessionCache and
+ * complete an abbreviated handshake when the server accepts it.
+ * Part of MVC architecture - Service layer.
+ */
+
+#ifndef RESUMABLE_TLS_CLIENT_H
+#define RESUMABLE_TLS_CLIENT_H
+
+#include <Arduino.h>
+#include <WiFiClientSecure.h>
+
+/**
+ * @class ResumableTlsClient
+ * @brief TLS client that resumes cached sessions
+ *
+ * Drop-in replacement for WiFiClientSecure (read/write/stop unchanged).
+ * Certificate verification is disabled, matching WiFiClientSecure::setInsecure():
+ * connections are encrypted but servers are not authenticated.
+ */
+class ResumableTlsClient : public WiFiClientSecure {
+public:
+    ResumableTlsClient();
+
+    // WiFiClientSecure connect overrides (HTTPClient uses the timeout variant)
+    int connect(const char* host, uint16_t port) override;
+    int connect(const char* host, uint16_t port, int32_t timeout) override;
+
+    /**
+     * @brief Check if the last handshake resumed a cached session
+     */
+    bool wasResumed() const { return m_resumed; }
+
+    /**
+     * @brief Get duration of the last handshake (TCP connect + TLS) in ms
+     */
+    uint32_t getLastHandshakeMs() const { return m_lastHandshakeMs; }
+
+private:
+    int startSession(const IPAddress& ip, uint16_t port, const char* host, int32_t timeout);
+
+    bool m_resumed;
+    uint32_t m_lastHandshakeMs;
+};
+
+#endif // RESUMABLE_TLS_CLIENT_H
@@ -0,0 +1,120 @@
+/**
+ * @file TlsSessionCache.h
+ * @brief TLS session cache for abbreviated handshakes - MVC Service Layer
+ *
+ * Keeps the last TLS session (session ID / session ticket) negotiated with
+ * each host so reconnects can resume instead of repeating the full key
+ * exchange. Sessions are held in RAM and can optionally be persisted,
+ * encrypted, to the SD card so they survive a reboot.
+ * Part of MVC architecture - Service layer.
+ */
+
+#ifndef TLS_SESSION_CACHE_H
+#define TLS_SESSION_CACHE_H
+
+#include <Arduino.h>
+#include "mbedtls/ssl.h"
+#include "config/Config.h"
+
+/**
+ * @class TlsSessionCache
+ * @brief Singleton per-host TLS session store
+ *
+ * Features:
+ * - One cached session per host:port (LRU replacement)
+ * - Sessions stored serialized (no mbedtls heap pointers held)
+ * - Time-to-live expiry
+ * - Optional AES-256 encrypted persistence to SD (key bound to the device)
+ */
+class TlsSessionCache {
+public:
+    /**
+     * @brief Get singleton instance
+     */
+    static TlsSessionCache& getInstance();
+
+    /**
+     * @brief Initialize cache (loads persisted sessions when enabled)
+     * @return true if successful
+     */
+    bool init();
+
+    /**
+     * @brief Load cached session for a host
+     * @param host Server host name
+     * @param port Server port
+     * @param session Output session (must be initialized with mbedtls_ssl_session_init)
+     * @return true if a valid session was found
+     */
+    bool load(const char* host, uint16_t port, mbedtls_ssl_session* session);
+
+    /**
+     * @brief Store session negotiated with a host
+     * @param host Server host name
+     * @param port Server port
+     * @param session Session from mbedtls_ssl_get_session
+     */
+    void store(const char* host, uint16_t port, const mbedtls_ssl_session* session);
+
+    /**
+     * @brief Drop cached session for a host
+     * @param host Server host name
+     * @param port Server port
+     */
+    void invalidate(const char* host, uint16_t port);
+
+    /**
+     * @brief Drop all cached sessions
+     */
+    void clear();
+
+    /**
+     * @brief Enable/disable encrypted persistence to SD
+     * @param enable true to persist
+     */
+    void setPersistent(bool enable) { m_persistent = enable; }
+
+    /**
+     * @brief Check if persistence is enabled
+     */
+    bool isPersistent() const { return m_persistent; }
+
+    /**
+     * @brief Write sessions to SD if anything changed (call periodically)
+     */
+    void update();
+
+private:
+    TlsSessionCache();
+    ~TlsSessionCache();
+    TlsSessionCache(const TlsSessionCache&) = delete;
+    TlsSessionCache& operator=(const TlsSessionCache&) = delete;
+
+    /**
+     * @struct Entry
+     * @brief Serialized session for one host:port
+     */
+    struct Entry {
+        String host;
+        uint16_t port;
+        uint8_t* data;
+        size_t length;
+        uint32_t storedAt;
+    };
+
+    Entry* findEntry(const char* host, uint16_t port);
+    void freeEntry(Entry& entry);
+    bool persist();
+    bool restore();
+    bool deriveStorageKey(uint8_t* key);
+
+    Entry m_entries[TLS_SESSION_CACHE_SIZE];
+    bool m_persistent;
+    bool m_dirty;
+    uint32_t m_lastPersist;
+    uint8_t m_storageKey[32];  // Derived from the NVS device secret, once per boot
+    bool m_keyReady;
+    bool m_initialized;
+};
+
+#endif // TLS_SESSION_CACHE_H
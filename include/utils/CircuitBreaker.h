@@ -0,0 +1,113 @@
+/**
+ * @file CircuitBreaker.h
+ * @brief Circuit breaker with exponential backoff for a remote service
+ *
+ * After a run of failures the breaker opens and requests are refused
+ * locally until a backoff delay has passed. Then a single probe request is
+ * let through (half-open): success closes the breaker, failure reopens it
+ * with a longer delay. Servers can also open it directly for an explicit
+ * period (Retry-After, rate limits).
+ * Part of MVC architecture - Utility layer.
+ */
+
+#ifndef CIRCUIT_BREAKER_H
+#define CIRCUIT_BREAKER_H
+
+#include <Arduino.h>
+#include "config/Config.h"
+
+/**
+ * @enum CircuitState
+ * @brief Breaker state
+ */
+enum class CircuitState {
+    CLOSED,     // Healthy, requests pass
+    OPEN,       // Failing, requests refused until the retry time
+    HALF_OPEN   // One probe request in flight
+};
+
+/**
+ * @class CircuitBreaker
+ * @brief Closed / open / half-open breaker with jittered backoff
+ */
+class CircuitBreaker {
+public:
+    CircuitBreaker();
+
+    /**
+     * @brief Check if a request may be sent now
+     *
+     * An open breaker whose delay has passed moves to half-open and admits
+     * exactly one probe.
+     * @return true if the request may go out
+     */
+    bool allowRequest();
+
+    /**
+     * @brief Record a successful request (closes the breaker)
+     */
+    void recordSuccess();
+
+    /**
+     * @brief Record a failed request (may open the breaker)
+     */
+    void recordFailure();
+
+    /**
+     * @brief Open now with the next backoff step (application-level failure)
+     */
+    void trip();
+
+    /**
+     * @brief Open the breaker for a server-specified period
+     * @param delayMs Time to refuse requests (e.g. Retry-After)
+     */
+    void openFor(uint32_t delayMs);
+
+    /**
+     * @brief Hand back an admitted probe that was never sent
+     *
+     * A half-open breaker returns to open with the probe due at once;
+     * otherwise nothing changes.
+     */
+    void cancelProbe();
+
+    /**
+     * @brief Reset to closed and forget the failure history
+     */
+    void reset();
+
+    /**
+     * @brief Get state (an expired open breaker still reports OPEN until probed)
+     */
+    CircuitState getState() const { return m_state; }
+
+    /**
+     * @brief Get time until the next probe is allowed
+     * @return Milliseconds, 0 if requests may go out now
+     */
+    uint32_t getRetryDelay() const;
+
+    /**
+     * @brief Get consecutive failure count
+     */
+    uint8_t getFailureCount() const { return m_failures; }
+
+    /**
+     * @brief Get number of requests refused while open
+     */
+    uint32_t getRejectedCount() const { return m_rejected; }
+
+private:
+    void open(uint32_t delayMs);
+    uint32_t nextBackoff();
+
+    CircuitState m_state;
+    uint8_t m_failures;
+    uint32_t m_backoff;
+    uint32_t m_closedAt;
+    uint32_t m_retryAt;
+    uint32_t m_rejected;
+};
+
+#endif // CIRCUIT_BREAKER_H
@@ -0,0 +1,100 @@
+/**
+ * @file CommandCoalescer.h
+ * @brief Latest-wins coalescing for continuous control commands
+ *
+ * Sliders produce a new value every touch frame. Sending each one as its
+ * own API request floods the server and stalls the UI, so a coalescer sits
+ * between the control and the request: it keeps only the most recent value,
+ * sends at most one request per interval, and always delivers the final
+ * value when the gesture ends.
+ * Part of MVC architecture - Utility layer.
+ */
+
+#ifndef COMMAND_COALESCER_H
+#define COMMAND_COALESCER_H
+
+#include <Arduino.h>
+#include "config/Config.h"
+
+/**
+ * @brief Sends one coalesced value
+ * @param value Latest submitted value
+ * @param context User context pointer
+ * @return true if the command was accepted
+ */
+typedef bool (*CoalescedSendFunction)(float value, void* context);
+
+/**
+ * @class CommandCoalescer
+ * @brief Rate-limited, latest-wins command sender for one target
+ */
+class CommandCoalescer {
+public:
+    /**
+     * @brief Constructor
+     * @param minIntervalMs Minimum time between two sends
+     */
+    explicit CommandCoalescer(uint32_t minIntervalMs = COMMAND_COALESCE_INTERVAL_MS);
+
+    /**
+     * @brief Set send function
+     * @param send Function that issues the actual request
+     * @param context Passed to send
+     */
+    void setTarget(CoalescedSendFunction send, void* context);
+
+    /**
+     * @brief Submit a new value (replaces any pending one)
+     * @param value Value to send
+     */
+    void submit(float value);
+
+    /**
+     * @brief Send the pending value if the interval has elapsed (call periodically)
+     */
+    void update();
+
+    /**
+     * @brief Send the pending value now, ignoring the interval (e.g. on release)
+     */
+    void flush();
+
+    /**
+     * @brief Drop the pending value without sending it
+     */
+    void cancel();
+
+    /**
+     * @brief Check if a value is waiting to be sent
+     */
+    bool hasPending() const { return m_hasPending; }
+
+    /**
+     * @brief Get number of values submitted
+     */
+    uint32_t getSubmittedCount() const { return m_submitted; }
+
+    /**
+     * @brief Get number of requests actually sent
+     */
+    uint32_t getSentCount() const { return m_sent; }
+
+private:
+    void send();
+
+    CoalescedSendFunction m_send;
+    void* m_context;
+    uint32_t m_minInterval;
+
+    float m_pendingValue;
+    bool m_hasPending;
+    float m_lastSentValue;
+    bool m_hasLastSent;
+    bool m_inFlight;
+    uint32_t m_lastSendTime;
+
+    uint32_t m_submitted;
+    uint32_t m_sent;
+};
+
+#endif // COMMAND_COALESCER_H
@@ -0,0 +1,150 @@
+/**
+ * @file FingerprintSet.h
+ * @brief Bounded set of 32-bit fingerprints with oldest-first eviction
+ *
+ * Remembers the last N keys (as 32-bit hashes) for duplicate suppression,
+ * e.g. message timestamps that may arrive both from a poll and a push event.
+ * Lookups use an open-addressing table at 50% load; once full, inserting a
+ * new key forgets the oldest one. Memory is 12 bytes per entry and nothing
+ * is heap-allocated.
+ * Part of MVC architecture - Utility layer.
+ */
+
+#ifndef FINGERPRINT_SET_H
+#define FINGERPRINT_SET_H
+
+#include <Arduino.h>
+
+/**
+ * @class FingerprintSet
+ * @brief Fixed-capacity set of recent fingerprints
+ * @tparam Capacity Number of fingerprints remembered (power of two)
+ *
+ * A fingerprint collision makes a new key look like a duplicate; at the
+ * sizes used here (hundreds of keys) that is about 1 in 10^7 per insert.
+ */
+template <uint16_t Capacity>
+class FingerprintSet {
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+    FingerprintSet() {
+        clear();
+    }
+
+    /**
+     * @brief Hash a key into a fingerprint (FNV-1a)
+     * @param data Key bytes
+     * @param length Number of bytes
+     * @param seed Previous hash, to fingerprint composite keys
+     */
+    static uint32_t hash(const char* data, size_t length, uint32_t seed = 2166136261u) {
+        uint32_t h = seed;
+        for (size_t i = 0; i < length; i++) {
+            h ^= (uint8_t)data[i];
+            h *= 16777619u;
+        }
+        return h;
+    }
+
+    /**
+     * @brief Check if a fingerprint is in the set
+     */
+    bool contains(uint32_t fingerprint) const {
+        return findSlot(normalize(fingerprint)) >= 0;
+    }
+
+    /**
+     * @brief Add a fingerprint, evicting the oldest if full
+     * @return false if it was already present
+     */
+    bool insert(uint32_t fingerprint) {
+        fingerprint = normalize(fingerprint);
+        if (findSlot(fingerprint) >= 0) {
+            return false;
+        }
+
+        if (m_count == Capacity) {
+            erase(m_order[m_next]);
+            m_count--;
+        }
+
+        m_order[m_next] = fingerprint;
+        m_next = (m_next + 1) & (Capacity - 1);
+        m_count++;
+
+        uint16_t slot = fingerprint & (TABLE_SIZE - 1);
+        while (m_table[slot] != 0) {
+            slot = (slot + 1) & (TABLE_SIZE - 1);
+        }
+        m_table[slot] = fingerprint;
+        return true;
+    }
+
+    /**
+     * @brief Forget everything
+     */
+    void clear() {
+        memset(m_table, 0, sizeof(m_table));
+        m_next = 0;
+        m_count = 0;
+    }
+
+    /**
+     * @brief Get number of fingerprints held
+     */
+    uint16_t size() const { return m_count; }
+
+private:
+    static constexpr uint16_t TABLE_SIZE = Capacity * 2;
+
+    // 0 marks an empty slot
+    static uint32_t normalize(uint32_t fingerprint) {
+        return fingerprint != 0 ? fingerprint : 1;
+    }
+
+    int findSlot(uint32_t fingerprint) const {
+        uint16_t slot = fingerprint & (TABLE_SIZE - 1);
+        while (m_table[slot] != 0) {
+            if (m_table[slot] == fingerprint) {
+                return slot;
+            }
+            slot = (slot + 1) & (TABLE_SIZE - 1);
+        }
+        return -1;
+    }
+
+    void erase(uint32_t fingerprint) {
+        int found = findSlot(fingerprint);
+        if (found < 0) {
+            return;
+        }
+
+        // Backward-shift deletion keeps probe chains intact without tombstones
+        uint16_t hole = (uint16_t)found;
+        uint16_t slot = hole;
+        while (true) {
+            slot = (slot + 1) & (TABLE_SIZE - 1);
+            uint32_t entry = m_table[slot];
+            if (entry == 0) {
+                break;
+            }
+
+            uint16_t home = entry & (TABLE_SIZE - 1);
+            bool movable = (slot > hole) ? (home <= hole || home > slot)
+                                         : (home <= hole && home > slot);
+            if (movable) {
+                m_table[hole] = entry;
+                hole = slot;
+            }
+        }
+        m_table[hole] = 0;
+    }
+
+    uint32_t m_table[TABLE_SIZE];
+    uint32_t m_order[Capacity];     // Insertion ring, oldest at m_next once full
+    uint16_t m_next;
+    uint16_t m_count;
+};
+
+#endif // FINGERPRINT_SET_H
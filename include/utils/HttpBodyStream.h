@@ -0,0 +1,76 @@
+/**
+ * @file HttpBodyStream.h
+ * @brief Stream adapter for an HTTP response body
+ *
+ * Presents the body of an HTTP response as a plain Stream, hiding
+ * Content-Length framing and chunked transfer decoding, so parsers can
+ * read straight from the socket without buffering the whole response.
+ * Part of MVC architecture - Utility layer.
+ */
+
+#ifndef HTTP_BODY_STREAM_H
+#define HTTP_BODY_STREAM_H
+
+#include <Arduino.h>
+#include <Client.h>
+
+/**
+ * @class HttpBodyStream
+ * @brief Read-only Stream over an HTTP response body
+ *
+ * Reads block (up to the stream timeout) waiting for data, like
+ * Stream::timedRead, and return -1 at end of body or as soon as the
+ * peer has closed the connection and nothing is left to read.
+ */
+class HttpBodyStream : public Stream {
+public:
+    /**
+     * @brief Constructor
+     * @param source Connection positioned at the start of the body
+     * @param contentLength Body length, or -1 if unknown
+     * @param chunked true if Transfer-Encoding is chunked
+     */
+    HttpBodyStream(Client& source, int contentLength, bool chunked);
+
+    // Stream interface
+    int available() override;
+    int read() override;
+    int peek() override;
+    size_t readBytes(char* buffer, size_t length) override;
+    size_t write(uint8_t) override { return 0; }
+    void flush() override {}
+
+    /**
+     * @brief Check if the whole body has been consumed
+     * @return true if the connection is positioned after the body
+     */
+    bool isComplete() const { return m_complete; }
+
+    /**
+     * @brief Get number of body bytes read so far
+     */
+    size_t getBytesRead() const { return m_bytesRead; }
+
+    /**
+     * @brief Discard the rest of the body (so the connection can be reused)
+     * @param maxBytes Give up after this many bytes
+     * @return true if the body was fully consumed
+     */
+    bool drain(size_t maxBytes);
+
+private:
+    bool ensureData();
+    bool readChunkHeader();
+    int sourceRead();
+    bool sourceReadLine(char* buffer, size_t length);
+
+    Client& m_source;
+    int m_contentLength;
+    bool m_chunked;
+    size_t m_chunkRemaining;   // Bytes left in the current chunk (or body when not chunked)
+    size_t m_bytesRead;
+    bool m_complete;
+    int m_peeked;
+};
+
+#endif // HTTP_BODY_STREAM_H
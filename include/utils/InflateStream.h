@@ -0,0 +1,109 @@
+/**
+ * @file InflateStream.h
+ * @brief Streaming gzip / deflate decoder
+ *
+ * Decompresses a Content-Encoding: gzip or deflate response body on the fly
+ * using the miniz inflater in the ESP32 ROM. Output is produced into the
+ * sliding dictionary window and handed out byte by byte, so the parser on
+ * top only ever sees a plain Stream and the decompressed body is never held
+ * in memory as a whole.
+ * Part of MVC architecture - Utility layer.
+ */
+
+#ifndef INFLATE_STREAM_H
+#define INFLATE_STREAM_H
+
+#include <Arduino.h>
+#include "rom/miniz.h"
+
+/**
+ * @enum InflateFormat
+ * @brief Framing around the deflate data
+ */
+enum class InflateFormat {
+    GZIP,       // RFC 1952 header and trailer
+    DEFLATE     // RFC 1950 zlib wrapper, or raw RFC 1951 data from non-conforming servers
+};
+
+/**
+ * @class InflateStream
+ * @brief Read-only Stream that inflates another Stream
+ *
+ * The decoder state and the 32 KB window are allocated once (in PSRAM when
+ * available) and reused for every response, so an instance is normally
+ * long-lived and re-armed with begin().
+ */
+class InflateStream : public Stream {
+public:
+    InflateStream();
+    ~InflateStream();
+    InflateStream(const InflateStream&) = delete;
+    InflateStream& operator=(const InflateStream&) = delete;
+
+    /**
+     * @brief Allocate decoder state and window
+     * @return true if the buffers are available
+     */
+    bool allocate();
+
+    /**
+     * @brief Check if allocate() succeeded
+     */
+    bool isAllocated() const { return m_decompressor != nullptr; }
+
+    /**
+     * @brief Start decoding a new body
+     * @param source Compressed body
+     * @param format Content encoding of the body
+     * @return false if the header is invalid or buffers are missing
+     */
+    bool begin(Stream& source, InflateFormat format);
+
+    /**
+     * @brief Parse a Content-Encoding header value
+     * @param encoding Header value
+     * @param format Set to the matching format
+     * @return true if the encoding is one we can decode
+     */
+    static bool parseEncoding(const String& encoding, InflateFormat& format);
+
+    // Stream interface
+    int available() override;
+    int read() override;
+    int peek() override;
+    size_t readBytes(char* buffer, size_t length) override;
+    size_t write(uint8_t) override { return 0; }
+    void flush() override {}
+
+    /**
+     * @brief Check if the decoder hit corrupt or truncated data
+     */
+    bool hasError() const { return m_error; }
+
+    /**
+     * @brief Get number of decompressed bytes produced so far
+     */
+    size_t getBytesOut() const { return m_bytesOut; }
+
+private:
+    bool skipGzipHeader();
+    bool fill();
+    int sourceRead();
+
+    Stream* m_source;
+    tinfl_decompressor* m_decompressor;
+    uint8_t* m_window;          // TINFL_LZ_DICT_SIZE bytes, written circularly
+    uint8_t* m_input;           // INFLATE_INPUT_BUFFER_SIZE bytes
+    size_t m_inputPos;
+    size_t m_inputLen;
+    size_t m_windowPos;         // Next write position in m_window
+    size_t m_outputPos;         // Next unread decompressed byte in m_window
+    size_t m_outputAvailable;
+    uint32_t m_flags;
+    bool m_sourceEnded;
+    bool m_done;
+    bool m_error;
+    size_t m_bytesOut;
+};
+
+#endif // INFLATE_STREAM_H
@@ -0,0 +1,52 @@
+/**
+ * @file JsonStreamReader.h
+ * @brief Incremental JSON array reader for streamed HTTP bodies
+ *
+ * Walks a JSON array one element at a time, deserializing each element
+ * through a filter document into a small reusable JsonDocument, so peak
+ * memory depends on the size of one (filtered) element rather than the
+ * whole response.
+ * Part of MVC architecture - Utility layer.
+ */
+
+#ifndef JSON_STREAM_READER_H
+#define JSON_STREAM_READER_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+
+/**
+ * @class JsonStreamReader
+ * @brief Static helpers for streaming JSON ingestion
+ */
+class JsonStreamReader {
+public:
+    /**
+     * @brief Called for every array element
+     * @param element Filtered element
+     * @param context User context pointer
+     * @return false to stop reading
+     */
+    typedef bool (*ElementCallback)(JsonObject element, void* context);
+
+    /**
+     * @brief Stream every element of a JSON array through a filter
+     *
+     * @param input Source stream
+     * @param arrayKey Key of the array in the top-level object, or nullptr
+     *                 if the document itself is an array
+     * @param filter Filter applied to each element (see DeserializationOption::Filter)
+     * @param elementCapacity Capacity of the per-element document
+     * @param callback Element callback
+     * @param context Passed to callback
+     * @return Number of elements delivered, or -1 on parse error / missing array
+     */
+    static int forEachArrayElement(Stream& input, const char* arrayKey, const JsonDocument& filter,
+                                   size_t elementCapacity, ElementCallback callback, void* context);
+
+private:
+    static bool skipWhitespace(Stream& input);
+    static bool findArrayStart(Stream& input, const char* arrayKey);
+};
+
+#endif // JSON_STREAM_READER_H
@@ -0,0 +1,68 @@
+/**
+ * @file LatencyHistogram.h
+ * @brief Fixed-bucket latency histogram
+ *
+ * Lightweight histogram for timing metrics (handshakes, queue waits, etc.).
+ * Part of MVC architecture - Utility layer.
+ */
+
+#ifndef LATENCY_HISTOGRAM_H
+#define LATENCY_HISTOGRAM_H
+
+#include <Arduino.h>
+
+/**
+ * @class LatencyHistogram
+ * @brief Millisecond latency histogram with fixed bucket bounds
+ *
+ * Buckets (upper bounds, ms): 50, 100, 250, 500, 1000, 2000, +inf
+ */
+class LatencyHistogram {
+public:
+    static const int BUCKET_COUNT = 7;
+
+    LatencyHistogram();
+
+    /**
+     * @brief Record a sample
+     * @param ms Latency in milliseconds
+     */
+    void record(uint32_t ms);
+
+    /**
+     * @brief Reset all samples
+     */
+    void reset();
+
+    uint32_t getCount() const { return m_count; }
+    uint32_t getMax() const { return m_max; }
+    uint32_t getAverage() const { return m_count > 0 ? (uint32_t)(m_sum / m_count) : 0; }
+    uint32_t getBucket(int index) const { return (index >= 0 && index < BUCKET_COUNT) ? m_buckets[index] : 0; }
+
+    /**
+     * @brief Get upper bound of a bucket
+     * @param index Bucket index
+     * @return Upper bound in ms (UINT32_MAX for the last bucket)
+     */
+    static uint32_t getBucketBound(int index);
+
+    /**
+     * @brief Estimate a percentile from the buckets
+     * @param percent Percentile (0-100)
+     * @return Upper bound of the bucket containing the percentile
+     */
+    uint32_t getPercentile(uint8_t percent) const;
+
+    /**
+     * @brief Format as a single log line (e.g. "n=12 avg=140 max=820 [..]")
+     */
+    String toString() const;
+
+private:
+    uint32_t m_buckets[BUCKET_COUNT];
+    uint32_t m_count;
+    uint64_t m_sum;
+    uint32_t m_max;
+};
+
+#endif // LATENCY_HISTOGRAM_H
@@ -0,0 +1,194 @@
+/**
+ * @file RingBuffer.h
+ * @brief Fixed-capacity ring buffer with stable handles
+ *
+ * Keeps the newest N items; pushing into a full buffer overwrites the
+ * oldest slot in place, so nothing is shifted and slot objects (and the
+ * heap buffers their String members own) are reused. Every push is given a
+ * sequence-number handle that stays valid until that item is evicted or
+ * the buffer is cleared, and can be resolved back to the item in O(1).
+ * Part of MVC architecture - Utility layer.
+ */
+
+#ifndef RING_BUFFER_H
+#define RING_BUFFER_H
+
+#include <Arduino.h>
+#include <new>
+#include <utility>
+#include <esp_heap_caps.h>
+
+/**
+ * @class RingBuffer
+ * @brief Newest-first ring of T with O(1) push, eviction and handle lookup
+ * @tparam T Element type (default-constructible, assignable)
+ *
+ * Storage is allocated once by allocate(), in PSRAM when available.
+ * Index 0 is always the newest item.
+ */
+template <typename T>
+class RingBuffer {
+public:
+    typedef uint32_t Handle;
+    static constexpr Handle INVALID_HANDLE = 0;
+
+    RingBuffer()
+        : m_items(nullptr)
+        , m_capacity(0)
+        , m_count(0)
+        , m_nextHandle(1) {}
+
+    ~RingBuffer() {
+        release();
+    }
+
+    RingBuffer(const RingBuffer&) = delete;
+    RingBuffer& operator=(const RingBuffer&) = delete;
+
+    /**
+     * @brief Allocate storage for a number of items
+     * @param capacity Items kept before the oldest is overwritten
+     * @return false if out of memory (the buffer then stays unusable)
+     */
+    bool allocate(uint16_t capacity) {
+        release();
+        if (capacity == 0) {
+            return false;
+        }
+
+        size_t bytes = sizeof(T) * capacity;
+        void* storage = heap_caps_malloc(bytes, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+        if (!storage) {
+            storage = malloc(bytes);
+        }
+        if (!storage) {
+            return false;
+        }
+
+        m_items = static_cast<T*>(storage);
+        for (uint16_t i = 0; i < capacity; i++) {
+            new (&m_items[i]) T();
+        }
+        m_capacity = capacity;
+        return true;
+    }
+
+    /**
+     * @brief Add an item as the newest, overwriting the oldest if full
+     * @return Handle of the new item, INVALID_HANDLE if not allocated
+     */
+    Handle push(const T& item) {
+        T* slot = claim();
+        if (!slot) {
+            return INVALID_HANDLE;
+        }
+        *slot = item;
+        return m_nextHandle - 1;
+    }
+
+    Handle push(T&& item) {
+        T* slot = claim();
+        if (!slot) {
+            return INVALID_HANDLE;
+        }
+        *slot = std::move(item);
+        return m_nextHandle - 1;
+    }
+
+    /**
+     * @brief Resolve a handle
+     * @return Item, or nullptr if it has been evicted or cleared
+     */
+    T* get(Handle handle) {
+        return isValid(handle) ? &m_items[handle % m_capacity] : nullptr;
+    }
+
+    const T* get(Handle handle) const {
+        return isValid(handle) ? &m_items[handle % m_capacity] : nullptr;
+    }
+
+    /**
+     * @brief Access by age
+     * @param index 0 = newest, size() - 1 = oldest
+     */
+    T& at(uint16_t index) {
+        return m_items[handleAt(index) % m_capacity];
+    }
+
+    const T& at(uint16_t index) const {
+        return m_items[handleAt(index) % m_capacity];
+    }
+
+    /**
+     * @brief Get handle of the item at an age index
+     */
+    Handle handleAt(uint16_t index) const {
+        return index < m_count ? m_nextHandle - 1 - index : INVALID_HANDLE;
+    }
+
+    /**
+     * @brief Get the item the next push will evict
+     * @return Oldest item if full, otherwise nullptr
+     */
+    const T* evictionCandidate() const {
+        return isFull() ? &at(m_count - 1) : nullptr;
+    }
+
+    /**
+     * @brief Drop every item and invalidate all handles
+     *
+     * Slots are reset so the Strings they hold give their memory back.
+     */
+    void clear() {
+        for (uint16_t i = 0; i < m_capacity; i++) {
+            m_items[i] = T();
+        }
+        m_count = 0;
+    }
+
+    uint16_t size() const { return m_count; }
+    uint16_t capacity() const { return m_capacity; }
+    bool isEmpty() const { return m_count == 0; }
+    bool isFull() const { return m_capacity > 0 && m_count == m_capacity; }
+
+private:
+    bool isValid(Handle handle) const {
+        return handle != INVALID_HANDLE && handle < m_nextHandle && m_nextHandle - handle <= m_count;
+    }
+
+    T* claim() {
+        if (m_capacity == 0) {
+            return nullptr;
+        }
+        // Handles never wrap in practice (one per message); skip 0 if they do
+        if (m_nextHandle == INVALID_HANDLE) {
+            m_nextHandle = 1;
+            m_count = 0;
+        }
+        T* slot = &m_items[m_nextHandle % m_capacity];
+        m_nextHandle++;
+        if (m_count < m_capacity) {
+            m_count++;
+        }
+        return slot;
+    }
+
+    void release() {
+        if (m_items) {
+            for (uint16_t i = 0; i < m_capacity; i++) {
+                m_items[i].~T();
+            }
+            free(m_items);
+        }
+        m_items = nullptr;
+        m_capacity = 0;
+        m_count = 0;
+    }
+
+    T* m_items;
+    uint16_t m_capacity;
+    uint16_t m_count;
+    Handle m_nextHandle;    // Handle of the next push; item h lives in slot h % capacity
+};
+
+#endif // RING_BUFFER_H
@@ -0,0 +1,116 @@
+/**
+ * @file StringPool.h
+ * @brief Reference-counted string interning with 16-bit ids
+ *
+ * Stores each distinct string once in a single character arena and hands
+ * out 16-bit ids, so records that hold many (often repeated) strings can
+ * keep two bytes per field instead of a heap-allocated String. Ids are
+ * reference counted; released strings leave garbage in the arena that is
+ * compacted away when space runs out. Compaction moves characters but
+ * never changes ids. Each string costs its characters plus a terminator,
+ * an 8-byte entry and a share of the hash buckets.
+ * Part of MVC architecture - Utility layer.
+ */
+
+#ifndef STRING_POOL_H
+#define STRING_POOL_H
+
+#include <Arduino.h>
+
+/**
+ * @class StringPool
+ * @brief Deduplicating string arena
+ *
+ * Id 0 is always the empty string and is never counted. Pointers returned
+ * by get() are valid until the next intern() (which may compact).
+ */
+class StringPool {
+public:
+    static constexpr uint16_t EMPTY_ID = 0;
+    static constexpr size_t MAX_LENGTH = 255;       // Longer text is cut at a character boundary
+    static constexpr size_t MAX_ARENA = 0xFFFFFF;
+
+    StringPool();
+    ~StringPool();
+    StringPool(const StringPool&) = delete;
+    StringPool& operator=(const StringPool&) = delete;
+
+    /**
+     * @brief Allocate arena and id table (in PSRAM when available)
+     * @param arenaSize Character bytes, at most MAX_ARENA
+     * @param maxStrings Distinct strings, at most 65534
+     * @return false if out of memory
+     */
+    bool allocate(size_t arenaSize, uint16_t maxStrings);
+
+    /**
+     * @brief Get the id of a string, adding it if new, and take a reference
+     * @return Id, or EMPTY_ID if the text is empty or the pool is full
+     */
+    uint16_t intern(const char* text, size_t length);
+    uint16_t intern(const char* text) { return intern(text, text ? strlen(text) : 0); }
+
+    /**
+     * @brief Take another reference to an id
+     */
+    void retain(uint16_t id);
+
+    /**
+     * @brief Drop a reference; the string is freed with its last reference
+     */
+    void release(uint16_t id);
+
+    /**
+     * @brief Get the characters of an id (zero-terminated)
+     */
+    const char* get(uint16_t id) const;
+
+    /**
+     * @brief Get the length of an id's string
+     */
+    uint16_t length(uint16_t id) const;
+
+    uint16_t getStringCount() const { return m_stringCount; }
+    uint16_t getMaxStrings() const { return m_maxStrings; }
+    size_t getArenaUsed() const { return m_arenaUsed; }
+    size_t getArenaSize() const { return m_arenaSize; }
+    size_t getGarbage() const { return m_garbage; }
+
+    /**
+     * @brief Get total bytes owned by the pool (arena plus tables)
+     */
+    size_t getFootprint() const;
+
+    /**
+     * @brief Get number of interns refused because the pool was full
+     */
+    uint32_t getOverflowCount() const { return m_overflows; }
+
+private:
+    // No stored hash: chains are short and compare the length first
+    struct Entry {
+        uint32_t offset : 24;
+        uint32_t length : 8;
+        uint16_t refs;      // 0 = free
+        uint16_t next;      // Next id in the hash chain, or in the free list
+    };
+
+    bool reserve(size_t bytes, bool mayCompact);
+    void compact();
+    static uint32_t hashText(const char* text, size_t length);
+
+    char* m_arena;
+    size_t m_arenaSize;
+    size_t m_arenaUsed;
+    size_t m_garbage;           // Bytes of released strings still in the arena
+    Entry* m_entries;           // Index = id; entry 0 unused
+    uint16_t m_maxStrings;
+    uint16_t* m_buckets;        // Hash chain heads (ids), 0 = empty
+    uint16_t m_bucketMask;
+    uint16_t m_freeHead;        // Free id list
+    uint16_t m_nextUnused;      // Ids above this were never handed out
+    uint16_t m_stringCount;
+    uint32_t m_overflows;
+};
+
+#endif // STRING_POOL_H
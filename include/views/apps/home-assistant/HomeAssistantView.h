@@ -35,7 +35,8 @@ enum class HomeAssistantViewMode {
  * 
  * Features:
  * - Device type grid (lights, thermostats, speakers, etc.)
- * - Device list grid (specific devices of type)
+ * - Device list grid (specific devices of type), long press switches the whole group;
+ *   icons of changed devices are refreshed from controller change events
  * - Device control page (on/off, sliders, settings)
  * - Circular sliders for brightness, hue, volume, temperature
  * - Hexagonal grid navigation
@@ -53,6 +54,13 @@ public:
     void handleTouch(TouchEvent event) override;
     const char* getName() const override { return "Home Assistant"; }
 
+    // Slider callbacks (invoked through static wrappers)
+    void handleSliderChanged(float value);
+    void handleSliderReleased(float value);
+
+    // Controller change listener (invoked through a static wrapper)
+    void handleDeviceChanged(uint16_t slot);
+
 private:
     // Rendering functions
     void renderDeviceTypes();
@@ -68,18 +76,22 @@ private:
     // Grid management
     void loadDeviceTypes();
     void loadDeviceList(HomeAssistantDeviceType type);
+    void reloadDeviceList();
+    const HomeAssistantDevice* getSelectedDevice();
     void createDeviceTypeIcon(HomeAssistantDeviceType type, const char* label);
     void createDeviceIcon(const HomeAssistantDevice& device);
+    static void applyDeviceIcon(GridItem& item, const HomeAssistantDevice& device);
     
     // Device control
     void selectDeviceType(HomeAssistantDeviceType type);
     void selectDevice(int deviceIndex);
     void toggleDevicePower();
+    void toggleGroupPower();
     void updateBrightness(float value);
     void updateHue(float value);
     void updateTemperature(float value);
     void updateVolume(float value);
-    
+
     HomeAssistantController* m_controller;
     HexagonalGrid* m_grid;
     CircularSlider* m_slider;
@@ -87,8 +99,9 @@ private:
     HomeAssistantViewMode m_mode;
     HomeAssistantDeviceType m_selectedType;
     int m_selectedDeviceIndex;
-    HomeAssistantDevice* m_devices;
-    int m_deviceCount;
+    String m_selectedEntityId;           // Device shown in DEVICE_CONTROL (looked up by id each frame)
+    HomeAssistantDeviceSpan m_devices;   // Controller's devices of m_selectedType
+    uint32_t m_deviceVersion;            // Controller device version m_devices was taken at
     
     bool m_isDragging;
     bool m_showSlider;
@@ -50,7 +50,7 @@ private:
     void dismissCurrentNotification();
 
     SlackController* m_controller;
-    SlackNotification* m_notifications;
+    SlackNotificationHandle m_handles[SLACK_NOTIFICATION_CAPACITY];  // Unread notifications, newest first
     int m_notificationCount;
     int m_currentIndex;
     uint32_t m_lastUpdate;
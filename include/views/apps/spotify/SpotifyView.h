@@ -70,9 +70,6 @@ private:
     SpotifyTab m_currentTab;
     TouchPoint m_lastTouch;
     bool m_isDragging;
-    
-    uint32_t m_lastUpdate;
-    uint32_t m_updateInterval;  // ms
 };
 
 /**
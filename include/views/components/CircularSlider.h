@@ -100,6 +100,12 @@ public:
      */
     void setOnValueChanged(void (*callback)(float value));
 
+    /**
+     * @brief Set release callback
+     * @param callback Function to call with the final value when a drag ends
+     */
+    void setOnReleased(void (*callback)(float value));
+
     /**
      * @brief Enable/disable slider
      * @param enabled true to enable
@@ -167,8 +173,9 @@ private:
     bool m_isDragging;
     bool m_hasChanged;
 
-    // Callback
+    // Callbacks
     void (*m_onValueChanged)(float value);
+    void (*m_onReleased)(float value);
 };
 
 #endif // CIRCULAR_SLIDER_H
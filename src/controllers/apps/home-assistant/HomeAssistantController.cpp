@@ -5,11 +5,13 @@
 
 #include "controllers/apps/home-assistant/HomeAssistantController.h"
 #include "models/home-assistant/HomeAssistantDevice.h"
+#include "utils/JsonStreamReader.h"
 
 // Home Assistant API endpoints
 static const char* ENDPOINT_STATES = "/api/states";
 static const char* ENDPOINT_SERVICES = "/api/services";
 static const char* ENDPOINT_CONFIG = "/api/config";
+static const char* ENDPOINT_TEMPLATE = "/api/template";
 
 HomeAssistantController& HomeAssistantController::getInstance() {
     static HomeAssistantController instance;
@@ -21,20 +23,47 @@ HomeAssistantController::HomeAssistantController()
     , m_accessToken("")
     , m_authenticated(false)
     , m_initialized(false)
-    , m_devices(nullptr)
-    , m_deviceCount(0)
-    , m_maxDevices(50)
-    , m_lastPollTime(0)
-    , m_pollInterval(10000) {  // Poll every 10 seconds
+    , m_lastHttpCode(0)
+    , m_entitiesFullLogged(false)
+    , m_subscriptionChanged(false)
+    , m_pollSchedule("/app/home-assistant", 10000, 3000, 60000)
+    , m_socketState(HomeAssistantSocketState::DISABLED)
+    , m_socketStateSince(0)
+    , m_socketRetryAt(0)
+    , m_socketBackoff(HA_WS_RETRY_MIN_MS)
+    , m_socketMessageId(0)
+    , m_subscribeId(0)
+    , m_serverFiltered(false)
+    , m_resyncPending(false)
+    , m_lastOperationId(0)
+    , m_rolledBackCount(0)
+    , m_serviceCalls(0)
+    , m_batchedOperations(0) {
     
-    // Allocate device buffer
-    m_devices = new HomeAssistantDevice[m_maxDevices];
+    // Without PSRAM the tables would come out of internal RAM: keep them small
+    if (!m_entities.allocate(psramFound() ? HA_MAX_ENTITIES : HA_MAX_ENTITIES_NO_PSRAM)) {
+        DEBUG_PRINTLN("[HomeAssistantController] Failed to allocate entity store");
+    }
+
+    memset(&m_syncStats, 0, sizeof(m_syncStats));
+
+    for (int i = 0; i < HA_CHANGE_LISTENERS; i++) {
+        m_changeListeners[i].callback = nullptr;
+        m_changeListeners[i].context = nullptr;
+    }
+
+    for (int i = 0; i < HA_PENDING_OPS_MAX; i++) {
+        m_operations[i].id = 0;
+    }
+
+    for (int i = 0; i < HA_CONTROL_SLOTS; i++) {
+        m_controls[i].kind = ControlKind::BRIGHTNESS;
+        m_controls[i].coalescer.setTarget(sendControl, &m_controls[i]);
+    }
 }
 
 HomeAssistantController::~HomeAssistantController() {
-    if (m_devices) {
-        delete[] m_devices;
-    }
+    stopSocket();
 }
 
 bool HomeAssistantController::init() {
@@ -47,6 +76,9 @@ bool HomeAssistantController::init() {
     // Load server URL and token from database
     User* currentUser = AuthService::getInstance().getCurrentUser();
     if (currentUser) {
+        // Before authenticating: the first sync already applies it
+        loadSubscription();
+
         String serverUrl = DatabaseService::getInstance().getSetting(currentUser->getId(), "ha_server_url", "");
         String token = DatabaseService::getInstance().getToken(currentUser->getId(), "home-assistant");
         
@@ -70,14 +102,61 @@ void HomeAssistantController::update() {
         return;
     }
 
-    // Check if it's time to poll
-    uint32_t currentTime = millis();
-    if (currentTime - m_lastPollTime >= m_pollInterval) {
-        m_lastPollTime = currentTime;
+    for (int i = 0; i < HA_CONTROL_SLOTS; i++) {
+        m_controls[i].coalescer.update();
+    }
+
+    if (m_socketState != HomeAssistantSocketState::DISABLED) {
+        if (m_socketState == HomeAssistantSocketState::DISCONNECTED) {
+            // The library's own reconnect would block in loop() on every
+            // interval; reconnect here instead, with backoff, and not while
+            // the REST circuit says the server is down
+            if ((int32_t)(millis() - m_socketRetryAt) >= 0 && !isDegraded()) {
+                openSocket();
+            }
+        } else {
+            m_socket.loop();
+
+            // Every step before LIVE has a deadline; polling is off while authenticating
+            // or subscribing, so a missing reply would otherwise freeze device state
+            bool pending = m_socketState == HomeAssistantSocketState::CONNECTING ||
+                           m_socketState == HomeAssistantSocketState::AUTHENTICATING ||
+                           m_socketState == HomeAssistantSocketState::SUBSCRIBING;
+            if (pending && millis() - m_socketStateSince >= HA_WS_CONNECT_TIMEOUT_MS) {
+                DEBUG_PRINTF("[HomeAssistantController] WebSocket %s timed out\n",
+                             m_socketState == HomeAssistantSocketState::CONNECTING ? "connect" :
+                             m_socketState == HomeAssistantSocketState::AUTHENTICATING ? "auth" : "subscribe");
+                m_socketState = HomeAssistantSocketState::DISCONNECTED;
+                m_socket.disconnect();
+                scheduleSocketRetry();
+            }
+        }
+
+        // Full state after every (re)subscribe, so nothing missed while disconnected is lost
+        if (m_resyncPending) {
+            m_resyncPending = false;
+            m_pollSchedule.start();
+            DEBUG_PRINTLN("[HomeAssistantController] Resyncing state...");
+            RequestScheduler::getInstance().submit(RequestPriority::VISIBLE, runFetchDevices, this, "ha-states");
+        }
+
+        // Events keep the devices current; only poll while the socket is down
+        if (m_socketState != HomeAssistantSocketState::DISCONNECTED &&
+            m_socketState != HomeAssistantSocketState::CONNECTING) {
+            return;
+        }
+    }
+
+    // Check if it's time to poll (interval adapts to visibility and change rate)
+    if (m_pollSchedule.isDue()) {
+        m_pollSchedule.start();
         
-        // Fetch device states
+        // Fetch device states (dropped if still queued at the next poll)
         DEBUG_PRINTLN("[HomeAssistantController] Polling for updates...");
-        fetchDevices();
+        RequestPriority priority = m_pollSchedule.isVisible() ? RequestPriority::VISIBLE
+                                                              : RequestPriority::BACKGROUND;
+        RequestScheduler::getInstance().submit(priority, runFetchDevices, this,
+                                               "ha-states", m_pollSchedule.getInterval());
     }
 }
 
@@ -123,35 +202,46 @@ bool HomeAssistantController::authenticate() {
     DEBUG_PRINTLN("[HomeAssistantController] Authenticating...");
 
     String response;
-    if (!makeAPIRequest(ENDPOINT_CONFIG, "GET", "", response)) {
+    if (!makeAPIRequest(ENDPOINT_CONFIG, "GET", "", response, true)) {
         DEBUG_PRINTLN("[HomeAssistantController] Authentication failed");
         m_authenticated = false;
         return false;
     }
 
-    // Parse response
-    DynamicJsonDocument doc(1024);
-    DeserializationError error = deserializeJson(doc, response);
+    // Unchanged config means the token was accepted again; only the parse is skipped
+    if (m_lastHttpCode == HTTP_CODE_NOT_MODIFIED) {
+        DEBUG_PRINTLN("[HomeAssistantController] Authenticated successfully (config unchanged)");
+    } else {
+        // Parse response
+        DynamicJsonDocument doc(1024);
+        DeserializationError error = deserializeJson(doc, response);
+
+        if (error) {
+            DEBUG_PRINTF("[HomeAssistantController] JSON parse error: %s\n", error.c_str());
+            m_authenticated = false;
+            return false;
+        }
 
-    if (error) {
-        DEBUG_PRINTF("[HomeAssistantController] JSON parse error: %s\n", error.c_str());
-        m_authenticated = false;
-        return false;
-    }
+        // Check for valid config response
+        if (!doc.containsKey("version")) {
+            DEBUG_PRINTLN("[HomeAssistantController] Invalid config response");
+            m_authenticated = false;
+            return false;
+        }
 
-    // Check for valid config response
-    if (!doc.containsKey("version")) {
-        DEBUG_PRINTLN("[HomeAssistantController] Invalid config response");
-        m_authenticated = false;
-        return false;
+        DEBUG_PRINTLN("[HomeAssistantController] Authenticated successfully!");
+        DEBUG_PRINTF("[HomeAssistantController] HA Version: %s\n", doc["version"].as<const char*>());
     }
 
     m_authenticated = true;
-    DEBUG_PRINTLN("[HomeAssistantController] Authenticated successfully!");
-    DEBUG_PRINTF("[HomeAssistantController] HA Version: %s\n", doc["version"].as<const char*>());
 
+#if HA_WEBSOCKET_ENABLED
+    // Initial device list is fetched once the event subscription is in place
+    startSocket();
+#else
     // Fetch initial device list
     fetchDevices();
+#endif
 
     return true;
 }
@@ -168,107 +258,186 @@ bool HomeAssistantController::fetchDevices() {
 
     DEBUG_PRINTLN("[HomeAssistantController] Fetching devices...");
 
-    String response;
-    if (!makeAPIRequest(ENDPOINT_STATES, "GET", "", response)) {
+    // Area members must be known before the sweep, or they would be dropped
+    if (m_subscription.needsAreaResolve() && !resolveSubscriptionAreas()) {
+        DEBUG_PRINTLN("[HomeAssistantController] Area members unknown, updating known entities without removing any");
+    }
+
+    // /api/states is far too large to buffer; parse entities straight off the socket.
+    // Unchanged states still need a full pass after the subscription changed.
+    if (!makeStreamRequest(ENDPOINT_STATES, "GET", "", handleStatesStream, this, !m_subscriptionChanged)) {
         DEBUG_PRINTLN("[HomeAssistantController] Failed to fetch devices");
         return false;
     }
+    // Still unresolved areas: the next listing must be a full pass again
+    m_subscriptionChanged = m_subscription.needsAreaResolve();
 
-    // Parse and store devices
-    parseDevices(response);
+    if (m_lastHttpCode == HTTP_CODE_NOT_MODIFIED) {
+        DEBUG_PRINTLN("[HomeAssistantController] Devices unchanged");
+        return true;
+    }
+
+    DEBUG_PRINTF("[HomeAssistantController] Fetched %d devices\n", m_entities.size());
 
-    DEBUG_PRINTF("[HomeAssistantController] Fetched %d devices\n", m_deviceCount);
+    // Areas just resolved may turn the subscription into a server-side filter
+    if (m_socketState == HomeAssistantSocketState::LIVE && !m_serverFiltered && m_subscription.canFilterOnServer()) {
+        subscribeSocket();
+    }
     return true;
 }
 
-int HomeAssistantController::getDevicesByType(HomeAssistantDeviceType type, HomeAssistantDevice* devices, int maxDevices) {
-    if (!devices || maxDevices <= 0) {
-        return 0;
+void HomeAssistantController::setSubscription(const HomeAssistantSubscription& subscription) {
+    m_subscription = subscription;
+    m_subscriptionChanged = true;
+
+    User* currentUser = AuthService::getInstance().getCurrentUser();
+    if (currentUser) {
+        DatabaseService::getInstance().saveSetting(currentUser->getId(), "ha_subscription", m_subscription.serialize());
     }
 
-    int count = 0;
-    for (int i = 0; i < m_deviceCount && count < maxDevices; i++) {
-        if (m_devices[i].type == type) {
-            devices[count++] = m_devices[i];
-        }
+    DEBUG_PRINTF("[HomeAssistantController] Subscription: %d entities, %d domains, %d areas\n",
+                 m_subscription.getEntityCount(), m_subscription.getDomainCount(), m_subscription.getAreaCount());
+
+    if (!m_authenticated) {
+        return;
     }
 
-    return count;
+    // A new subscription result triggers the resync; without a live socket, sync now
+    if (m_socketState == HomeAssistantSocketState::LIVE) {
+        subscribeSocket();
+    } else {
+        RequestScheduler::getInstance().submit(RequestPriority::VISIBLE, runFetchDevices, this, "ha-states");
+    }
 }
 
-int HomeAssistantController::getAllDevices(HomeAssistantDevice* devices, int maxDevices) {
-    if (!devices || maxDevices <= 0) {
-        return 0;
+void HomeAssistantController::loadSubscription() {
+    User* currentUser = AuthService::getInstance().getCurrentUser();
+    if (!currentUser) {
+        return;
     }
 
-    int count = (m_deviceCount < maxDevices) ? m_deviceCount : maxDevices;
-    
-    for (int i = 0; i < count; i++) {
-        devices[i] = m_devices[i];
+    String stored = DatabaseService::getInstance().getSetting(currentUser->getId(), "ha_subscription", "");
+    int loaded = m_subscription.deserialize(stored);
+    DEBUG_PRINTF("[HomeAssistantController] Loaded subscription (%d entries)\n", loaded);
+}
+
+bool HomeAssistantController::resolveSubscriptionAreas() {
+    // States carry no area; one template render lists the members of every subscribed area
+    String areas;
+    for (int i = 0; i < m_subscription.getAreaCount(); i++) {
+        if (areas.length() > 0) {
+            areas += " + ";
+        }
+        // Area names are free text ("Kid's Room"): escape them for the Jinja string literal
+        String area = m_subscription.getArea(i);
+        area.replace("\\", "\\\\");
+        area.replace("'", "\\'");
+        areas += "area_entities('" + area + "')";
     }
 
-    return count;
+    if (areas.length() == 0) {
+        m_subscription.setAreaEntities("");
+        return true;
+    }
+
+    DynamicJsonDocument request(256 + areas.length());
+    request["template"] = "{{ (" + areas + ") | join(',') }}";
+    String body;
+    serializeJson(request, body);
+
+    String response;
+    if (!makeAPIRequest(ENDPOINT_TEMPLATE, "POST", body, response)) {
+        return false;
+    }
+
+    int added = m_subscription.setAreaEntities(response);
+    DEBUG_PRINTF("[HomeAssistantController] %d entities in %d subscribed areas\n",
+                 added, m_subscription.getAreaCount());
+    return true;
+}
+
+HomeAssistantDeviceSpan HomeAssistantController::getDevicesByType(HomeAssistantDeviceType type) const {
+    return m_entities.byType(type);
+}
+
+HomeAssistantDeviceSpan HomeAssistantController::getAllDevices() const {
+    return m_entities.all();
 }
 
 HomeAssistantDevice* HomeAssistantController::getDevice(const String& entityId) {
-    for (int i = 0; i < m_deviceCount; i++) {
-        if (m_devices[i].entityId == entityId) {
-            return &m_devices[i];
+    return m_entities.find(entityId);
+}
+
+bool HomeAssistantController::addChangeListener(HomeAssistantChangeCallback callback, void* context) {
+    if (!callback) return false;
+
+    for (int i = 0; i < HA_CHANGE_LISTENERS; i++) {
+        if (!m_changeListeners[i].callback) {
+            m_changeListeners[i].callback = callback;
+            m_changeListeners[i].context = context;
+            return true;
+        }
+    }
+
+    DEBUG_PRINTLN("[HomeAssistantController] ERROR: Change listener table full");
+    return false;
+}
+
+void HomeAssistantController::removeChangeListener(HomeAssistantChangeCallback callback, void* context) {
+    for (int i = 0; i < HA_CHANGE_LISTENERS; i++) {
+        if (m_changeListeners[i].callback == callback && m_changeListeners[i].context == context) {
+            m_changeListeners[i].callback = nullptr;
+            m_changeListeners[i].context = nullptr;
         }
     }
-    return nullptr;
+}
+
+void HomeAssistantController::publishChange(const HomeAssistantDevice& device) {
+    uint16_t slot = m_entities.slotOf(device);
+    for (int i = 0; i < HA_CHANGE_LISTENERS; i++) {
+        if (m_changeListeners[i].callback) {
+            m_changeListeners[i].callback(slot, m_changeListeners[i].context);
+        }
+    }
+}
+
+void HomeAssistantController::markLocalChange(HomeAssistantDevice& device) {
+    // The device no longer matches the last server state: apply the next one
+    // whatever its hash
+    m_entities.invalidateStateHash(device);
+    publishChange(device);
 }
 
 bool HomeAssistantController::turnOn(const String& entityId) {
-    String domain = entityId.substring(0, entityId.indexOf('.'));
-    return callService(domain, "turn_on", entityId);
+    return enqueueOperation(HomeAssistantOperationKind::TURN_ON, entityId);
 }
 
 bool HomeAssistantController::turnOff(const String& entityId) {
-    String domain = entityId.substring(0, entityId.indexOf('.'));
-    return callService(domain, "turn_off", entityId);
+    return enqueueOperation(HomeAssistantOperationKind::TURN_OFF, entityId);
 }
 
 bool HomeAssistantController::toggle(const String& entityId) {
-    String domain = entityId.substring(0, entityId.indexOf('.'));
-    return callService(domain, "toggle", entityId);
+    // Resolve against the local (possibly optimistic) state so the command is
+    // idempotent and can be safely re-applied on top of server updates
+    HomeAssistantDevice* device = getDevice(entityId);
+    bool isOn = device && device->state == HomeAssistantDeviceState::ON;
+    return enqueueOperation(isOn ? HomeAssistantOperationKind::TURN_OFF : HomeAssistantOperationKind::TURN_ON, entityId);
 }
 
 bool HomeAssistantController::setBrightness(const String& entityId, uint8_t brightness) {
-    DynamicJsonDocument doc(256);
-    doc["brightness"] = brightness;
-    
-    String data;
-    serializeJson(doc, data);
-    
-    return callService("light", "turn_on", entityId, data);
+    return enqueueOperation(HomeAssistantOperationKind::BRIGHTNESS, entityId, brightness);
 }
 
 bool HomeAssistantController::setColor(const String& entityId, uint8_t r, uint8_t g, uint8_t b) {
-    DynamicJsonDocument doc(256);
-    JsonArray color = doc.createNestedArray("rgb_color");
-    color.add(r);
-    color.add(g);
-    color.add(b);
-    
-    String data;
-    serializeJson(doc, data);
-    
-    return callService("light", "turn_on", entityId, data);
+    return enqueueOperation(HomeAssistantOperationKind::COLOR, entityId, 0.0f, r, g, b);
 }
 
 bool HomeAssistantController::setColorTemp(const String& entityId, uint16_t colorTemp) {
-    DynamicJsonDocument doc(256);
-    doc["color_temp"] = colorTemp;
-    
-    String data;
-    serializeJson(doc, data);
-    
-    return callService("light", "turn_on", entityId, data);
+    return enqueueOperation(HomeAssistantOperationKind::COLOR_TEMP, entityId, colorTemp);
 }
 
 bool HomeAssistantController::activateScene(const String& sceneId) {
-    return callService("scene", "turn_on", sceneId);
+    return enqueueOperation(HomeAssistantOperationKind::SCENE, sceneId);
 }
 
 bool HomeAssistantController::setMediaPlayerVolume(const String& entityId, float volume) {
@@ -283,55 +452,453 @@ bool HomeAssistantController::setMediaPlayerVolume(const String& entityId, float
 
     DEBUG_PRINTF("[HomeAssistantController] Set media player volume: %.2f\n", volume);
 
-    DynamicJsonDocument doc(256);
-    doc["volume_level"] = volume;
-    
-    String data;
-    serializeJson(doc, data);
-    
-    return callService("media_player", "volume_set", entityId, data);
+    return enqueueOperation(HomeAssistantOperationKind::VOLUME, entityId, volume);
 }
 
-bool HomeAssistantController::getDeviceState(const String& entityId, HomeAssistantDevice& device) {
-    HomeAssistantDevice* foundDevice = getDevice(entityId);
-    if (foundDevice) {
-        device = *foundDevice;
-        return true;
+int HomeAssistantController::setPowerForEntities(const String* entityIds, int count, bool on) {
+    HomeAssistantOperationKind kind = on ? HomeAssistantOperationKind::TURN_ON : HomeAssistantOperationKind::TURN_OFF;
+
+    // Queued back to back, so the next drain merges them per domain
+    int queued = 0;
+    for (int i = 0; i < count; i++) {
+        if (enqueueOperation(kind, entityIds[i])) {
+            queued++;
+        }
+    }
+    return queued;
+}
+
+int HomeAssistantController::setBrightnessForEntities(const String* entityIds, int count, uint8_t brightness) {
+    int queued = 0;
+    for (int i = 0; i < count; i++) {
+        if (enqueueOperation(HomeAssistantOperationKind::BRIGHTNESS, entityIds[i], brightness)) {
+            queued++;
+        }
+    }
+    return queued;
+}
+
+int HomeAssistantController::getPendingOperationCount() const {
+    int count = 0;
+    for (int i = 0; i < HA_PENDING_OPS_MAX; i++) {
+        if (m_operations[i].id != 0) {
+            count++;
+        }
+    }
+    return count;
+}
+
+bool HomeAssistantController::hasPendingOperation(const String& entityId) const {
+    for (int i = 0; i < HA_PENDING_OPS_MAX; i++) {
+        if (m_operations[i].id != 0 && m_operations[i].entityId == entityId) {
+            return true;
+        }
     }
     return false;
 }
 
-bool HomeAssistantController::callService(const String& domain, const String& service, const String& entityId, const String& data) {
+bool HomeAssistantController::enqueueOperation(HomeAssistantOperationKind kind, const String& entityId,
+                                               float value, uint8_t r, uint8_t g, uint8_t b) {
     if (!m_authenticated) {
         DEBUG_PRINTLN("[HomeAssistantController] Not authenticated");
         return false;
     }
 
-    DEBUG_PRINTF("[HomeAssistantController] Calling service: %s.%s for %s\n", 
-                 domain.c_str(), service.c_str(), entityId.c_str());
+    HomeAssistantDevice* device = getDevice(entityId);
+    PendingOperation* op = nullptr;
+
+    // A queued (not yet sent) command of the same kind is superseded: keep its
+    // snapshot, replace its arguments
+    for (int i = 0; i < HA_PENDING_OPS_MAX; i++) {
+        PendingOperation& candidate = m_operations[i];
+        if (candidate.id != 0 && !candidate.inFlight && candidate.entityId == entityId &&
+            isSameControl(candidate.kind, kind)) {
+            op = &candidate;
+            break;
+        }
+    }
 
-    // Build endpoint
-    String endpoint = String(ENDPOINT_SERVICES) + "/" + domain + "/" + service;
+    if (!op) {
+        for (int i = 0; i < HA_PENDING_OPS_MAX; i++) {
+            if (m_operations[i].id == 0) {
+                op = &m_operations[i];
+                break;
+            }
+        }
+
+        if (!op) {
+            DEBUG_PRINTLN("[HomeAssistantController] Operation journal full");
+            return false;
+        }
+
+        op->id = ++m_lastOperationId;
+        op->entityId = entityId;
+        op->inFlight = false;
+        op->hasSnapshot = device != nullptr;
+        if (device) {
+            op->snapshot = *device;
+        }
+    }
 
+    op->kind = kind;
+    op->value = value;
+    op->r = r;
+    op->g = g;
+    op->b = b;
+
+    // Optimistic: the UI shows the intended state right away
+    if (device) {
+        applyOperation(*device, *op);
+        markLocalChange(*device);
+    }
+
+    scheduleOperations();
+    return true;
+}
+
+void HomeAssistantController::scheduleOperations() {
+    for (int i = 0; i < HA_PENDING_OPS_MAX; i++) {
+        if (m_operations[i].id != 0 && !m_operations[i].inFlight) {
+            RequestScheduler::getInstance().submit(RequestPriority::INTERACTIVE, runPendingOperations,
+                                                   this, "ha-commands");
+            return;
+        }
+    }
+}
+
+bool HomeAssistantController::runPendingOperations(void* context) {
+    HomeAssistantController* self = static_cast<HomeAssistantController*>(context);
+    self->processPendingOperations();
+
+    // Remaining commands go out in the same scheduler pass
+    self->scheduleOperations();
+    return true;
+}
+
+bool HomeAssistantController::runFetchDevices(void* context) {
+    HomeAssistantController* self = static_cast<HomeAssistantController*>(context);
+    if (!self->fetchDevices()) {
+        return false;
+    }
+
+    // Only real entity changes count towards the change rate, not a re-sent listing
+    const HomeAssistantSyncStats& stats = self->m_syncStats;
+    bool changed = self->m_lastHttpCode != HTTP_CODE_NOT_MODIFIED && (stats.changed > 0 || stats.removed > 0);
+    self->m_pollSchedule.recordResult(changed);
+    return true;
+}
+
+void HomeAssistantController::processPendingOperations() {
+    // Oldest first, one service call per scheduler job
+    PendingOperation* oldest = nullptr;
+    for (int i = 0; i < HA_PENDING_OPS_MAX; i++) {
+        PendingOperation& candidate = m_operations[i];
+        if (candidate.id != 0 && !candidate.inFlight && (!oldest || candidate.id < oldest->id)) {
+            oldest = &candidate;
+        }
+    }
+
+    if (!oldest) {
+        return;
+    }
+
+    // Everything else waiting for the same call rides along
+    PendingOperation* batch[HA_BATCH_MAX_ENTITIES];
+    uint32_t batchIds[HA_BATCH_MAX_ENTITIES];
+    int batchSize = 0;
+    batch[batchSize++] = oldest;
+    for (int i = 0; i < HA_PENDING_OPS_MAX && batchSize < HA_BATCH_MAX_ENTITIES; i++) {
+        PendingOperation& candidate = m_operations[i];
+        if (&candidate != oldest && candidate.id != 0 && !candidate.inFlight && canBatch(*oldest, candidate)) {
+            batch[batchSize++] = &candidate;
+        }
+    }
+
+    DynamicJsonDocument payload(256 + 64 * batchSize);
+    String domain;
+    String service;
+    describeOperation(*oldest, domain, service, payload.to<JsonObject>());
+
+    if (batchSize == 1) {
+        payload["entity_id"] = oldest->entityId;
+    } else {
+        JsonArray entities = payload.createNestedArray("entity_id");
+        for (int i = 0; i < batchSize; i++) {
+            entities.add(batch[i]->entityId);
+        }
+    }
+
+    for (int i = 0; i < batchSize; i++) {
+        batch[i]->inFlight = true;
+        batchIds[i] = batch[i]->id;
+    }
+
+    m_serviceCalls++;
+    m_batchedOperations += batchSize;
+
+    // The response lists the states the call changed; they are applied as
+    // authoritative state (pending commands are re-applied on top)
+    bool success = sendServiceCall(domain, service, payload);
+
+    for (int i = 0; i < batchSize; i++) {
+        PendingOperation* op = batch[i];
+
+        // The journal slot may only be trusted if it still holds this operation
+        if (op->id != batchIds[i]) {
+            continue;
+        }
+
+        if (success) {
+            op->id = 0;
+        } else {
+            rollbackOperation(op);
+        }
+    }
+}
+
+void HomeAssistantController::describeOperation(const PendingOperation& op, String& domain, String& service,
+                                                JsonObject data) {
+    domain = op.entityId.substring(0, op.entityId.indexOf('.'));
+
+    switch (op.kind) {
+        case HomeAssistantOperationKind::TURN_ON:
+            service = "turn_on";
+            break;
+        case HomeAssistantOperationKind::TURN_OFF:
+            service = "turn_off";
+            break;
+        case HomeAssistantOperationKind::BRIGHTNESS:
+            domain = "light";
+            service = "turn_on";
+            data["brightness"] = (uint8_t)op.value;
+            break;
+        case HomeAssistantOperationKind::COLOR: {
+            domain = "light";
+            service = "turn_on";
+            JsonArray color = data.createNestedArray("rgb_color");
+            color.add(op.r);
+            color.add(op.g);
+            color.add(op.b);
+            break;
+        }
+        case HomeAssistantOperationKind::COLOR_TEMP:
+            domain = "light";
+            service = "turn_on";
+            data["color_temp"] = (uint16_t)op.value;
+            break;
+        case HomeAssistantOperationKind::VOLUME:
+            domain = "media_player";
+            service = "volume_set";
+            data["volume_level"] = op.value;
+            break;
+        case HomeAssistantOperationKind::SCENE:
+            domain = "scene";
+            service = "turn_on";
+            break;
+    }
+}
+
+bool HomeAssistantController::canBatch(const PendingOperation& a, const PendingOperation& b) {
+    if (a.kind != b.kind || a.value != b.value || a.r != b.r || a.g != b.g || a.b != b.b) {
+        return false;
+    }
+
+    // turn_on / turn_off are addressed to the entity's own domain
+    int aDot = a.entityId.indexOf('.');
+    int bDot = b.entityId.indexOf('.');
+    return aDot == bDot && strncmp(a.entityId.c_str(), b.entityId.c_str(), aDot) == 0;
+}
+
+void HomeAssistantController::rollbackOperation(PendingOperation* op) {
+    DEBUG_PRINTF("[HomeAssistantController] Rolling back %s\n", op->entityId.c_str());
+    m_rolledBackCount++;
+
+    String entityId = op->entityId;
+    HomeAssistantDevice* device = getDevice(entityId);
+    if (device && op->hasSnapshot) {
+        *device = op->snapshot;
+    }
+
+    op->id = 0;
+
+    // Later commands for the same entity were based on the failed one's
+    // outcome; rebase their snapshots and re-apply them
+    for (int i = 0; i < HA_PENDING_OPS_MAX; i++) {
+        PendingOperation& later = m_operations[i];
+        if (later.id != 0 && later.entityId == entityId && device) {
+            later.snapshot = *device;
+            applyOperation(*device, later);
+        }
+    }
+
+    if (device) {
+        markLocalChange(*device);
+    }
+}
+
+bool HomeAssistantController::reapplyPendingOperations(HomeAssistantDevice& device) {
+    bool applied = false;
+    for (int i = 0; i < HA_PENDING_OPS_MAX; i++) {
+        PendingOperation& op = m_operations[i];
+        if (op.id != 0 && device.hasEntityId(op.entityId)) {
+            // Rebase on the state just received, so a rollback restores what
+            // the server last reported rather than the state at enqueue time
+            op.snapshot = device;
+            op.hasSnapshot = true;
+            applyOperation(device, op);
+            applied = true;
+        }
+    }
+    return applied;
+}
+
+void HomeAssistantController::applyOperation(HomeAssistantDevice& device, const PendingOperation& op) {
+    switch (op.kind) {
+        case HomeAssistantOperationKind::TURN_ON:
+            device.state = HomeAssistantDeviceState::ON;
+            break;
+        case HomeAssistantOperationKind::TURN_OFF:
+            device.state = HomeAssistantDeviceState::OFF;
+            break;
+        case HomeAssistantOperationKind::BRIGHTNESS:
+            device.setBrightness((uint8_t)op.value);
+            device.state = op.value > 0 ? HomeAssistantDeviceState::ON : HomeAssistantDeviceState::OFF;
+            break;
+        case HomeAssistantOperationKind::COLOR:
+            device.setColor(op.r, op.g, op.b);
+            device.state = HomeAssistantDeviceState::ON;
+            break;
+        case HomeAssistantOperationKind::COLOR_TEMP:
+            device.setColorTemp((uint16_t)op.value);
+            device.state = HomeAssistantDeviceState::ON;
+            break;
+        case HomeAssistantOperationKind::VOLUME:
+            device.setVolume(op.value);
+            break;
+        case HomeAssistantOperationKind::SCENE:
+            break;
+    }
+}
+
+bool HomeAssistantController::isSameControl(HomeAssistantOperationKind a, HomeAssistantOperationKind b) {
+    bool aPower = a == HomeAssistantOperationKind::TURN_ON || a == HomeAssistantOperationKind::TURN_OFF;
+    bool bPower = b == HomeAssistantOperationKind::TURN_ON || b == HomeAssistantOperationKind::TURN_OFF;
+    return (aPower && bPower) || a == b;
+}
+
+void HomeAssistantController::requestBrightness(const String& entityId, uint8_t brightness) {
+    HomeAssistantDevice* device = getDevice(entityId);
+    if (device) {
+        device->setBrightness(brightness);
+        markLocalChange(*device);
+    }
+
+    ControlSlot* slot = getControlSlot(entityId, ControlKind::BRIGHTNESS);
+    slot->coalescer.submit((float)brightness);
+}
+
+void HomeAssistantController::requestMediaPlayerVolume(const String& entityId, float volume) {
+    if (volume < 0.0f) volume = 0.0f;
+    if (volume > 1.0f) volume = 1.0f;
+
+    HomeAssistantDevice* device = getDevice(entityId);
+    if (device) {
+        device->setVolume(volume);
+        markLocalChange(*device);
+    }
+
+    ControlSlot* slot = getControlSlot(entityId, ControlKind::VOLUME);
+    slot->coalescer.submit(volume);
+}
+
+void HomeAssistantController::flushControls() {
+    for (int i = 0; i < HA_CONTROL_SLOTS; i++) {
+        m_controls[i].coalescer.flush();
+    }
+}
+
+HomeAssistantController::ControlSlot* HomeAssistantController::getControlSlot(const String& entityId, ControlKind kind) {
+    ControlSlot* freeSlot = nullptr;
+    for (int i = 0; i < HA_CONTROL_SLOTS; i++) {
+        ControlSlot& slot = m_controls[i];
+        if (slot.kind == kind && slot.entityId == entityId) {
+            return &slot;
+        }
+        if (!freeSlot && !slot.coalescer.hasPending()) {
+            freeSlot = &slot;
+        }
+    }
+
+    // Every slot has a pending value: send one out rather than lose it
+    if (!freeSlot) {
+        freeSlot = &m_controls[0];
+        freeSlot->coalescer.flush();
+    }
+
+    freeSlot->entityId = entityId;
+    freeSlot->kind = kind;
+    freeSlot->coalescer.setTarget(sendControl, freeSlot);
+    return freeSlot;
+}
+
+bool HomeAssistantController::sendControl(float value, void* context) {
+    ControlSlot* slot = static_cast<ControlSlot*>(context);
+    HomeAssistantController& self = getInstance();
+
+    if (slot->kind == ControlKind::BRIGHTNESS) {
+        return self.setBrightness(slot->entityId, (uint8_t)value);
+    }
+    return self.setMediaPlayerVolume(slot->entityId, value);
+}
+
+bool HomeAssistantController::getDeviceState(const String& entityId, HomeAssistantDevice& device) {
+    HomeAssistantDevice* foundDevice = getDevice(entityId);
+    if (foundDevice) {
+        device = *foundDevice;
+        return true;
+    }
+    return false;
+}
+
+bool HomeAssistantController::callService(const String& domain, const String& service, const String& entityId, const String& data) {
     // Build payload
     DynamicJsonDocument doc(512);
-    doc["entity_id"] = entityId;
     
     // Merge additional data if provided
     if (data.length() > 0) {
-        DynamicJsonDocument dataDoc(256);
-        deserializeJson(dataDoc, data);
-        JsonObject dataObj = dataDoc.as<JsonObject>();
-        for (JsonPair kv : dataObj) {
-            doc[kv.key()] = kv.value();
+        DeserializationError error = deserializeJson(doc, data);
+        if (error || !doc.is<JsonObject>()) {
+            DEBUG_PRINTF("[HomeAssistantController] Invalid service data: %s\n", data.c_str());
+            return false;
         }
     }
+    doc["entity_id"] = entityId;
 
-    String payload;
-    serializeJson(doc, payload);
+    return sendServiceCall(domain, service, doc);
+}
 
-    String response;
-    if (!makeAPIRequest(endpoint, "POST", payload, response)) {
+bool HomeAssistantController::sendServiceCall(const String& domain, const String& service, JsonDocument& payload) {
+    if (!m_authenticated) {
+        DEBUG_PRINTLN("[HomeAssistantController] Not authenticated");
+        return false;
+    }
+
+    JsonVariant target = payload["entity_id"];
+    if (target.is<JsonArray>()) {
+        DEBUG_PRINTF("[HomeAssistantController] Calling service: %s.%s for %u entities\n",
+                     domain.c_str(), service.c_str(), (unsigned)target.size());
+    } else {
+        DEBUG_PRINTF("[HomeAssistantController] Calling service: %s.%s for %s\n",
+                     domain.c_str(), service.c_str(), target.as<const char*>());
+    }
+
+    // Build endpoint
+    String endpoint = String(ENDPOINT_SERVICES) + "/" + domain + "/" + service;
+
+    String body;
+    serializeJson(payload, body);
+
+    if (!makeStreamRequest(endpoint, "POST", body, handleServiceResponse, this)) {
         DEBUG_PRINTLN("[HomeAssistantController] Service call failed");
         return false;
     }
@@ -340,98 +907,518 @@ bool HomeAssistantController::callService(const String& domain, const String& se
     return true;
 }
 
-bool HomeAssistantController::makeAPIRequest(const String& endpoint, const String& method, const String& payload, String& response) {
+bool HomeAssistantController::makeAPIRequest(const String& endpoint, const String& method, const String& payload, String& response,
+                                             bool conditional) {
     if (!NetworkService::getInstance().isConnected()) {
         DEBUG_PRINTLN("[HomeAssistantController] Not connected to network");
         return false;
     }
 
-    HTTPClient http;
     String url = m_serverUrl + endpoint;
 
     DEBUG_PRINTF("[HomeAssistantController] %s %s\n", method.c_str(), url.c_str());
 
-    http.begin(url);
-    http.addHeader("Authorization", "Bearer " + m_accessToken);
-    http.addHeader("Content-Type", "application/json");
+    ApiHeader headers[] = {
+        { "Authorization", "Bearer " + m_accessToken },
+        { "Content-Type", "application/json" }
+    };
 
-    int httpCode;
-    if (method == "POST") {
-        httpCode = http.POST(payload);
-    } else {
-        httpCode = http.GET();
+    int httpCode = ApiService::getInstance().request(method, url, payload, headers, 2, response, conditional);
+    return checkResponse(httpCode);
+}
+
+bool HomeAssistantController::makeStreamRequest(const String& endpoint, const String& method, const String& payload,
+                                                ApiStreamHandler handler, void* context, bool conditional) {
+    if (!NetworkService::getInstance().isConnected()) {
+        DEBUG_PRINTLN("[HomeAssistantController] Not connected to network");
+        return false;
+    }
+
+    String url = m_serverUrl + endpoint;
+
+    DEBUG_PRINTF("[HomeAssistantController] %s %s (streamed)\n", method.c_str(), url.c_str());
+
+    ApiHeader headers[] = {
+        { "Authorization", "Bearer " + m_accessToken },
+        { "Content-Type", "application/json" }
+    };
+
+    int httpCode = ApiService::getInstance().requestStream(method, url, payload, headers, 2, handler, context, conditional);
+    return checkResponse(httpCode);
+}
+
+bool HomeAssistantController::isDegraded() {
+    return ApiService::getInstance().getCircuitState(m_serverUrl) != CircuitState::CLOSED;
+}
+
+uint32_t HomeAssistantController::getRetryDelay() {
+    return ApiService::getInstance().getCircuitRetryDelay(m_serverUrl);
+}
+
+bool HomeAssistantController::checkResponse(int httpCode) {
+    m_lastHttpCode = httpCode;
+
+    if (httpCode == API_ERROR_CIRCUIT_OPEN) {
+        return false;  // Backed off; nothing was sent
     }
 
     if (httpCode > 0) {
-        if (httpCode == HTTP_CODE_OK || httpCode == HTTP_CODE_CREATED) {
-            response = http.getString();
-            http.end();
+        if (httpCode == HTTP_CODE_OK || httpCode == HTTP_CODE_CREATED || httpCode == HTTP_CODE_NOT_MODIFIED) {
             return true;
+        } else if (httpCode == HTTP_CODE_UNAUTHORIZED) {
+            // A bad token won't fix itself; stop hammering the server with it
+            DEBUG_PRINTLN("[HomeAssistantController] Unauthorized - check access token");
+            ApiService::getInstance().reportFailure(m_serverUrl);
         } else {
             DEBUG_PRINTF("[HomeAssistantController] HTTP error: %d\n", httpCode);
         }
     } else {
-        DEBUG_PRINTF("[HomeAssistantController] Request failed: %s\n", http.errorToString(httpCode).c_str());
+        DEBUG_PRINTF("[HomeAssistantController] Request failed: %s\n", HTTPClient::errorToString(httpCode).c_str());
     }
 
-    http.end();
     return false;
 }
 
-void HomeAssistantController::parseDevices(const String& jsonResponse) {
-    DynamicJsonDocument doc(8192);
-    DeserializationError error = deserializeJson(doc, jsonResponse);
+bool HomeAssistantController::handleStatesStream(Stream& body, void* context) {
+    HomeAssistantController* self = static_cast<HomeAssistantController*>(context);
+
+    // Only the fields the views render; everything else is skipped while parsing
+    DynamicJsonDocument filter(512);
+    filter["entity_id"] = true;
+    filter["state"] = true;
+    buildEntityFilter(filter.createNestedObject("attributes"));
+
+    // Entities are updated in place; only the ones missing from a complete
+    // listing (or no longer subscribed) are dropped afterwards
+    memset(&self->m_syncStats, 0, sizeof(self->m_syncStats));
+    self->m_entities.beginSweep();
+    int entities = JsonStreamReader::forEachArrayElement(body, nullptr, filter, HA_ENTITY_DOC_SIZE,
+                                                         handleStateEntity, self);
+    if (entities < 0) {
+        DEBUG_PRINTLN("[HomeAssistantController] States stream aborted, keeping previous entities");
+        return false;
+    }
 
-    if (error) {
-        DEBUG_PRINTF("[HomeAssistantController] JSON parse error: %s\n", error.c_str());
-        return;
+    HomeAssistantSyncStats& stats = self->m_syncStats;
+    stats.received = (uint16_t)entities;
+    // Without area members an area subscription matches nothing; a failed
+    // template render must not wipe those entities
+    if (self->m_subscription.needsAreaResolve()) {
+        stats.removed = 0;
+    } else {
+        stats.removed = (uint16_t)self->m_entities.endSweep();
     }
+    DEBUG_PRINTF("[HomeAssistantController] Streamed %u entities: %u changed, %u unchanged, %u not subscribed, %u removed\n",
+                 stats.received, stats.changed, stats.unchanged, stats.skipped, stats.removed);
+
+    StringPool& strings = HomeAssistantString::pool();
+    DEBUG_PRINTF("[HomeAssistantController] Entity memory: %u B store (%u B/record), %u/%u B strings (%u distinct, %u refused)\n",
+                 (unsigned)self->m_entities.getFootprint(), (unsigned)sizeof(HomeAssistantDevice),
+                 (unsigned)strings.getArenaUsed(), (unsigned)strings.getArenaSize(),
+                 strings.getStringCount(), (unsigned)strings.getOverflowCount());
+    return true;
+}
 
-    // Reset device count
-    m_deviceCount = 0;
+bool HomeAssistantController::handleServiceResponse(Stream& body, void* context) {
+    DynamicJsonDocument filter(512);
+    filter["entity_id"] = true;
+    filter["state"] = true;
+    buildEntityFilter(filter.createNestedObject("attributes"));
 
-    // Parse states array
-    JsonArray states = doc.as<JsonArray>();
-    for (JsonObject state : states) {
-        if (m_deviceCount >= m_maxDevices) {
-            DEBUG_PRINTLN("[HomeAssistantController] Device buffer full");
-            break;
+    // Array of states changed by the call (empty if nothing changed)
+    return JsonStreamReader::forEachArrayElement(body, nullptr, filter, HA_ENTITY_DOC_SIZE,
+                                                 handleChangedState, context) >= 0;
+}
+
+bool HomeAssistantController::handleChangedState(JsonObject state, void* context) {
+    HomeAssistantController* self = static_cast<HomeAssistantController*>(context);
+    self->updateDeviceState(state["entity_id"].as<String>(), state["state"].as<String>(), state["attributes"]);
+    return true;
+}
+
+bool HomeAssistantController::handleStateEntity(JsonObject state, void* context) {
+    HomeAssistantController* self = static_cast<HomeAssistantController*>(context);
+
+    // Checked on the parsed text, before the id is copied or a slot is taken.
+    // While area members are unknown, entities already held stay current.
+    const char* id = state["entity_id"] | "";
+    if (!self->m_subscription.matches(id) &&
+        !(self->m_subscription.needsAreaResolve() && self->m_entities.find(String(id)))) {
+        self->m_syncStats.skipped++;
+        return true;
+    }
+
+    String entityId = state["entity_id"].as<String>();
+    HomeAssistantDevice* device = self->m_entities.findOrInsert(entityId, self->getDeviceTypeFromEntityId(entityId));
+    if (!device) {
+        // Keep streaming: entities already stored still get their new state
+        if (!self->m_entitiesFullLogged) {
+            DEBUG_PRINTF("[HomeAssistantController] Entity store full (%d), skipping new entities\n",
+                         self->m_entities.capacity());
+            self->m_entitiesFullLogged = true;
         }
+        return true;
+    }
 
-        String entityId = state["entity_id"].as<String>();
-        String stateStr = state["state"].as<String>();
-        JsonObject attributes = state["attributes"];
+    if (self->applyState(*device, state["state"].as<String>(), state["attributes"])) {
+        self->m_syncStats.changed++;
+    } else {
+        self->m_syncStats.unchanged++;
+    }
+    return true;
+}
 
-        // Create device
-        HomeAssistantDevice& device = m_devices[m_deviceCount];
-        device.entityId = entityId;
-        device.friendlyName = attributes["friendly_name"].as<String>();
-        device.state = (stateStr == "on") ? HomeAssistantDeviceState::ON : 
-                      (stateStr == "off") ? HomeAssistantDeviceState::OFF :
-                      (stateStr == "unavailable") ? HomeAssistantDeviceState::UNAVAILABLE :
-                      HomeAssistantDeviceState::UNKNOWN;
-        device.type = getDeviceTypeFromEntityId(entityId);
-        
-        // Parse type-specific attributes
-        if (device.type == HomeAssistantDeviceType::LIGHT) {
-            device.brightness = attributes["brightness"].as<uint8_t>();
-            device.hasColor = attributes.containsKey("rgb_color");
-            device.hasColorTemp = attributes.containsKey("color_temp");
+bool HomeAssistantController::applyState(HomeAssistantDevice& device, const String& stateStr, JsonObject attributes) {
+    // Same state and attributes as last applied: leave the record (and any
+    // optimistic patch on it) alone
+    if (!m_entities.updateStateHash(device, hashState(stateStr, attributes))) {
+        return false;
+    }
+
+    parseDevice(device, stateStr, attributes);
+
+    // Server state may predate commands still in the journal; the record then
+    // differs from what was hashed, so the next server state is applied in full
+    if (reapplyPendingOperations(device)) {
+        m_entities.invalidateStateHash(device);
+    }
+
+    publishChange(device);
+    return true;
+}
+
+static uint32_t hashBytes(uint32_t hash, const void* data, size_t length) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < length; i++) {
+        hash ^= bytes[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static uint32_t hashValue(uint32_t hash, JsonVariantConst value) {
+    // Type tag first, so "1", 1 and true hash differently
+    if (value.is<JsonObjectConst>()) {
+        hash = hashBytes(hash, "{", 1);
+        for (JsonPairConst member : value.as<JsonObjectConst>()) {
+            const char* key = member.key().c_str();
+            hash = hashBytes(hash, key, strlen(key) + 1);
+            hash = hashValue(hash, member.value());
         }
+    } else if (value.is<JsonArrayConst>()) {
+        hash = hashBytes(hash, "[", 1);
+        for (JsonVariantConst element : value.as<JsonArrayConst>()) {
+            hash = hashValue(hash, element);
+        }
+    } else if (value.is<const char*>()) {
+        const char* text = value.as<const char*>();
+        hash = hashBytes(hash, "s", 1);
+        hash = hashBytes(hash, text, strlen(text) + 1);
+    } else if (value.is<bool>()) {
+        hash = hashBytes(hash, value.as<bool>() ? "T" : "F", 1);
+    } else if (value.is<long>()) {
+        long number = value.as<long>();
+        hash = hashBytes(hash, "i", 1);
+        hash = hashBytes(hash, &number, sizeof(number));
+    } else if (value.is<double>()) {
+        double number = value.as<double>();
+        hash = hashBytes(hash, "d", 1);
+        hash = hashBytes(hash, &number, sizeof(number));
+    } else {
+        hash = hashBytes(hash, "n", 1);
+    }
+    return hash;
+}
+
+uint32_t HomeAssistantController::hashState(const String& stateStr, JsonObjectConst attributes) {
+    // Attributes are already cut down to the rendered ones by the parse filter
+    uint32_t hash = hashBytes(2166136261u, stateStr.c_str(), stateStr.length() + 1);
+    hash = hashValue(hash, attributes);
+    return hash != 0 ? hash : 1;
+}
+
+void HomeAssistantController::parseDevice(HomeAssistantDevice& device, const String& stateStr, JsonObject attributes) {
+    device.setFriendlyName(attributes["friendly_name"].as<String>());
+    device.state = (stateStr == "on") ? HomeAssistantDeviceState::ON : 
+                  (stateStr == "off") ? HomeAssistantDeviceState::OFF :
+                  (stateStr == "unavailable") ? HomeAssistantDeviceState::UNAVAILABLE :
+                  HomeAssistantDeviceState::UNKNOWN;
+
+    // Parse type-specific attributes
+    switch (device.type) {
+        case HomeAssistantDeviceType::LIGHT:
+            device.setBrightness(attributes["brightness"].as<uint8_t>());
+            if (attributes.containsKey("rgb_color")) {
+                device.setColor(attributes["rgb_color"][0].as<uint8_t>(),
+                                attributes["rgb_color"][1].as<uint8_t>(),
+                                attributes["rgb_color"][2].as<uint8_t>());
+            } else {
+                device.clearColor();
+            }
+            if (attributes.containsKey("color_temp")) {
+                device.setColorTemp(attributes["color_temp"].as<uint16_t>());
+            } else {
+                device.clearColorTemp();
+            }
+            break;
+
+        case HomeAssistantDeviceType::CLIMATE:
+            device.setTemperature(attributes["current_temperature"].as<float>());
+            device.setTargetTemperature(attributes["temperature"].as<float>());
+            device.setHvacMode(stateStr);
+            break;
 
-        m_deviceCount++;
+        case HomeAssistantDeviceType::MEDIA_PLAYER:
+            device.setMediaTitle(attributes["media_title"].as<String>());
+            device.setMediaArtist(attributes["media_artist"].as<String>());
+            device.setVolume(attributes["volume_level"].as<float>());
+            break;
+
+        case HomeAssistantDeviceType::SENSOR:
+            device.setSensorValue(stateStr);
+            device.setUnit(attributes["unit_of_measurement"].as<String>());
+            break;
+
+        default:
+            break;
     }
 }
 
 void HomeAssistantController::updateDeviceState(const String& entityId, const String& state, const JsonObject& attributes) {
-    HomeAssistantDevice* device = getDevice(entityId);
-    if (device) {
-        device->state = (state == "on") ? HomeAssistantDeviceState::ON : 
-                       (state == "off") ? HomeAssistantDeviceState::OFF :
-                       HomeAssistantDeviceState::UNKNOWN;
-        
-        if (device->type == HomeAssistantDeviceType::LIGHT) {
-            device->brightness = attributes["brightness"].as<uint8_t>();
+    // Events may cover more than the subscription (domains are filtered here)
+    if (!m_subscription.matches(entityId.c_str())) {
+        return;
+    }
+
+    // Entities created since the last full sync are added on the fly
+    HomeAssistantDevice* device = m_entities.findOrInsert(entityId, getDeviceTypeFromEntityId(entityId));
+    if (!device) {
+        return;
+    }
+
+    applyState(*device, state, attributes);
+}
+
+void HomeAssistantController::buildEntityFilter(JsonObject attributes) {
+    // Only the attributes the views render
+    attributes["friendly_name"] = true;
+    attributes["brightness"] = true;
+    attributes["rgb_color"] = true;
+    attributes["color_temp"] = true;
+    attributes["current_temperature"] = true;
+    attributes["temperature"] = true;
+    attributes["media_title"] = true;
+    attributes["media_artist"] = true;
+    attributes["volume_level"] = true;
+    attributes["unit_of_measurement"] = true;
+}
+
+void HomeAssistantController::startSocket() {
+#if HA_WEBSOCKET_ENABLED
+    stopSocket();
+
+    bool secure;
+    String host;
+    uint16_t port;
+    if (!ApiService::parseUrl(m_serverUrl, secure, host, port)) {
+        DEBUG_PRINTLN("[HomeAssistantController] Invalid server URL, WebSocket disabled");
+        return;
+    }
+
+    // First attempt on the next update()
+    m_socketState = HomeAssistantSocketState::DISCONNECTED;
+    m_socketBackoff = HA_WS_RETRY_MIN_MS;
+    m_socketRetryAt = millis();
+#endif
+}
+
+bool HomeAssistantController::openSocket() {
+    bool secure;
+    String host;
+    uint16_t port;
+    if (!ApiService::parseUrl(m_serverUrl, secure, host, port)) {
+        stopSocket();
+        return false;
+    }
+
+    DEBUG_PRINTF("[HomeAssistantController] WebSocket: %s://%s:%d%s\n",
+                 secure ? "wss" : "ws", host.c_str(), port, HA_WS_PATH);
+
+    if (secure) {
+        m_socket.beginSSL(host.c_str(), port, HA_WS_PATH);
+    } else {
+        m_socket.begin(host.c_str(), port, HA_WS_PATH);
+    }
+    m_socket.onEvent(onSocketEvent);
+    // At most one library connect per attempt: the timeout in update() ends
+    // the attempt before this interval would start another
+    m_socket.setReconnectInterval(HA_WS_CONNECT_TIMEOUT_MS);
+    m_socket.enableHeartbeat(HA_WS_HEARTBEAT_MS, HA_WS_HEARTBEAT_MS / 3, 2);
+
+    m_socketState = HomeAssistantSocketState::CONNECTING;
+    m_socketStateSince = millis();
+    return true;
+}
+
+void HomeAssistantController::stopSocket() {
+    if (m_socketState == HomeAssistantSocketState::DISABLED) {
+        return;
+    }
+
+    // Set first: disconnect() reports back through onSocketEvent
+    HomeAssistantSocketState previous = m_socketState;
+    m_socketState = HomeAssistantSocketState::DISABLED;
+    if (previous != HomeAssistantSocketState::DISCONNECTED) {
+        m_socket.disconnect();
+    }
+}
+
+void HomeAssistantController::scheduleSocketRetry() {
+    m_socketState = HomeAssistantSocketState::DISCONNECTED;
+    m_socketRetryAt = millis() + m_socketBackoff;
+    DEBUG_PRINTF("[HomeAssistantController] WebSocket retry in %lu ms\n", (unsigned long)m_socketBackoff);
+
+    m_socketBackoff *= 2;
+    if (m_socketBackoff > HA_WS_RETRY_MAX_MS) {
+        m_socketBackoff = HA_WS_RETRY_MAX_MS;
+    }
+}
+
+void HomeAssistantController::sendSocketMessage(JsonDocument& doc) {
+    String message;
+    serializeJson(doc, message);
+    m_socket.sendTXT(message);
+}
+
+void HomeAssistantController::subscribeSocket() {
+    // Replacing a live subscription: stop the old one first
+    if (m_socketState == HomeAssistantSocketState::LIVE && m_subscribeId != 0) {
+        DynamicJsonDocument unsubscribe(128);
+        unsubscribe["id"] = ++m_socketMessageId;
+        unsubscribe["type"] = "unsubscribe_events";
+        unsubscribe["subscription"] = m_subscribeId;
+        sendSocketMessage(unsubscribe);
+    }
+
+    m_subscribeId = ++m_socketMessageId;
+    m_socketState = HomeAssistantSocketState::SUBSCRIBING;
+    m_socketStateSince = millis();
+    m_serverFiltered = m_subscription.canFilterOnServer();
+
+    if (m_serverFiltered) {
+        // A state trigger without from/to fires on every state and attribute
+        // change of the listed entities, so the server sends only those
+        int count = m_subscription.getEntityCount();
+        DynamicJsonDocument subscribe(256 + 64 * count);
+        subscribe["id"] = m_subscribeId;
+        subscribe["type"] = "subscribe_trigger";
+        JsonObject trigger = subscribe.createNestedObject("trigger");
+        trigger["platform"] = "state";
+        JsonArray entityIds = trigger.createNestedArray("entity_id");
+        for (int i = 0; i < count; i++) {
+            entityIds.add(m_subscription.getEntity(i));
+        }
+        sendSocketMessage(subscribe);
+    } else {
+        DynamicJsonDocument subscribe(128);
+        subscribe["id"] = m_subscribeId;
+        subscribe["type"] = "subscribe_events";
+        subscribe["event_type"] = "state_changed";
+        sendSocketMessage(subscribe);
+    }
+}
+
+void HomeAssistantController::onSocketEvent(WStype_t type, uint8_t* payload, size_t length) {
+    HomeAssistantController& self = getInstance();
+
+    switch (type) {
+        case WStype_CONNECTED:
+            DEBUG_PRINTLN("[HomeAssistantController] WebSocket connected");
+            self.m_socketMessageId = 0;
+            self.m_socketState = HomeAssistantSocketState::AUTHENTICATING;
+            self.m_socketStateSince = millis();
+            break;
+
+        case WStype_DISCONNECTED:
+            // Only unexpected drops need a retry; stop/timeout paths update the state themselves
+            if (self.m_socketState != HomeAssistantSocketState::DISABLED &&
+                self.m_socketState != HomeAssistantSocketState::DISCONNECTED) {
+                DEBUG_PRINTLN("[HomeAssistantController] WebSocket disconnected, polling until reconnected");
+                self.scheduleSocketRetry();
+            }
+            break;
+
+        case WStype_TEXT:
+            self.handleSocketMessage(payload, length);
+            break;
+
+        default:
+            break;
+    }
+}
+
+void HomeAssistantController::handleSocketMessage(const uint8_t* payload, size_t length) {
+    DynamicJsonDocument filter(1024);
+    filter["type"] = true;
+    filter["id"] = true;
+    filter["success"] = true;
+    filter["message"] = true;
+    filter["event"]["data"]["entity_id"] = true;
+    JsonObject newState = filter["event"]["data"].createNestedObject("new_state");
+    newState["state"] = true;
+    buildEntityFilter(newState.createNestedObject("attributes"));
+    filter["event"]["variables"]["trigger"]["entity_id"] = true;
+    JsonObject toState = filter["event"]["variables"]["trigger"].createNestedObject("to_state");
+    toState["state"] = true;
+    buildEntityFilter(toState.createNestedObject("attributes"));
+
+    DynamicJsonDocument doc(HA_EVENT_DOC_SIZE);
+    DeserializationError error = deserializeJson(doc, payload, length, DeserializationOption::Filter(filter));
+    if (error) {
+        DEBUG_PRINTF("[HomeAssistantController] WebSocket JSON parse error: %s\n", error.c_str());
+        return;
+    }
+
+    const char* type = doc["type"] | "";
+
+    if (strcmp(type, "event") == 0) {
+        // state_changed events carry event.data.new_state, trigger events
+        // event.variables.trigger.to_state
+        JsonObject trigger = doc["event"]["variables"]["trigger"];
+        bool fromTrigger = !trigger.isNull();
+        JsonObject data = fromTrigger ? trigger : doc["event"]["data"].as<JsonObject>();
+        JsonObject state = data[fromTrigger ? "to_state" : "new_state"];
+        if (!state.isNull()) {
+            updateDeviceState(data["entity_id"].as<String>(), state["state"].as<String>(), state["attributes"]);
+        } else {
+            // null when the entity was removed
+            m_entities.remove(data["entity_id"].as<String>());
+        }
+    } else if (strcmp(type, "auth_required") == 0) {
+        DynamicJsonDocument auth(512);
+        auth["type"] = "auth";
+        auth["access_token"] = m_accessToken;
+        sendSocketMessage(auth);
+    } else if (strcmp(type, "auth_ok") == 0) {
+        DEBUG_PRINTLN("[HomeAssistantController] WebSocket authenticated, subscribing...");
+        subscribeSocket();
+    } else if (strcmp(type, "auth_invalid") == 0) {
+        // Reconnecting won't help; stay on REST polling
+        DEBUG_PRINTF("[HomeAssistantController] WebSocket auth rejected: %s\n", doc["message"] | "");
+        stopSocket();
+    } else if (strcmp(type, "result") == 0 && doc["id"].as<uint32_t>() == m_subscribeId) {
+        if (doc["success"].as<bool>()) {
+            if (m_serverFiltered) {
+                DEBUG_PRINTF("[HomeAssistantController] Subscribed to %d entities\n", m_subscription.getEntityCount());
+            } else {
+                DEBUG_PRINTLN("[HomeAssistantController] Subscribed to state_changed events");
+            }
+            m_socketState = HomeAssistantSocketState::LIVE;
+            m_socketBackoff = HA_WS_RETRY_MIN_MS;
+            m_resyncPending = true;
+        } else {
+            DEBUG_PRINTLN("[HomeAssistantController] Subscription rejected, falling back to polling");
+            stopSocket();
         }
     }
 }
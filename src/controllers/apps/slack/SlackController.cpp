@@ -4,14 +4,16 @@
  */
 
 #include "controllers/apps/slack/SlackController.h"
+#include "utils/JsonStreamReader.h"
 
 // Slack API constants
 static const char* SLACK_API_BASE = "https://slack.com/api";
 static const char* ENDPOINT_AUTH_TEST = "/auth.test";
 static const char* ENDPOINT_CONVERSATIONS_LIST = "/conversations.list";
 static const char* ENDPOINT_CONVERSATIONS_HISTORY = "/conversations.history";
-static const char* ENDPOINT_USERS_INFO = "/users.info";
+static const char* ENDPOINT_USERS_LIST = "/users.list";
 static const char* ENDPOINT_POST_MESSAGE = "/chat.postMessage";
+static const char* ENDPOINT_CONNECTIONS_OPEN = "/apps.connections.open";
 
 SlackController& SlackController::getInstance() {
     static SlackController instance;
@@ -20,26 +22,39 @@ SlackController& SlackController::getInstance() {
 
 SlackController::SlackController()
     : m_token("")
+    , m_appToken("")
+    , m_apiBase(SLACK_API_BASE)
     , m_workspaceName("")
     , m_userDisplayName("")
     , m_userId("")
     , m_authenticated(false)
     , m_initialized(false)
-    , m_notifications(nullptr)
-    , m_notificationCount(0)
-    , m_maxNotifications(10)
     , m_unreadCount(0)
-    , m_lastPollTime(0)
-    , m_pollInterval(30000) {  // Poll every 30 seconds
+    , m_cursorsDirty(false)
+    , m_syncIndex(-1)
+    , m_syncUnreadBefore(0)
+    , m_duplicateCount(0)
+    , m_directoryDirty(false)
+    , m_directoryRefreshing(false)
+    , m_directoryRefreshedAt(0)
+    , m_directoryNextRefresh(0)
+    , m_pollSchedule("/app/slack", 30000, 10000, 300000)
+    , m_socketState(SlackSocketState::DISABLED)
+    , m_socketStateSince(0)
+    , m_socketRetryAt(0)
+    , m_socketBackoff(SLACK_SOCKET_RETRY_MIN_MS) {
     
-    // Allocate notification buffer
-    m_notifications = new SlackNotification[m_maxNotifications];
+    if (!m_notifications.allocate(SLACK_NOTIFICATION_CAPACITY)) {
+        DEBUG_PRINTLN("[SlackController] Out of memory for notification buffer");
+    }
+
+    for (int i = 0; i < SLACK_SYNC_MAX_CHANNELS; i++) {
+        m_cursors[i].seen = false;
+    }
 }
 
 SlackController::~SlackController() {
-    if (m_notifications) {
-        delete[] m_notifications;
-    }
+    stopSocket();
 }
 
 bool SlackController::init() {
@@ -52,6 +67,18 @@ bool SlackController::init() {
     // Load token from database
     User* currentUser = AuthService::getInstance().getCurrentUser();
     if (currentUser) {
+        String apiBase = DatabaseService::getInstance().getSetting(currentUser->getId(), "slack_api_base", "");
+        if (apiBase.length() > 0) {
+            m_apiBase = apiBase;
+            DEBUG_PRINTF("[SlackController] Using API base: %s\n", m_apiBase.c_str());
+        }
+
+        m_appToken = DatabaseService::getInstance().getToken(currentUser->getId(), "slack-app");
+
+        // Resume history sync where the last session left off
+        loadSyncCursors();
+        loadDirectory();
+
         String token = DatabaseService::getInstance().getToken(currentUser->getId(), "slack");
         if (token.length() > 0) {
             DEBUG_PRINTLN("[SlackController] Found saved token");
@@ -72,14 +99,49 @@ void SlackController::update() {
         return;
     }
 
-    // Check if it's time to poll
     uint32_t currentTime = millis();
-    if (currentTime - m_lastPollTime >= m_pollInterval) {
-        m_lastPollTime = currentTime;
+
+    // Names are refreshed in bulk, also while Socket Mode is live
+    if (!m_directoryRefreshing && (int32_t)(currentTime - m_directoryNextRefresh) >= 0) {
+        m_directoryRefreshing = true;
+        m_directoryCursor = "";
+        RequestScheduler::getInstance().submit(RequestPriority::BACKGROUND, runRefreshDirectory, this,
+                                               "slack-directory");
+    }
+
+    if (m_socketState != SlackSocketState::DISABLED) {
+        if (m_socketState == SlackSocketState::DISCONNECTED) {
+            if ((int32_t)(currentTime - m_socketRetryAt) >= 0) {
+                openSocket();
+            }
+        } else {
+            m_socket.loop();
+
+            if (m_socketState == SlackSocketState::CONNECTING &&
+                millis() - m_socketStateSince >= SLACK_SOCKET_CONNECT_TIMEOUT_MS) {
+                DEBUG_PRINTLN("[SlackController] Socket Mode connect timed out");
+                m_socketState = SlackSocketState::DISCONNECTED;
+                m_socket.disconnect();
+                scheduleSocketRetry();
+            }
+        }
+
+        // Events are pushed while live; poll only as a fallback
+        if (m_socketState == SlackSocketState::LIVE) {
+            return;
+        }
+    }
+
+    // Check if it's time to poll
+    if (m_pollSchedule.isDue()) {
+        m_pollSchedule.start();
         
-        // Fetch latest messages/notifications
+        // Fetch latest messages/notifications (dropped if still queued at the next poll)
         DEBUG_PRINTLN("[SlackController] Polling for updates...");
-        fetchConversations();
+        RequestPriority priority = m_pollSchedule.isVisible() ? RequestPriority::VISIBLE
+                                                              : RequestPriority::BACKGROUND;
+        RequestScheduler::getInstance().submit(priority, runFetchConversations, this,
+                                               "slack-conversations", m_pollSchedule.getInterval());
     }
 }
 
@@ -97,6 +159,34 @@ String SlackController::getToken() {
     return m_token;
 }
 
+void SlackController::setAppToken(const String& token) {
+    m_appToken = token;
+
+    User* currentUser = AuthService::getInstance().getCurrentUser();
+    if (currentUser) {
+        DatabaseService::getInstance().saveToken(currentUser->getId(), "slack-app", token, "app_token");
+    }
+
+    if (m_authenticated) {
+        stopSocket();
+#if SLACK_SOCKET_MODE_ENABLED
+        if (m_appToken.length() > 0) {
+            m_socketState = SlackSocketState::DISCONNECTED;
+            m_socketRetryAt = millis();
+        }
+#endif
+    }
+}
+
+void SlackController::setApiBase(const String& apiBase) {
+    m_apiBase = apiBase;
+
+    User* currentUser = AuthService::getInstance().getCurrentUser();
+    if (currentUser) {
+        DatabaseService::getInstance().saveSetting(currentUser->getId(), "slack_api_base", apiBase);
+    }
+}
+
 bool SlackController::authenticate() {
     if (m_token.length() == 0) {
         DEBUG_PRINTLN("[SlackController] ERROR: No token set");
@@ -129,6 +219,7 @@ bool SlackController::authenticate() {
 
     if (!doc["ok"].as<bool>()) {
         DEBUG_PRINTF("[SlackController] API error: %s\n", doc["error"].as<const char*>());
+        handleApiError(doc["error"].as<String>());
         m_authenticated = false;
         return false;
     }
@@ -143,6 +234,16 @@ bool SlackController::authenticate() {
     DEBUG_PRINTF("[SlackController] User: %s, Workspace: %s\n", 
                  m_userDisplayName.c_str(), m_workspaceName.c_str());
 
+#if SLACK_SOCKET_MODE_ENABLED
+    // Socket Mode needs a separate app-level token; without one we keep polling
+    stopSocket();
+    if (m_appToken.length() > 0) {
+        m_socketState = SlackSocketState::DISCONNECTED;
+        m_socketBackoff = SLACK_SOCKET_RETRY_MIN_MS;
+        m_socketRetryAt = millis();
+    }
+#endif
+
     return true;
 }
 
@@ -154,11 +255,26 @@ int SlackController::getUnreadCount() {
     return m_unreadCount;
 }
 
-SlackNotification* SlackController::getLatestNotification() {
-    if (m_notificationCount > 0) {
-        return &m_notifications[0];
+const SlackNotification* SlackController::getLatestNotification() const {
+    return getNotification(0);
+}
+
+const SlackNotification* SlackController::getNotification(int index) const {
+    if (index < 0 || index >= m_notifications.size()) {
+        return nullptr;
     }
-    return nullptr;
+    return &m_notifications.at(index);
+}
+
+SlackNotificationHandle SlackController::getNotificationHandle(int index) const {
+    if (index < 0) {
+        return RingBuffer<SlackNotification>::INVALID_HANDLE;
+    }
+    return m_notifications.handleAt(index);
+}
+
+const SlackNotification* SlackController::findNotification(SlackNotificationHandle handle) const {
+    return m_notifications.get(handle);
 }
 
 int SlackController::getNotifications(SlackNotification* notifications, int maxNotifications) {
@@ -166,27 +282,33 @@ int SlackController::getNotifications(SlackNotification* notifications, int maxN
         return 0;
     }
 
-    int count = (m_notificationCount < maxNotifications) ? m_notificationCount : maxNotifications;
-    
+    int count = min(getNotificationCount(), maxNotifications);
     for (int i = 0; i < count; i++) {
-        notifications[i] = m_notifications[i];
+        notifications[i] = m_notifications.at(i);
     }
 
     return count;
 }
 
 void SlackController::clearNotifications() {
-    m_notificationCount = 0;
+    m_notifications.clear();
     m_unreadCount = 0;
     DEBUG_PRINTLN("[SlackController] Notifications cleared");
 }
 
+void SlackController::markAsRead(SlackNotificationHandle handle) {
+    SlackNotification* notification = m_notifications.get(handle);
+    if (notification && !notification->isRead) {
+        notification->isRead = true;
+        m_unreadCount--;
+        DEBUG_PRINTF("[SlackController] Marked notification as read: %s\n", notification->id.c_str());
+    }
+}
+
 void SlackController::markAsRead(const String& notificationId) {
-    for (int i = 0; i < m_notificationCount; i++) {
-        if (m_notifications[i].id == notificationId && !m_notifications[i].isRead) {
-            m_notifications[i].isRead = true;
-            m_unreadCount--;
-            DEBUG_PRINTF("[SlackController] Marked notification as read: %s\n", notificationId.c_str());
+    for (uint16_t i = 0; i < m_notifications.size(); i++) {
+        if (m_notifications.at(i).id == notificationId) {
+            markAsRead(m_notifications.handleAt(i));
             break;
         }
     }
@@ -208,15 +330,11 @@ bool SlackController::fetchConversations() {
 
     DEBUG_PRINTLN("[SlackController] Fetching conversations...");
 
-    String response;
-    if (!makeAPIRequest(ENDPOINT_CONVERSATIONS_LIST, "GET", "", response)) {
+    if (!makeStreamRequest(ENDPOINT_CONVERSATIONS_LIST, "GET", "", handleConversationsStream, this, true)) {
         DEBUG_PRINTLN("[SlackController] Failed to fetch conversations");
         return false;
     }
 
-    // Parse and process conversations
-    parseNotifications(response);
-
     return true;
 }
 
@@ -228,20 +346,61 @@ bool SlackController::fetchMessages(const String& channelId) {
 
     DEBUG_PRINTF("[SlackController] Fetching messages from channel: %s\n", channelId.c_str());
 
-    String endpoint = String(ENDPOINT_CONVERSATIONS_HISTORY) + "?channel=" + channelId + "&limit=10";
-    
-    String response;
-    if (!makeAPIRequest(endpoint, "GET", "", response)) {
-        DEBUG_PRINTLN("[SlackController] Failed to fetch messages");
-        return false;
+    ChannelCursor* cursor = findCursor(channelId, true);
+    String oldest = cursor ? cursor->latestTs : String("");
+
+    m_syncChannel = channelId;
+    m_syncNewestTs = oldest;
+    m_syncNextCursor = "";
+
+    // Without a cursor only the latest few messages matter; with one, page
+    // through everything newer (the oldest bound itself is exclusive)
+    int pages = 0;
+    do {
+        String endpoint = String(ENDPOINT_CONVERSATIONS_HISTORY) + "?channel=" + channelId;
+        if (oldest.length() > 0) {
+            endpoint += "&oldest=" + oldest + "&limit=" + String(SLACK_SYNC_PAGE_LIMIT);
+        } else {
+            endpoint += "&limit=" + String(SLACK_SYNC_INITIAL_LIMIT);
+        }
+        if (m_syncNextCursor.length() > 0) {
+            endpoint += "&cursor=" + m_syncNextCursor;
+            m_syncNextCursor = "";
+        }
+
+        // The cursor only moves after a complete fetch, so a failure retries the
+        // same range next pass; already delivered messages are deduplicated
+        if (!makeStreamRequest(endpoint, "GET", "", handleMessagesStream, this, pages == 0)) {
+            DEBUG_PRINTLN("[SlackController] Failed to fetch messages");
+            return false;
+        }
+        pages++;
+    } while (oldest.length() > 0 && m_syncNextCursor.length() > 0 && pages < SLACK_SYNC_MAX_PAGES);
+
+    if (m_syncNextCursor.length() > 0) {
+        DEBUG_PRINTF("[SlackController] Backlog in %s exceeds %d pages, skipping older messages\n",
+                     channelId.c_str(), SLACK_SYNC_MAX_PAGES);
     }
 
-    // Parse messages and create notifications
-    parseNotifications(response);
+    if (cursor && compareTs(m_syncNewestTs, cursor->latestTs) > 0) {
+        cursor->latestTs = m_syncNewestTs;
+        m_cursorsDirty = true;
+    }
 
     return true;
 }
 
+void SlackController::resetSyncCursors() {
+    for (int i = 0; i < SLACK_SYNC_MAX_CHANNELS; i++) {
+        m_cursors[i].channelId = "";
+        m_cursors[i].latestTs = "";
+        m_cursors[i].seen = false;
+    }
+    m_seenMessages.clear();
+    m_cursorsDirty = true;
+    saveSyncCursors();
+}
+
 bool SlackController::sendMessage(const String& channelId, const String& text) {
     if (!m_authenticated) {
         DEBUG_PRINTLN("[SlackController] Not authenticated");
@@ -274,88 +433,768 @@ bool SlackController::makeAPIRequest(const String& endpoint, const String& metho
         return false;
     }
 
-    HTTPClient http;
-    String url = String(SLACK_API_BASE) + endpoint;
+    String url = m_apiBase + endpoint;
 
     DEBUG_PRINTF("[SlackController] %s %s\n", method.c_str(), url.c_str());
 
-    http.begin(url);
-    http.addHeader("Authorization", "Bearer " + m_token);
-    http.addHeader("Content-Type", "application/json");
+    ApiHeader headers[] = {
+        { "Authorization", "Bearer " + m_token },
+        { "Content-Type", "application/json" }
+    };
 
-    int httpCode;
-    if (method == "POST") {
-        httpCode = http.POST(payload);
-    } else {
-        httpCode = http.GET();
+    int httpCode = ApiService::getInstance().request(method, url, payload, headers, 2, response);
+    return checkResponse(httpCode);
+}
+
+bool SlackController::makeStreamRequest(const String& endpoint, const String& method, const String& payload,
+                                        ApiStreamHandler handler, void* context, bool conditional) {
+    if (!NetworkService::getInstance().isConnected()) {
+        DEBUG_PRINTLN("[SlackController] Not connected to network");
+        return false;
+    }
+
+    String url = m_apiBase + endpoint;
+
+    DEBUG_PRINTF("[SlackController] %s %s (streamed)\n", method.c_str(), url.c_str());
+
+    ApiHeader headers[] = {
+        { "Authorization", "Bearer " + m_token },
+        { "Content-Type", "application/json" }
+    };
+
+    int httpCode = ApiService::getInstance().requestStream(method, url, payload, headers, 2, handler, context, conditional);
+    return checkResponse(httpCode);
+}
+
+bool SlackController::isDegraded() {
+    return ApiService::getInstance().getCircuitState(m_apiBase) != CircuitState::CLOSED;
+}
+
+uint32_t SlackController::getRetryDelay() {
+    return ApiService::getInstance().getCircuitRetryDelay(m_apiBase);
+}
+
+bool SlackController::checkResponse(int httpCode) {
+    if (httpCode == API_ERROR_CIRCUIT_OPEN) {
+        return false;  // Backed off; nothing was sent
     }
 
     if (httpCode > 0) {
-        if (httpCode == HTTP_CODE_OK) {
-            response = http.getString();
-            http.end();
+        // 304: conditional GET, nothing changed and the handler wasn't called
+        if (httpCode == HTTP_CODE_OK || httpCode == HTTP_CODE_NOT_MODIFIED) {
             return true;
         } else {
             DEBUG_PRINTF("[SlackController] HTTP error: %d\n", httpCode);
         }
     } else {
-        DEBUG_PRINTF("[SlackController] Request failed: %s\n", http.errorToString(httpCode).c_str());
+        DEBUG_PRINTF("[SlackController] Request failed: %s\n", HTTPClient::errorToString(httpCode).c_str());
     }
 
-    http.end();
     return false;
 }
 
-void SlackController::parseNotifications(const String& jsonResponse) {
-    DynamicJsonDocument doc(4096);
-    DeserializationError error = deserializeJson(doc, jsonResponse);
+bool SlackController::readOkFlag(Stream& body, String& error) {
+    // Slack always sends "ok" first, so this doesn't skip anything we need
+    if (!body.find("\"ok\":")) {
+        DEBUG_PRINTLN("[SlackController] Malformed response");
+        return false;
+    }
 
-    if (error) {
-        DEBUG_PRINTF("[SlackController] JSON parse error: %s\n", error.c_str());
+    while (body.peek() == ' ') body.read();
+    if (body.peek() == 't') {
+        return true;
+    }
+
+    error = body.find("\"error\":\"") ? body.readStringUntil('"') : String("unknown");
+    DEBUG_PRINTF("[SlackController] API error: %s\n", error.c_str());
+    return false;
+}
+
+void SlackController::handleApiError(const String& error) {
+    // These arrive as HTTP 200, so the circuit breaker only learns about them
+    // here. Polling an expired token every interval would never succeed.
+    if (error == "invalid_auth" || error == "token_expired" || error == "token_revoked" ||
+        error == "not_authed" || error == "account_inactive" || error == "ratelimited") {
+        ApiService::getInstance().reportFailure(m_apiBase);
+    }
+}
+
+bool SlackController::handleMessagesStream(Stream& body, void* context) {
+    SlackController* self = static_cast<SlackController*>(context);
+
+    String error;
+    if (!readOkFlag(body, error)) {
+        self->handleApiError(error);
+        return false;
+    }
+
+    // Message objects carry blocks, attachments, reactions, ... we only need these
+    DynamicJsonDocument filter(256);
+    filter["ts"] = true;
+    filter["text"] = true;
+    filter["user"] = true;
+    filter["subtype"] = true;
+
+    int messages = JsonStreamReader::forEachArrayElement(body, "messages", filter, SLACK_MESSAGE_DOC_SIZE,
+                                                         handleMessage, self);
+    if (messages < 0) {
+        return false;
+    }
+
+    self->m_syncNextCursor = readNextCursor(body);
+    return true;
+}
+
+String SlackController::readNextCursor(Stream& body) {
+    // response_metadata comes after the list; an empty cursor means no more pages
+    if (!body.find("\"next_cursor\":")) {
+        return String();
+    }
+
+    while (body.peek() == ' ') body.read();
+    if (body.read() != '"') {
+        return String();
+    }
+    return body.readStringUntil('"');
+}
+
+bool SlackController::handleMessage(JsonObject msg, void* context) {
+    SlackController* self = static_cast<SlackController*>(context);
+
+    String ts = msg["ts"].as<String>();
+    if (compareTs(ts, self->m_syncNewestTs) > 0) {
+        self->m_syncNewestTs = ts;
+    }
+
+    // Joins, edits, bot posts and our own messages aren't notifications
+    if (msg.containsKey("subtype") || self->m_userId == (msg["user"] | "")) {
+        return true;
+    }
+
+    if (!self->acceptMessage(self->m_syncChannel, ts)) {
+        return true;
+    }
+
+    // History messages don't repeat the channel; it's the one being synced
+    SlackNotification notification;
+    notification.id = ts;
+    notification.text = msg["text"].as<String>();
+    notification.channelId = self->m_syncChannel;
+    notification.userId = msg["user"].as<String>();
+    notification.timestamp = ts;
+    notification.isRead = false;
+    notification.type = SlackNotificationType::MESSAGE;
+    self->resolveNames(notification);
+
+    self->addNotification(std::move(notification));
+    return true;
+}
+
+bool SlackController::runFetchConversations(void* context) {
+    SlackController* self = static_cast<SlackController*>(context);
+    self->m_syncUnreadBefore = self->m_unreadCount;
+    if (!self->fetchConversations()) {
+        return false;
+    }
+
+    // Then one channel's history per scheduler job, so commands can cut in
+    self->m_syncIndex = 0;
+    RequestPriority priority = self->m_pollSchedule.isVisible() ? RequestPriority::VISIBLE
+                                                                : RequestPriority::BACKGROUND;
+    RequestScheduler::getInstance().submit(priority, runSyncHistory, self, "slack-history");
+    return true;
+}
+
+bool SlackController::runSyncHistory(void* context) {
+    SlackController* self = static_cast<SlackController*>(context);
+    if (self->m_syncIndex < 0) {
+        return true;
+    }
+
+    while (self->m_syncIndex < SLACK_SYNC_MAX_CHANNELS &&
+           self->m_cursors[self->m_syncIndex].channelId.length() == 0) {
+        self->m_syncIndex++;
+    }
+
+    if (self->m_syncIndex >= SLACK_SYNC_MAX_CHANNELS) {
+        self->m_syncIndex = -1;
+        self->saveSyncCursors();
+        self->saveDirectory();
+        self->m_pollSchedule.recordResult(self->m_unreadCount != self->m_syncUnreadBefore);
+        return true;
+    }
+
+    String channelId = self->m_cursors[self->m_syncIndex++].channelId;
+    bool fetched = self->fetchMessages(channelId);
+
+    RequestPriority priority = self->m_pollSchedule.isVisible() ? RequestPriority::VISIBLE
+                                                                : RequestPriority::BACKGROUND;
+    RequestScheduler::getInstance().submit(priority, runSyncHistory, self, "slack-history");
+    return fetched;
+}
+
+bool SlackController::acceptMessage(const String& channelId, const String& ts) {
+    // Already covered by a completed sync (e.g. before a reboot)
+    ChannelCursor* cursor = findCursor(channelId, false);
+    bool duplicate = cursor && compareTs(ts, cursor->latestTs) <= 0;
+
+    // Same message from a poll and a push event, or a retried page
+    uint32_t fingerprint = FingerprintSet<SLACK_SEEN_MESSAGES>::hash(
+        ts.c_str(), ts.length(), FingerprintSet<SLACK_SEEN_MESSAGES>::hash(channelId.c_str(), channelId.length()));
+    if (!m_seenMessages.insert(fingerprint)) {
+        duplicate = true;
+    }
+
+    if (duplicate) {
+        m_duplicateCount++;
+    }
+    return !duplicate;
+}
+
+int SlackController::compareTs(const String& a, const String& b) {
+    // "1700000000.000100": fixed-width seconds, so longer is newer and
+    // equal lengths compare lexically; empty sorts first
+    if (a.length() != b.length()) {
+        return a.length() < b.length() ? -1 : 1;
+    }
+    return strcmp(a.c_str(), b.c_str());
+}
+
+SlackController::ChannelCursor* SlackController::findCursor(const String& channelId, bool create) {
+    ChannelCursor* freeSlot = nullptr;
+    for (int i = 0; i < SLACK_SYNC_MAX_CHANNELS; i++) {
+        if (m_cursors[i].channelId == channelId) {
+            return &m_cursors[i];
+        }
+        if (!freeSlot && m_cursors[i].channelId.length() == 0) {
+            freeSlot = &m_cursors[i];
+        }
+    }
+
+    if (!create || channelId.length() == 0) {
+        return nullptr;
+    }
+
+    if (!freeSlot) {
+        DEBUG_PRINTF("[SlackController] No sync cursor slot for %s\n", channelId.c_str());
+        return nullptr;
+    }
+
+    freeSlot->channelId = channelId;
+    freeSlot->latestTs = "";
+    freeSlot->seen = true;
+    m_cursorsDirty = true;
+    return freeSlot;
+}
+
+void SlackController::loadSyncCursors() {
+    User* currentUser = AuthService::getInstance().getCurrentUser();
+    if (!currentUser) {
         return;
     }
 
-    if (!doc["ok"].as<bool>()) {
-        DEBUG_PRINTF("[SlackController] API error: %s\n", doc["error"].as<const char*>());
+    // "C01ABC=1700000000.000100;D02XYZ=1700000123.000200;"
+    String stored = DatabaseService::getInstance().getSetting(currentUser->getId(), "slack_sync_cursors", "");
+    int slot = 0;
+    int start = 0;
+    while (slot < SLACK_SYNC_MAX_CHANNELS && start < (int)stored.length()) {
+        int end = stored.indexOf(';', start);
+        if (end < 0) end = stored.length();
+
+        int separator = stored.indexOf('=', start);
+        if (separator > start && separator < end) {
+            m_cursors[slot].channelId = stored.substring(start, separator);
+            m_cursors[slot].latestTs = stored.substring(separator + 1, end);
+            m_cursors[slot].seen = false;
+            slot++;
+        }
+        start = end + 1;
+    }
+
+    m_cursorsDirty = false;
+    DEBUG_PRINTF("[SlackController] Loaded %d sync cursors\n", slot);
+}
+
+void SlackController::saveSyncCursors() {
+    if (!m_cursorsDirty) {
         return;
     }
 
-    // Parse different response types (simplified example)
-    // In a real implementation, you would parse specific fields based on the endpoint
-    
-    // Example: Parse messages
-    JsonArray messages = doc["messages"];
-    if (messages) {
-        for (JsonObject msg : messages) {
-            SlackNotification notification;
-            notification.id = msg["ts"].as<String>();
-            notification.text = msg["text"].as<String>();
-            notification.channelId = msg["channel"].as<String>();
-            notification.userId = msg["user"].as<String>();
-            notification.timestamp = msg["ts"].as<String>();
-            notification.isRead = false;
-            notification.type = SlackNotificationType::MESSAGE;
-
-            addNotification(notification);
+    User* currentUser = AuthService::getInstance().getCurrentUser();
+    if (!currentUser) {
+        return;
+    }
+
+    String stored;
+    for (int i = 0; i < SLACK_SYNC_MAX_CHANNELS; i++) {
+        if (m_cursors[i].channelId.length() > 0) {
+            stored += m_cursors[i].channelId + "=" + m_cursors[i].latestTs + ";";
         }
     }
+
+    if (DatabaseService::getInstance().saveSetting(currentUser->getId(), "slack_sync_cursors", stored)) {
+        m_cursorsDirty = false;
+    }
 }
 
-void SlackController::addNotification(const SlackNotification& notification) {
-    // Shift existing notifications down
-    if (m_notificationCount >= m_maxNotifications) {
-        for (int i = m_maxNotifications - 1; i > 0; i--) {
-            m_notifications[i] = m_notifications[i - 1];
+bool SlackController::runRefreshDirectory(void* context) {
+    SlackController* self = static_cast<SlackController*>(context);
+
+    // One users.list page per scheduler job
+    String endpoint = String(ENDPOINT_USERS_LIST) + "?limit=" + String(SLACK_DIRECTORY_PAGE_LIMIT);
+    if (self->m_directoryCursor.length() > 0) {
+        endpoint += "&cursor=" + self->m_directoryCursor;
+    }
+
+    self->m_directoryCursor = "";
+    if (!self->m_authenticated ||
+        !self->makeStreamRequest(endpoint, "GET", "", handleMembersStream, self)) {
+        self->m_directoryRefreshing = false;
+        self->m_directoryNextRefresh = millis() + SLACK_DIRECTORY_MISS_REFRESH_MS;
+        return false;
+    }
+
+    if (self->m_directoryCursor.length() > 0) {
+        RequestScheduler::getInstance().submit(RequestPriority::BACKGROUND, runRefreshDirectory, self,
+                                               "slack-directory");
+        return true;
+    }
+
+    // Channel names come with the conversation list (conditional, usually a 304)
+    self->fetchConversations();
+
+    self->m_directoryRefreshing = false;
+    self->m_directoryRefreshedAt = millis();
+    self->m_directoryNextRefresh = self->m_directoryRefreshedAt + SLACK_DIRECTORY_TTL_MS;
+    self->saveDirectory();
+
+    // Notifications that arrived before their names were known
+    for (uint16_t i = 0; i < self->m_notifications.size(); i++) {
+        self->resolveNames(self->m_notifications.at(i));
+    }
+
+    DEBUG_PRINTF("[SlackController] Directory: %u entries, %u arena bytes\n",
+                 self->m_directory.getEntryCount(), (unsigned)self->m_directory.getArenaUsed());
+    return true;
+}
+
+bool SlackController::handleMembersStream(Stream& body, void* context) {
+    SlackController* self = static_cast<SlackController*>(context);
+
+    String error;
+    if (!readOkFlag(body, error)) {
+        self->handleApiError(error);
+        return false;
+    }
+
+    DynamicJsonDocument filter(128);
+    filter["id"] = true;
+    filter["name"] = true;
+    filter["deleted"] = true;
+    filter["profile"]["display_name"] = true;
+    filter["profile"]["real_name"] = true;
+
+    if (JsonStreamReader::forEachArrayElement(body, "members", filter, 512, handleMember, self) < 0) {
+        return false;
+    }
+
+    self->m_directoryCursor = readNextCursor(body);
+    return true;
+}
+
+bool SlackController::handleMember(JsonObject member, void* context) {
+    SlackController* self = static_cast<SlackController*>(context);
+    if (member["deleted"] | false) {
+        return true;
+    }
+
+    // Same precedence as the Slack client: display name, real name, handle
+    const char* name = member["profile"]["display_name"] | "";
+    if (!name[0]) name = member["profile"]["real_name"] | "";
+    if (!name[0]) name = member["name"] | "";
+
+    const char* id = member["id"] | "";
+    const char* known = self->m_directory.lookup(SlackDirectoryKind::USER, id);
+    if (!known || strcmp(known, name) != 0) {
+        self->m_directory.put(SlackDirectoryKind::USER, id, name);
+        self->m_directoryDirty = true;
+    }
+    return true;
+}
+
+void SlackController::putChannelName(const String& channelId, const String& name) {
+    const char* known = m_directory.lookup(SlackDirectoryKind::CHANNEL, channelId);
+    if (!known || name != known) {
+        m_directory.put(SlackDirectoryKind::CHANNEL, channelId.c_str(), name.c_str());
+        m_directoryDirty = true;
+    }
+}
+
+String SlackController::getUserName(const String& userId) {
+    const char* name = m_directory.lookup(SlackDirectoryKind::USER, userId);
+    return name ? String(name) : String();
+}
+
+String SlackController::getChannelName(const String& channelId) {
+    const char* name = m_directory.lookup(SlackDirectoryKind::CHANNEL, channelId);
+    if (!name) {
+        return String();
+    }
+
+    // DMs are stored as "@<user id>"
+    if (name[0] == '@') {
+        String userName = getUserName(String(name + 1));
+        return userName.length() > 0 ? "@" + userName : String();
+    }
+    return String(name);
+}
+
+void SlackController::resolveNames(SlackNotification& notification) {
+    if (notification.userName.length() == 0 && notification.userId.length() > 0) {
+        notification.userName = getUserName(notification.userId);
+        if (notification.userName.length() == 0) {
+            noteDirectoryMiss();
         }
-        m_notificationCount = m_maxNotifications - 1;
     }
 
-    // Add new notification at the top
-    m_notifications[0] = notification;
-    m_notificationCount++;
+    if (notification.channelName.length() == 0 && notification.channelId.length() > 0) {
+        notification.channelName = getChannelName(notification.channelId);
+        if (notification.channelName.length() == 0) {
+            noteDirectoryMiss();
+        }
+    }
+}
+
+void SlackController::noteDirectoryMiss() {
+    // Someone new: refresh early, but never per message
+    uint32_t earliest = m_directoryRefreshedAt + SLACK_DIRECTORY_MISS_REFRESH_MS;
+    if (m_directoryRefreshedAt != 0 && (int32_t)(earliest - m_directoryNextRefresh) < 0) {
+        m_directoryNextRefresh = earliest;
+    }
+}
+
+void SlackController::loadDirectory() {
+    User* currentUser = AuthService::getInstance().getCurrentUser();
+    if (!currentUser) {
+        return;
+    }
+
+    // Usable straight away; still refreshed once per session (no wall clock for a TTL across boots)
+    String stored = DatabaseService::getInstance().getSetting(currentUser->getId(), "slack_directory", "");
+    int entries = m_directory.deserialize(stored);
+    m_directoryDirty = false;
+    DEBUG_PRINTF("[SlackController] Loaded %d directory entries\n", entries);
+}
+
+void SlackController::saveDirectory() {
+    if (!m_directoryDirty) {
+        return;
+    }
+
+    User* currentUser = AuthService::getInstance().getCurrentUser();
+    if (!currentUser) {
+        return;
+    }
+
+    if (DatabaseService::getInstance().saveSetting(currentUser->getId(), "slack_directory", m_directory.serialize())) {
+        m_directoryDirty = false;
+    }
+}
+
+bool SlackController::handleConversationsStream(Stream& body, void* context) {
+    SlackController* self = static_cast<SlackController*>(context);
+
+    String error;
+    if (!readOkFlag(body, error)) {
+        self->handleApiError(error);
+        return false;
+    }
+
+    DynamicJsonDocument filter(128);
+    filter["id"] = true;
+    filter["name"] = true;
+    filter["user"] = true;
+    filter["is_member"] = true;
+    filter["is_im"] = true;
+
+    for (int i = 0; i < SLACK_SYNC_MAX_CHANNELS; i++) {
+        self->m_cursors[i].seen = false;
+    }
+
+    int channels = JsonStreamReader::forEachArrayElement(body, "channels", filter, 256, handleChannel, context);
+    if (channels < 0) {
+        return false;
+    }
+
+    // Channels we left (or that were archived) stop being synced
+    for (int i = 0; i < SLACK_SYNC_MAX_CHANNELS; i++) {
+        ChannelCursor& cursor = self->m_cursors[i];
+        if (cursor.channelId.length() > 0 && !cursor.seen) {
+            DEBUG_PRINTF("[SlackController] Dropping sync cursor for %s\n", cursor.channelId.c_str());
+            cursor.channelId = "";
+            cursor.latestTs = "";
+            self->m_cursorsDirty = true;
+        }
+    }
+
+    DEBUG_PRINTF("[SlackController] %d conversations\n", channels);
+    return true;
+}
+
+bool SlackController::handleChannel(JsonObject channel, void* context) {
+    SlackController* self = static_cast<SlackController*>(context);
+
+    // Conversations don't produce notifications on their own; the ones we can
+    // read get a sync cursor so their history is polled
+    if (!(channel["is_member"] | false) && !(channel["is_im"] | false)) {
+        return true;
+    }
+
+    // DMs have no name of their own; they're shown as the other user
+    String channelId = channel["id"].as<String>();
+    if (channel["is_im"] | false) {
+        self->putChannelName(channelId, String("@") + (channel["user"] | ""));
+    } else {
+        self->putChannelName(channelId, String("#") + (channel["name"] | ""));
+    }
+
+    ChannelCursor* cursor = self->findCursor(channelId, true);
+    if (cursor) {
+        cursor->seen = true;
+    }
+    return true;
+}
+
+void SlackController::addNotification(SlackNotification&& notification) {
+    // The oldest slot is reused in place; if it was never read it leaves the unread count
+    const SlackNotification* evicted = m_notifications.evictionCandidate();
+    if (evicted && !evicted->isRead) {
+        m_unreadCount--;
+    }
+
+    SlackNotificationHandle handle = m_notifications.push(std::move(notification));
+    if (handle == RingBuffer<SlackNotification>::INVALID_HANDLE) {
+        return;
+    }
     m_unreadCount++;
 
-    DEBUG_PRINTF("[SlackController] New notification: %s\n", notification.text.c_str());
+    DEBUG_PRINTF("[SlackController] New notification: %s\n", m_notifications.get(handle)->text.c_str());
+}
+
+
+
+bool SlackController::openSocket() {
+    DEBUG_PRINTLN("[SlackController] Opening Socket Mode connection...");
+
+    // Every connection needs a fresh single-use URL
+    ApiHeader headers[] = {
+        { "Authorization", "Bearer " + m_appToken },
+        { "Content-Type", "application/x-www-form-urlencoded" }
+    };
+
+    String response;
+    int httpCode = ApiService::getInstance().request("POST", m_apiBase + ENDPOINT_CONNECTIONS_OPEN, "",
+                                                     headers, 2, response);
+    if (!checkResponse(httpCode)) {
+        scheduleSocketRetry();
+        return false;
+    }
+
+    DynamicJsonDocument doc(1024);
+    DeserializationError error = deserializeJson(doc, response);
+    if (error) {
+        DEBUG_PRINTF("[SlackController] JSON parse error: %s\n", error.c_str());
+        scheduleSocketRetry();
+        return false;
+    }
+
+    if (!doc["ok"].as<bool>()) {
+        String apiError = doc["error"].as<String>();
+        DEBUG_PRINTF("[SlackController] apps.connections.open failed: %s\n", apiError.c_str());
+        if (apiError == "invalid_auth" || apiError == "not_allowed_token_type" || apiError == "not_authed") {
+            // Token problem, retrying won't help
+            stopSocket();
+        } else {
+            scheduleSocketRetry();
+        }
+        return false;
+    }
+
+    String url = doc["url"].as<String>();
+    bool secure;
+    String host;
+    uint16_t port;
+    if (!ApiService::parseUrl(url, secure, host, port)) {
+        DEBUG_PRINTF("[SlackController] Invalid socket URL: %s\n", url.c_str());
+        scheduleSocketRetry();
+        return false;
+    }
+
+    int pathStart = url.indexOf('/', url.indexOf("://") + 3);
+    String path = (pathStart < 0) ? String("/") : url.substring(pathStart);
+
+    if (secure) {
+        m_socket.beginSSL(host.c_str(), port, path.c_str());
+    } else {
+        m_socket.begin(host.c_str(), port, path.c_str());
+    }
+    m_socket.onEvent(onSocketEvent);
+    m_socket.enableHeartbeat(SLACK_SOCKET_HEARTBEAT_MS, SLACK_SOCKET_HEARTBEAT_MS / 3, 2);
+
+    m_socketState = SlackSocketState::CONNECTING;
+    m_socketStateSince = millis();
+    return true;
 }
 
+void SlackController::stopSocket() {
+    if (m_socketState == SlackSocketState::DISABLED) {
+        return;
+    }
 
+    // Set first: disconnect() reports back through onSocketEvent
+    SlackSocketState previous = m_socketState;
+    m_socketState = SlackSocketState::DISABLED;
+    if (previous != SlackSocketState::DISCONNECTED) {
+        m_socket.disconnect();
+    }
+}
+
+void SlackController::scheduleSocketRetry() {
+    m_socketState = SlackSocketState::DISCONNECTED;
+    m_socketRetryAt = millis() + m_socketBackoff;
+    DEBUG_PRINTF("[SlackController] Socket Mode retry in %lu ms\n", (unsigned long)m_socketBackoff);
+
+    m_socketBackoff *= 2;
+    if (m_socketBackoff > SLACK_SOCKET_RETRY_MAX_MS) {
+        m_socketBackoff = SLACK_SOCKET_RETRY_MAX_MS;
+    }
+}
+
+void SlackController::onSocketEvent(WStype_t type, uint8_t* payload, size_t length) {
+    SlackController& self = getInstance();
+
+    switch (type) {
+        case WStype_CONNECTED:
+            DEBUG_PRINTLN("[SlackController] Socket Mode connected, waiting for hello");
+            break;
+
+        case WStype_DISCONNECTED:
+            // Only unexpected drops need a retry; stop/refresh paths update the state themselves
+            if (self.m_socketState == SlackSocketState::CONNECTING || self.m_socketState == SlackSocketState::LIVE) {
+                DEBUG_PRINTLN("[SlackController] Socket Mode disconnected, polling until reconnected");
+                self.scheduleSocketRetry();
+            }
+            break;
+
+        case WStype_TEXT:
+            self.handleSocketMessage(payload, length);
+            break;
+
+        default:
+            break;
+    }
+}
+
+void SlackController::handleSocketMessage(const uint8_t* payload, size_t length) {
+    DynamicJsonDocument filter(512);
+    filter["type"] = true;
+    filter["envelope_id"] = true;
+    filter["reason"] = true;
+    JsonObject event = filter["payload"].createNestedObject("event");
+    event["type"] = true;
+    event["subtype"] = true;
+    event["text"] = true;
+    event["user"] = true;
+    event["channel"] = true;
+    event["channel_type"] = true;
+    event["ts"] = true;
+
+    DynamicJsonDocument doc(SLACK_EVENT_DOC_SIZE);
+    DeserializationError error = deserializeJson(doc, payload, length, DeserializationOption::Filter(filter));
+    if (error) {
+        DEBUG_PRINTF("[SlackController] Socket JSON parse error: %s\n", error.c_str());
+        return;
+    }
+
+    // Acknowledge every envelope straight away, or Slack redelivers it
+    const char* envelopeId = doc["envelope_id"];
+    if (envelopeId) {
+        String ack = String("{\"envelope_id\":\"") + envelopeId + "\"}";
+        m_socket.sendTXT(ack);
+    }
+
+    const char* type = doc["type"] | "";
+
+    if (strcmp(type, "events_api") == 0) {
+        handleSocketEvent(doc["payload"]["event"]);
+    } else if (strcmp(type, "hello") == 0) {
+        DEBUG_PRINTLN("[SlackController] Socket Mode live");
+        m_socketState = SlackSocketState::LIVE;
+        m_socketBackoff = SLACK_SOCKET_RETRY_MIN_MS;
+    } else if (strcmp(type, "disconnect") == 0) {
+        const char* reason = doc["reason"] | "";
+        DEBUG_PRINTF("[SlackController] Socket Mode disconnect requested: %s\n", reason);
+        if (strcmp(reason, "link_disabled") == 0) {
+            stopSocket();
+        } else {
+            // Refresh: reconnect on a new URL right away
+            m_socketState = SlackSocketState::DISCONNECTED;
+            m_socketRetryAt = millis();
+            m_socket.disconnect();
+        }
+    }
+}
+
+void SlackController::handleSocketEvent(JsonObject event) {
+    const char* eventType = event["type"] | "";
+    bool isMention = strcmp(eventType, "app_mention") == 0;
+
+    // Plain messages only; edits, joins, bot posts etc. carry a subtype
+    if (!isMention && (strcmp(eventType, "message") != 0 || event.containsKey("subtype"))) {
+        return;
+    }
+
+    // Our own posts aren't notifications (same rule as the history sync)
+    if (m_userId.length() > 0 && m_userId == (event["user"] | "")) {
+        return;
+    }
+
+    String ts = event["ts"].as<String>();
+    String channelId = event["channel"].as<String>();
+
+    // The cursor isn't advanced here: after a socket drop the next poll must
+    // still fetch what was missed, and the fingerprint set absorbs the overlap
+    if (!acceptMessage(channelId, ts)) {
+        // A mention arrives both as message and app_mention
+        if (isMention) {
+            for (uint16_t i = 0; i < m_notifications.size(); i++) {
+                SlackNotification& existing = m_notifications.at(i);
+                if (existing.id == ts) {
+                    existing.isMention = true;
+                    existing.type = SlackNotificationType::MENTION;
+                    break;
+                }
+            }
+        }
+        return;
+    }
+
+    SlackNotification notification;
+    notification.id = ts;
+    notification.text = event["text"].as<String>();
+    notification.channelId = channelId;
+    notification.userId = event["user"].as<String>();
+    notification.timestamp = ts;
+    notification.isRead = false;
+    notification.isMention = isMention;
+    resolveNames(notification);
+    if (isMention) {
+        notification.type = SlackNotificationType::MENTION;
+    } else if (strcmp(event["channel_type"] | "", "im") == 0) {
+        notification.type = SlackNotificationType::DIRECT_MESSAGE;
+    } else {
+        notification.type = SlackNotificationType::MESSAGE;
+    }
+
+    addNotification(std::move(notification));
+}
@@ -13,8 +13,22 @@ SpotifyController& SpotifyController::getInstance() {
 
 SpotifyController::SpotifyController()
     : m_accessToken("")
+    , m_apiBase(DEFAULT_API_BASE)
     , m_lastError("")
-    , m_initialized(false) {
+    , m_initialized(false)
+    , m_nowPlayingReceived(false)
+    , m_lastHttpCode(0)
+    , m_lastUpdateTime(0)
+    , m_lastRtt(0)
+    , m_lastClockDrift(0)
+    , m_clockResyncCount(0)
+    , m_clockDriftDetected(false)
+    , m_verifying(false)
+    , m_verifyAttempts(0)
+    , m_verifyStarted(0)
+    , m_pollSchedule("/app/spotify", SPOTIFY_POLL_INTERVAL_MS, 2000, 30000) {
+    m_volumeCoalescer.setTarget(sendVolume, this);
+    m_seekCoalescer.setTarget(sendSeek, this);
 }
 
 SpotifyController::~SpotifyController() {
@@ -27,6 +41,15 @@ bool SpotifyController::init() {
 
     DEBUG_PRINTLN("[SpotifyController] Initializing...");
 
+    User* currentUser = AuthService::getInstance().getCurrentUser();
+    if (currentUser) {
+        String apiBase = DatabaseService::getInstance().getSetting(currentUser->getId(), "spotify_api_base", "");
+        if (apiBase.length() > 0) {
+            m_apiBase = apiBase;
+            DEBUG_PRINTF("[SpotifyController] Using API base: %s\n", m_apiBase.c_str());
+        }
+    }
+
     // Load access token from database
     loadAccessToken();
 
@@ -41,6 +64,29 @@ bool SpotifyController::init() {
     return true;
 }
 
+void SpotifyController::update() {
+    if (!m_initialized) {
+        return;
+    }
+
+    m_volumeCoalescer.update();
+    m_seekCoalescer.update();
+
+    if (isAuthenticated() && m_pollSchedule.isDue()) {
+        m_pollSchedule.start();
+        requestNowPlaying(m_pollSchedule.getInterval());
+    }
+}
+
+void SpotifyController::setApiBase(const String& apiBase) {
+    m_apiBase = apiBase;
+
+    User* currentUser = AuthService::getInstance().getCurrentUser();
+    if (currentUser) {
+        DatabaseService::getInstance().saveSetting(currentUser->getId(), "spotify_api_base", apiBase);
+    }
+}
+
 void SpotifyController::setAccessToken(const String& token) {
     m_accessToken = token;
     saveAccessToken();
@@ -55,19 +101,146 @@ bool SpotifyController::updateNowPlaying() {
 
     DEBUG_PRINTLN("[SpotifyController] Updating now playing...");
 
-    String response;
-    if (!makeApiRequest(EP_NOW_PLAYING, "GET", "", response)) {
+    // Where the local clock thinks playback is, before the response replaces it
+    String previousId = m_currentTrack.getId();
+    bool wasPlaying = m_currentTrack.isPlaying();
+    int previousPosition = m_currentTrack.getPosition();
+    uint32_t previousSyncedAt = m_currentTrack.getPositionSyncedAt();
+
+    // ApiService skips the handler for a 204 (nothing is playing) and for an
+    // empty 200, so a flag still false afterwards means no active playback
+    m_nowPlayingReceived = false;
+    m_clockDriftDetected = false;
+    uint32_t requestStart = millis();
+    if (!makeStreamRequest(EP_NOW_PLAYING, "GET", "", handleNowPlayingStream, this, true)) {
         DEBUG_PRINTF("[SpotifyController] Failed to get now playing: %s\n", m_lastError.c_str());
         return false;
     }
 
-    if (response.length() == 0) {
+    m_lastUpdateTime = millis();
+    m_lastRtt = m_lastUpdateTime - requestStart;
+
+    // 304: same track and state as last time (e.g. paused); the clock keeps running
+    if (m_lastHttpCode == HTTP_CODE_NOT_MODIFIED) {
+        return true;
+    }
+
+    if (!m_nowPlayingReceived) {
         DEBUG_PRINTLN("[SpotifyController] No track currently playing");
         m_currentTrack.clear();
         return true;
     }
 
-    return parseNowPlaying(response);
+    // progress_ms was sampled while the request was on the wire; assume halfway
+    uint32_t sampledAt = requestStart + m_lastRtt / 2;
+    int reported = m_currentTrack.getPosition();
+    m_currentTrack.setPosition(reported, sampledAt);
+
+    if (wasPlaying && m_currentTrack.isPlaying() && m_currentTrack.getId() == previousId) {
+        int predicted = previousPosition + (int)(sampledAt - previousSyncedAt);
+        m_lastClockDrift = reported - predicted;
+
+        // Someone seeked on another device, or playback stalled (buffering)
+        if (abs(m_lastClockDrift) > SPOTIFY_CLOCK_DRIFT_MS) {
+            m_clockDriftDetected = true;
+            m_clockResyncCount++;
+            DEBUG_PRINTF("[SpotifyController] Playback clock drifted %d ms, resynced\n", m_lastClockDrift);
+        }
+    }
+
+    return true;
+}
+
+bool SpotifyController::requestNowPlaying(uint32_t deadlineMs) {
+    if (!isAuthenticated()) {
+        return false;
+    }
+
+    // A verification poll answers a button press, so it jumps the queue like one
+    RequestPriority priority = RequestPriority::BACKGROUND;
+    if (m_verifying) {
+        priority = RequestPriority::INTERACTIVE;
+    } else if (m_pollSchedule.isVisible()) {
+        priority = RequestPriority::VISIBLE;
+    }
+    return RequestScheduler::getInstance().submit(priority, runNowPlaying, this,
+                                                  "spotify-now-playing", deadlineMs);
+}
+
+bool SpotifyController::runNowPlaying(void* context) {
+    SpotifyController* self = static_cast<SpotifyController*>(context);
+    SpotifyTrack& track = self->m_currentTrack;
+
+    String previousId = track.getId();
+    PlaybackState previousState = track.getPlaybackState();
+    uint64_t previousTimestamp = track.getServerTimestamp();
+    if (!self->updateNowPlaying()) {
+        if (self->m_verifying) {
+            self->continueVerification();
+        }
+        return false;
+    }
+
+    // Spotify bumps "timestamp" on any playback change (seek, pause, skip)
+    self->m_pollSchedule.recordResult(track.getId() != previousId ||
+                                      track.getPlaybackState() != previousState ||
+                                      track.getServerTimestamp() != previousTimestamp ||
+                                      self->m_clockDriftDetected);
+
+    if (self->m_clockDriftDetected) {
+        // Likely being scrubbed elsewhere; confirm the new position soon
+        self->m_pollSchedule.pollAt(SPOTIFY_CLOCK_VERIFY_MS);
+    }
+
+    if (self->m_verifying) {
+        self->continueVerification();
+    }
+
+    if (track.isPlaying()) {
+        // Nothing changes mid-track unless someone else touches playback, so
+        // the next interesting moment is the predicted end of the track
+        self->m_pollSchedule.setBaseInterval(SPOTIFY_POLL_INTERVAL_MS);
+        int remaining = max(0, track.getTimeRemaining());
+        self->m_pollSchedule.pollAt((uint32_t)remaining + SPOTIFY_TRACK_END_SLACK_MS);
+    } else {
+        self->m_pollSchedule.setBaseInterval(SPOTIFY_PAUSED_POLL_MS);
+    }
+    return true;
+}
+
+void SpotifyController::startVerification() {
+    // A second skip before the first one landed keeps the original baseline,
+    // any track change then satisfies both
+    if (!m_verifying) {
+        m_verifyFromId = m_currentTrack.getId();
+    }
+    m_verifying = true;
+    m_verifyAttempts = 0;
+    m_verifyStarted = millis();
+    m_pollSchedule.pollAt(SPOTIFY_VERIFY_INITIAL_MS);
+}
+
+void SpotifyController::continueVerification() {
+    m_verifyAttempts++;
+    uint32_t elapsed = millis() - m_verifyStarted;
+
+    if (m_currentTrack.getId() != m_verifyFromId) {
+        DEBUG_PRINTF("[SpotifyController] Skip confirmed after %u poll(s), %u ms\n",
+                     m_verifyAttempts, elapsed);
+        m_verifying = false;
+        return;
+    }
+
+    if (elapsed >= SPOTIFY_VERIFY_TIMEOUT_MS) {
+        DEBUG_PRINTF("[SpotifyController] Skip not confirmed after %u poll(s), giving up\n",
+                     m_verifyAttempts);
+        m_verifying = false;
+        return;
+    }
+
+    // Spotify usually switches within a second; back off if it is slower
+    uint32_t delayMs = SPOTIFY_VERIFY_INITIAL_MS << min(m_verifyAttempts, (uint8_t)3);
+    m_pollSchedule.pollAt(min(delayMs, (uint32_t)SPOTIFY_VERIFY_MAX_DELAY_MS));
 }
 
 bool SpotifyController::play() {
@@ -122,9 +295,8 @@ bool SpotifyController::skipNext() {
 
     String response;
     if (makeApiRequest(EP_NEXT, "POST", "", response)) {
-        // Update now playing after skip
-        delay(500);  // Wait for Spotify to update
-        return updateNowPlaying();
+        startVerification();
+        return true;
     }
 
     return false;
@@ -140,9 +312,8 @@ bool SpotifyController::skipPrevious() {
 
     String response;
     if (makeApiRequest(EP_PREVIOUS, "POST", "", response)) {
-        // Update now playing after skip
-        delay(500);
-        return updateNowPlaying();
+        startVerification();
+        return true;
     }
 
     return false;
@@ -231,50 +402,126 @@ bool SpotifyController::setRepeat(RepeatMode mode) {
     return false;
 }
 
+void SpotifyController::requestVolume(int volume) {
+    if (volume < 0) volume = 0;
+    if (volume > 100) volume = 100;
+
+    m_currentTrack.setVolume(volume);
+    m_volumeCoalescer.submit((float)volume);
+}
+
+void SpotifyController::requestSeek(int position) {
+    if (position < 0) position = 0;
+
+    m_currentTrack.setPosition(position);
+    m_seekCoalescer.submit((float)position);
+}
+
+void SpotifyController::flushControls() {
+    m_volumeCoalescer.flush();
+    m_seekCoalescer.flush();
+
+    DEBUG_PRINTF("[SpotifyController] Controls: volume %u/%u sent, seek %u/%u sent\n",
+                 m_volumeCoalescer.getSentCount(), m_volumeCoalescer.getSubmittedCount(),
+                 m_seekCoalescer.getSentCount(), m_seekCoalescer.getSubmittedCount());
+}
+
+bool SpotifyController::sendVolume(float value, void* context) {
+    return static_cast<SpotifyController*>(context)->setVolume((int)value);
+}
+
+bool SpotifyController::sendSeek(float value, void* context) {
+    return static_cast<SpotifyController*>(context)->seek((int)value);
+}
+
 bool SpotifyController::makeApiRequest(const String& endpoint, const String& method, 
                                       const String& body, String& response) {
-    String url = String(API_BASE) + endpoint;
+    String url = m_apiBase + endpoint;
     
     DEBUG_PRINTF("[SpotifyController] API %s: %s\n", method.c_str(), endpoint.c_str());
 
-    m_http.begin(url);
-    m_http.addHeader("Authorization", "Bearer " + m_accessToken);
-    m_http.addHeader("Content-Type", "application/json");
-
-    int httpCode;
-    if (method == "GET") {
-        httpCode = m_http.GET();
-    } else if (method == "POST") {
-        httpCode = m_http.POST(body);
-    } else if (method == "PUT") {
-        httpCode = m_http.PUT(body);
-    } else {
+    if (method != "GET" && method != "POST" && method != "PUT") {
         m_lastError = "Invalid HTTP method";
-        m_http.end();
         return false;
     }
 
-    if (httpCode == HTTP_CODE_OK || httpCode == HTTP_CODE_NO_CONTENT) {
-        response = m_http.getString();
-        m_http.end();
+    ApiHeader headers[] = {
+        { "Authorization", "Bearer " + m_accessToken },
+        { "Content-Type", "application/json" }
+    };
+
+    int httpCode = ApiService::getInstance().request(method, url, body, headers, 2, response);
+    return checkResponse(httpCode);
+}
+
+bool SpotifyController::makeStreamRequest(const String& endpoint, const String& method, const String& body,
+                                          ApiStreamHandler handler, void* context, bool conditional) {
+    String url = m_apiBase + endpoint;
+
+    DEBUG_PRINTF("[SpotifyController] API %s: %s (streamed)\n", method.c_str(), endpoint.c_str());
+
+    ApiHeader headers[] = {
+        { "Authorization", "Bearer " + m_accessToken },
+        { "Content-Type", "application/json" }
+    };
+
+    int httpCode = ApiService::getInstance().requestStream(method, url, body, headers, 2, handler, context, conditional);
+    return checkResponse(httpCode);
+}
+
+bool SpotifyController::isDegraded() {
+    return ApiService::getInstance().getCircuitState(m_apiBase) != CircuitState::CLOSED;
+}
+
+uint32_t SpotifyController::getRetryDelay() {
+    return ApiService::getInstance().getCircuitRetryDelay(m_apiBase);
+}
+
+bool SpotifyController::checkResponse(int httpCode) {
+    m_lastHttpCode = httpCode;
+
+    if (httpCode == HTTP_CODE_OK || httpCode == HTTP_CODE_NO_CONTENT || httpCode == HTTP_CODE_NOT_MODIFIED) {
         return true;
+    } else if (httpCode == API_ERROR_CIRCUIT_OPEN) {
+        m_lastError = "Service unavailable - retrying later";
     } else if (httpCode == HTTP_CODE_UNAUTHORIZED) {
         m_lastError = "Unauthorized - token may have expired";
         DEBUG_PRINTLN("[SpotifyController] ERROR: Token expired or invalid");
+        ApiService::getInstance().reportFailure(m_apiBase);
     } else {
         m_lastError = "HTTP error: " + String(httpCode);
         DEBUG_PRINTF("[SpotifyController] HTTP error: %d\n", httpCode);
     }
 
-    m_http.end();
     return false;
 }
 
-bool SpotifyController::parseNowPlaying(const String& json) {
+bool SpotifyController::handleNowPlayingStream(Stream& body, void* context) {
+    SpotifyController* self = static_cast<SpotifyController*>(context);
+    self->m_nowPlayingReceived = true;
+    return self->parseNowPlaying(body);
+}
+
+bool SpotifyController::parseNowPlaying(Stream& json) {
     DEBUG_PRINTLN("[SpotifyController] Parsing now playing response...");
 
-    DynamicJsonDocument doc(4096);
-    DeserializationError error = deserializeJson(doc, json);
+    // The full response includes available_markets, external ids, every album
+    // image and the device list; keep only what the track model uses
+    DynamicJsonDocument filter(512);
+    JsonObject filterItem = filter.createNestedObject("item");
+    filterItem["id"] = true;
+    filterItem["name"] = true;
+    filterItem["duration_ms"] = true;
+    filterItem["artists"][0]["name"] = true;
+    filterItem["album"]["name"] = true;
+    filterItem["album"]["images"][0]["url"] = true;
+    filter["is_playing"] = true;
+    filter["progress_ms"] = true;
+    filter["timestamp"] = true;
+    filter["context"]["uri"] = true;
+
+    DynamicJsonDocument doc(SPOTIFY_PLAYER_DOC_SIZE);
+    DeserializationError error = deserializeJson(doc, json, DeserializationOption::Filter(filter));
 
     if (error) {
         m_lastError = "JSON parse error";
@@ -315,6 +562,7 @@ bool SpotifyController::parseNowPlaying(const String& json) {
 
     // Progress
     m_currentTrack.setPosition(doc["progress_ms"].as<int>());
+    m_currentTrack.setServerTimestamp(doc["timestamp"].as<uint64_t>());
 
     // Context (playlist/album)
     JsonObject context = doc["context"];
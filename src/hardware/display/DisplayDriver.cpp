@@ -12,6 +12,7 @@ DisplayDriver& DisplayDriver::getInstance() {
 
 DisplayDriver::DisplayDriver() 
     : m_sprite(nullptr)
+    , m_brightness(0)
     , m_initialized(false) {
 }
 
@@ -74,6 +75,7 @@ bool DisplayDriver::init() {
 }
 
 void DisplayDriver::setBrightness(uint8_t brightness) {
+    m_brightness = brightness;
     ledcWrite(0, brightness);  // PWM channel 0 for backlight
 }
 
@@ -25,7 +25,10 @@
 // Services
 #include "services/AuthService.h"
 #include "services/NetworkService.h"
+#include "services/RequestScheduler.h"
+#include "services/PollingPolicy.h"
 #include "services/DatabaseService.h"
+#include "services/ApiService.h"
 
 // App Controllers
 #include "controllers/apps/spotify/SpotifyController.h"
@@ -207,6 +210,13 @@ bool initializeSystem() {
         DEBUG_PRINTLN("[✓] Network Service");
     }
     
+    // Initialize API Service (shared HTTP connection pool)
+    if (!ApiService::getInstance().init()) {
+        DEBUG_PRINTLN("[!] API Service - FAILED (non-critical)");
+    } else {
+        DEBUG_PRINTLN("[✓] API Service");
+    }
+    
     // Initialize Database Service
     if (!DatabaseService::getInstance().init()) {
         DEBUG_PRINTLN("[!] Database Service - FAILED (non-critical)");
@@ -307,6 +317,8 @@ void loop() {
     
     // Update network service
     NetworkService::getInstance().update();
+    PollingPolicy::getInstance().update();
+    ApiService::getInstance().update();
     
     // Update app controllers (for polling)
     SpotifyController::getInstance().update();
@@ -322,6 +334,9 @@ void loop() {
         nav.handleTouch(touchEvent);
     }
     
+    // Run queued API requests (commands from this frame's touch go first)
+    RequestScheduler::getInstance().update();
+    
     // Render frame
     DisplayDriver& display = DisplayDriver::getInstance();
     display.clear(TFT_BLACK);
@@ -342,6 +357,40 @@ void loop() {
                      ESP.getFreeHeap(), 
                      nav.getStackDepth(),
                      1000 / (deltaTime > 0 ? deltaTime : 1));
+        
+        ApiPoolStats poolStats = ApiService::getInstance().getStats();
+        DEBUG_PRINTF("[Main] HTTP pool: %u requests | %u handshakes | %u saved | %u open | %u backed off\n",
+                     poolStats.requests, poolStats.handshakes,
+                     poolStats.handshakesSaved, poolStats.openConnections, poolStats.circuitRejected);
+        if (poolStats.compressedResponses > 0) {
+            DEBUG_PRINTF("[Main] HTTP compressed: %u bodies | %u bytes received | %u inflated\n",
+                         poolStats.compressedResponses, poolStats.bytesStreamed, poolStats.bytesInflated);
+        }
+        DEBUG_PRINTF("[Main] TLS full:    %s\n",
+                     ApiService::getInstance().getHandshakeHistogram(false).toString().c_str());
+        DEBUG_PRINTF("[Main] TLS resumed: %s\n",
+                     ApiService::getInstance().getHandshakeHistogram(true).toString().c_str());
+
+        NetworkService& network = NetworkService::getInstance();
+        DEBUG_PRINTF("[Main] Wi-Fi boot to online: %u ms (%s)\n",
+                     network.getBootToOnlineMs(), network.wasBootFastPath() ? "cached AP" : "full scan");
+        DEBUG_PRINTF("[Main] Wi-Fi cached: %s\n", network.getConnectHistogram(true).toString().c_str());
+        DEBUG_PRINTF("[Main] Wi-Fi full:   %s\n", network.getConnectHistogram(false).toString().c_str());
+
+        RequestScheduler& scheduler = RequestScheduler::getInstance();
+        for (int i = 0; i < REQUEST_PRIORITY_COUNT; i++) {
+            RequestPriority priority = (RequestPriority)i;
+            const RequestClassStats& stats = scheduler.getStats(priority);
+            DEBUG_PRINTF("[Main] Requests %s: %u run | %u expired | %u queued | wait %s\n",
+                         RequestScheduler::getPriorityName(priority), stats.executed, stats.expired,
+                         scheduler.getQueuedCount(priority),
+                         scheduler.getQueueWaitHistogram(priority).toString().c_str());
+        }
+
+        ApiCacheStats cacheStats = ApiService::getInstance().getCacheStats();
+        DEBUG_PRINTF("[Main] HTTP cache: %u/%u not modified | %u bytes saved | %u entries\n",
+                     cacheStats.notModified, cacheStats.conditionalRequests,
+                     cacheStats.bytesSaved, cacheStats.entries);
         lastStatusLog = currentTime;
     }
 }
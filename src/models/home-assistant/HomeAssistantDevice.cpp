@@ -0,0 +1,359 @@
+/**
+ * @file HomeAssistantDevice.cpp
+ * @brief Implementation of HomeAssistantDevice
+ */
+
+#include "models/home-assistant/HomeAssistantDevice.h"
+#include "config/Config.h"
+
+StringPool& HomeAssistantString::pool() {
+    static StringPool pool;
+    return pool;
+}
+
+bool HomeAssistantString::allocatePool(uint16_t entities) {
+    uint32_t strings = (uint32_t)entities * HA_STRINGS_PER_ENTITY;
+    if (strings > 0xFFFE) {
+        strings = 0xFFFE;
+    }
+    if (!pool().allocate((size_t)entities * HA_STRING_BYTES_PER_ENTITY, (uint16_t)strings)) {
+        DEBUG_PRINTLN("[HomeAssistantDevice] String pool allocation failed");
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Home Assistant's default object id for a name, one character at a time:
+ * ASCII letters (lower-cased) and digits, every run of other characters a
+ * single '_', none at either end. Non-ASCII letters are transliterated by
+ * Home Assistant but are separators here, so such names just never match.
+ */
+class NameSlug {
+public:
+    explicit NameSlug(const char* name) : m_next(name), m_started(false), m_gap(false) {}
+
+    char next() {
+        while (*m_next) {
+            char c = *m_next;
+            bool alnum = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9');
+            if (!alnum) {
+                m_gap = true;
+                m_next++;
+                continue;
+            }
+            if (m_gap && m_started) {
+                m_gap = false;
+                return '_';
+            }
+            m_started = true;
+            m_gap = false;
+            m_next++;
+            return (c >= 'A' && c <= 'Z') ? (char)(c - 'A' + 'a') : c;
+        }
+        return '\0';
+    }
+
+private:
+    const char* m_next;
+    bool m_started;
+    bool m_gap;
+};
+
+static bool nameSpells(const char* name, const char* objectId, size_t length) {
+    NameSlug slug(name);
+    for (size_t i = 0; i < length; i++) {
+        if (slug.next() != objectId[i]) {
+            return false;
+        }
+    }
+    return length > 0 && slug.next() == '\0';
+}
+
+const char* HomeAssistantDevice::getDomain() const {
+    // Same order as HomeAssistantDeviceType
+    static const char* const domains[] = { "light", "switch", "sensor", "climate", "media_player", "cover", "fan", "lock" };
+    return type < HomeAssistantDeviceType::UNKNOWN ? domains[(int)type] : m_text[0].c_str();
+}
+
+String HomeAssistantDevice::getObjectId() const {
+    if (m_objectId.length() > 0) {
+        return m_objectId.toString();
+    }
+
+    char buffer[StringPool::MAX_LENGTH + 1];
+    NameSlug slug(m_name.c_str());
+    size_t length = 0;
+    while (length < StringPool::MAX_LENGTH && (buffer[length] = slug.next()) != '\0') {
+        length++;
+    }
+    buffer[length] = '\0';
+    return String(buffer);
+}
+
+String HomeAssistantDevice::getEntityId() const {
+    String domain(getDomain());
+    if (domain.length() == 0) {
+        return getObjectId();
+    }
+    return domain + "." + getObjectId();
+}
+
+bool HomeAssistantDevice::hasEntityId(const String& entityId) const {
+    const char* text = entityId.c_str();
+    size_t length = entityId.length();
+
+    const char* domain = getDomain();
+    size_t domainLength = strlen(domain);
+    if (domainLength > 0) {
+        if (length <= domainLength || memcmp(text, domain, domainLength) != 0 || text[domainLength] != '.') {
+            return false;
+        }
+        text += domainLength + 1;
+        length -= domainLength + 1;
+    }
+
+    if (m_objectId.length() > 0) {
+        return m_objectId.length() == length && memcmp(m_objectId.c_str(), text, length) == 0;
+    }
+    return nameSpells(m_name.c_str(), text, length);
+}
+
+bool HomeAssistantDevice::setEntityId(const String& entityId) {
+    const char* text = entityId.c_str();
+    const char* objectId = text;
+
+    if (isType(HomeAssistantDeviceType::UNKNOWN)) {
+        // No domain to derive: pool it (shared by every entity of the domain)
+        const char* dot = strchr(text, '.');
+        if (dot) {
+            m_text[0].assign(text, dot - text);
+            if (m_text[0].length() == 0) {
+                return false;
+            }
+            objectId = dot + 1;
+        } else {
+            m_text[0] = HomeAssistantString();
+        }
+    } else {
+        const char* domain = getDomain();
+        size_t domainLength = strlen(domain);
+        if (strncmp(text, domain, domainLength) != 0 || text[domainLength] != '.') {
+            return false;
+        }
+        objectId = text + domainLength + 1;
+    }
+
+    size_t length = entityId.length() - (objectId - text);
+    if (nameSpells(m_name.c_str(), objectId, length)) {
+        m_objectId = HomeAssistantString();
+        return true;
+    }
+    m_objectId.assign(objectId, length);
+    return m_objectId.length() == length && length > 0;
+}
+
+void HomeAssistantDevice::setFriendlyName(const String& name) {
+    if (m_name == name) {
+        return;
+    }
+
+    if (m_objectId.length() > 0 && nameSpells(name.c_str(), m_objectId.c_str(), m_objectId.length())) {
+        // Release the id before pooling the name, so its arena bytes are reused
+        m_objectId = HomeAssistantString();
+    } else if (m_objectId.length() == 0 && m_name.length() > 0) {
+        // The old name spells the id: pool the id before the name changes
+        m_objectId = getObjectId();
+        if (m_objectId.length() == 0) {
+            // Pool full: keep the old name, or the entity would lose its id
+            return;
+        }
+    }
+
+    m_name = name;
+    dropDerivedObjectId();
+}
+
+void HomeAssistantDevice::dropDerivedObjectId() {
+    if (m_objectId.length() > 0 && nameSpells(m_name.c_str(), m_objectId.c_str(), m_objectId.length())) {
+        m_objectId = HomeAssistantString();
+    }
+}
+
+void HomeAssistantDevice::setBrightness(uint8_t brightness) {
+    if (isType(HomeAssistantDeviceType::LIGHT)) {
+        m_attributes.light.brightness = brightness;
+    }
+}
+
+void HomeAssistantDevice::setColor(uint8_t r, uint8_t g, uint8_t b) {
+    if (isType(HomeAssistantDeviceType::LIGHT)) {
+        m_attributes.light.r = r;
+        m_attributes.light.g = g;
+        m_attributes.light.b = b;
+        m_attributes.light.flags |= LIGHT_HAS_COLOR;
+    }
+}
+
+void HomeAssistantDevice::clearColor() {
+    if (isType(HomeAssistantDeviceType::LIGHT)) {
+        m_attributes.light.flags &= ~LIGHT_HAS_COLOR;
+    }
+}
+
+void HomeAssistantDevice::setColorTemp(uint16_t mireds) {
+    if (isType(HomeAssistantDeviceType::LIGHT)) {
+        m_attributes.light.colorTemp = mireds > 0xFFF ? 0xFFF : mireds;
+        m_attributes.light.flags |= LIGHT_HAS_COLOR_TEMP;
+    }
+}
+
+void HomeAssistantDevice::clearColorTemp() {
+    if (isType(HomeAssistantDeviceType::LIGHT)) {
+        m_attributes.light.flags &= ~LIGHT_HAS_COLOR_TEMP;
+    }
+}
+
+static int16_t toTenths(float value) {
+    float tenths = value * 10.0f;
+    if (tenths > 32767.0f) return 32767;
+    if (tenths < -32768.0f) return -32768;
+    return (int16_t)lroundf(tenths);
+}
+
+void HomeAssistantDevice::setTemperature(float temperature) {
+    if (isType(HomeAssistantDeviceType::CLIMATE)) {
+        m_attributes.climate.current = toTenths(temperature);
+    }
+}
+
+void HomeAssistantDevice::setTargetTemperature(float temperature) {
+    if (isType(HomeAssistantDeviceType::CLIMATE)) {
+        m_attributes.climate.target = toTenths(temperature);
+    }
+}
+
+void HomeAssistantDevice::setHvacMode(const String& mode) {
+    setText(HomeAssistantDeviceType::CLIMATE, 0, mode);
+}
+
+void HomeAssistantDevice::setMediaTitle(const String& title) {
+    setText(HomeAssistantDeviceType::MEDIA_PLAYER, 0, title);
+}
+
+void HomeAssistantDevice::setMediaArtist(const String& artist) {
+    setText(HomeAssistantDeviceType::MEDIA_PLAYER, 1, artist);
+}
+
+void HomeAssistantDevice::setVolume(float volume) {
+    if (isType(HomeAssistantDeviceType::MEDIA_PLAYER)) {
+        volume = constrain(volume, 0.0f, 1.0f);
+        m_attributes.media.volume = (uint16_t)lroundf(volume * 1000.0f);
+    }
+}
+
+static bool parseDecimal(const char* text, int32_t& value, uint8_t& decimals) {
+    bool negative = *text == '-';
+    if (negative) {
+        text++;
+    }
+    if (*text < '0' || *text > '9') {
+        return false;
+    }
+
+    int64_t magnitude = 0;
+    bool fraction = false;
+    decimals = 0;
+    for (; *text; text++) {
+        if (*text == '.' && !fraction) {
+            fraction = true;
+            continue;
+        }
+        if (*text < '0' || *text > '9') {
+            return false;
+        }
+        magnitude = magnitude * 10 + (*text - '0');
+        decimals += fraction ? 1 : 0;
+        if (magnitude > INT32_MAX || decimals > 9) {
+            return false;
+        }
+    }
+    value = (int32_t)(negative ? -magnitude : magnitude);
+    return true;
+}
+
+static void formatDecimal(int32_t value, uint8_t decimals, char* buffer, size_t size) {
+    const char* sign = value < 0 ? "-" : "";
+    uint32_t magnitude = value < 0 ? (uint32_t)(-(int64_t)value) : (uint32_t)value;
+    if (decimals == 0) {
+        snprintf(buffer, size, "%s%lu", sign, (unsigned long)magnitude);
+        return;
+    }
+
+    uint32_t scale = 1;
+    for (uint8_t i = 0; i < decimals; i++) {
+        scale *= 10;
+    }
+    char fraction[10];
+    uint32_t rest = magnitude % scale;
+    for (int i = decimals - 1; i >= 0; i--) {
+        fraction[i] = (char)('0' + rest % 10);
+        rest /= 10;
+    }
+    fraction[decimals] = '\0';
+    snprintf(buffer, size, "%s%lu.%s", sign, (unsigned long)(magnitude / scale), fraction);
+}
+
+String HomeAssistantDevice::getSensorValue() const {
+    if (!isType(HomeAssistantDeviceType::SENSOR)) {
+        return String();
+    }
+    if (!m_attributes.sensor.numeric) {
+        return m_text[0].toString();
+    }
+
+    int32_t value = (int32_t)(((uint32_t)(uint16_t)m_attributes.sensor.high << 16) | m_attributes.sensor.low);
+    char buffer[24];
+    formatDecimal(value, m_attributes.sensor.decimals, buffer, sizeof(buffer));
+    return String(buffer);
+}
+
+void HomeAssistantDevice::setSensorValue(const String& value) {
+    if (!isType(HomeAssistantDeviceType::SENSOR)) {
+        return;
+    }
+
+    // Fixed point only when it prints back byte for byte ("07", "-0" or "1e3" stay text)
+    int32_t fixed;
+    uint8_t decimals;
+    char check[24];
+    if (parseDecimal(value.c_str(), fixed, decimals)) {
+        formatDecimal(fixed, decimals, check, sizeof(check));
+        if (value == check) {
+            m_attributes.sensor.low = (uint16_t)((uint32_t)fixed & 0xFFFF);
+            m_attributes.sensor.high = (int16_t)((uint32_t)fixed >> 16);
+            m_attributes.sensor.decimals = decimals;
+            m_attributes.sensor.numeric = true;
+            m_text[0] = HomeAssistantString();
+            return;
+        }
+    }
+
+    m_attributes.sensor.numeric = false;
+    m_text[0] = value;
+}
+
+void HomeAssistantDevice::setUnit(const String& unit) {
+    setText(HomeAssistantDeviceType::SENSOR, 1, unit);
+}
+
+const HomeAssistantString& HomeAssistantDevice::textFor(HomeAssistantDeviceType t, int index) const {
+    static const HomeAssistantString empty;
+    return isType(t) ? m_text[index] : empty;
+}
+
+void HomeAssistantDevice::setText(HomeAssistantDeviceType t, int index, const String& text) {
+    if (isType(t)) {
+        m_text[index] = text;
+    }
+}
@@ -0,0 +1,333 @@
+/**
+ * @file HomeAssistantEntityStore.cpp
+ * @brief Implementation of HomeAssistantEntityStore
+ */
+
+#include "models/home-assistant/HomeAssistantEntityStore.h"
+#include <esp_heap_caps.h>
+#include <new>
+
+#define SLOT_USED   0x01
+#define SLOT_SEEN   0x02
+
+static void* allocateTable(size_t size) {
+    void* table = heap_caps_malloc(size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (!table) {
+        table = malloc(size);
+    }
+    return table;
+}
+
+HomeAssistantEntityStore::HomeAssistantEntityStore()
+    : m_devices(nullptr)
+    , m_hashes(nullptr)
+    , m_stateHashes(nullptr)
+    , m_flags(nullptr)
+    , m_index(nullptr)
+    , m_indexMask(0)
+    , m_freeSlots(nullptr)
+    , m_freeCount(0)
+    , m_capacity(0)
+    , m_count(0)
+    , m_version(1)
+    , m_typeOrder(nullptr)
+    , m_typeOrderVersion(0) {
+    memset(m_typeStart, 0, sizeof(m_typeStart));
+}
+
+HomeAssistantEntityStore::~HomeAssistantEntityStore() {
+    if (m_devices) {
+        for (uint16_t i = 0; i < m_capacity; i++) {
+            m_devices[i].~HomeAssistantDevice();
+        }
+    }
+    free(m_devices);
+    free(m_hashes);
+    free(m_stateHashes);
+    free(m_flags);
+    free(m_index);
+    free(m_freeSlots);
+    free(m_typeOrder);
+}
+
+bool HomeAssistantEntityStore::allocate(uint16_t capacity) {
+    if (m_devices || capacity == 0 || capacity > 0x7FFF) {
+        return m_devices != nullptr;
+    }
+
+    // Index at <= 50% load keeps probe chains to a slot or two
+    uint32_t indexSize = 1;
+    while (indexSize < (uint32_t)capacity * 2) {
+        indexSize <<= 1;
+    }
+
+    // Pooled strings grow with the entity count, so the pool is sized here too
+    if (!HomeAssistantString::allocatePool(capacity)) {
+        return false;
+    }
+
+    m_devices = (HomeAssistantDevice*)allocateTable(sizeof(HomeAssistantDevice) * capacity);
+    m_hashes = (uint32_t*)allocateTable(sizeof(uint32_t) * capacity);
+    m_stateHashes = (uint32_t*)allocateTable(sizeof(uint32_t) * capacity);
+    m_flags = (uint8_t*)allocateTable(capacity);
+    m_index = (uint16_t*)allocateTable(sizeof(uint16_t) * indexSize);
+    m_freeSlots = (uint16_t*)allocateTable(sizeof(uint16_t) * capacity);
+    m_typeOrder = (uint16_t*)allocateTable(sizeof(uint16_t) * capacity);
+
+    if (!m_devices || !m_hashes || !m_stateHashes || !m_flags || !m_index || !m_freeSlots || !m_typeOrder) {
+        DEBUG_PRINTLN("[HomeAssistantEntityStore] Out of memory for entity table");
+        free(m_devices);
+        free(m_hashes);
+        free(m_stateHashes);
+        free(m_flags);
+        free(m_index);
+        free(m_freeSlots);
+        free(m_typeOrder);
+        m_devices = nullptr;
+        m_hashes = nullptr;
+        m_stateHashes = nullptr;
+        m_flags = nullptr;
+        m_index = nullptr;
+        m_freeSlots = nullptr;
+        m_typeOrder = nullptr;
+        return false;
+    }
+
+    for (uint16_t i = 0; i < capacity; i++) {
+        new (&m_devices[i]) HomeAssistantDevice();
+    }
+    m_capacity = capacity;
+    m_indexMask = (uint16_t)(indexSize - 1);
+    clear();
+
+    DEBUG_PRINTF("[HomeAssistantEntityStore] %u slots, %u index buckets\n", capacity, (unsigned)indexSize);
+    return true;
+}
+
+HomeAssistantDevice* HomeAssistantEntityStore::find(const String& entityId) {
+    int slot = findSlot(entityId, hashId(entityId.c_str()));
+    return slot >= 0 ? &m_devices[slot] : nullptr;
+}
+
+const HomeAssistantDevice* HomeAssistantEntityStore::find(const String& entityId) const {
+    int slot = findSlot(entityId, hashId(entityId.c_str()));
+    return slot >= 0 ? &m_devices[slot] : nullptr;
+}
+
+HomeAssistantDevice* HomeAssistantEntityStore::findOrInsert(const String& entityId, HomeAssistantDeviceType type) {
+    if (!m_devices || entityId.length() == 0) {
+        return nullptr;
+    }
+
+    uint32_t hash = hashId(entityId.c_str());
+    int found = findSlot(entityId, hash);
+    if (found >= 0) {
+        m_flags[found] |= SLOT_SEEN;
+        return &m_devices[found];
+    }
+
+    if (m_freeCount == 0) {
+        return nullptr;
+    }
+
+    uint16_t slot = m_freeSlots[m_freeCount - 1];
+    HomeAssistantDevice& device = m_devices[slot];
+    device = HomeAssistantDevice();
+    device.type = type;
+    if (!device.setEntityId(entityId)) {
+        // String pool full (or a domain that doesn't match the type): it could never be found again
+        device = HomeAssistantDevice();
+        return nullptr;
+    }
+    m_freeCount--;
+    m_hashes[slot] = hash;
+    m_stateHashes[slot] = 0;
+    m_flags[slot] = SLOT_USED | SLOT_SEEN;
+
+    uint16_t bucket = hash & m_indexMask;
+    while (m_index[bucket] != 0) {
+        bucket = (bucket + 1) & m_indexMask;
+    }
+    m_index[bucket] = slot + 1;
+
+    m_count++;
+    m_version++;
+    return &device;
+}
+
+bool HomeAssistantEntityStore::remove(const String& entityId) {
+    int slot = findSlot(entityId, hashId(entityId.c_str()));
+    if (slot < 0) {
+        return false;
+    }
+
+    eraseIndex((uint16_t)slot);
+
+    // Reset so the slot's pooled strings are released
+    m_devices[slot] = HomeAssistantDevice();
+    m_flags[slot] = 0;
+    m_freeSlots[m_freeCount++] = (uint16_t)slot;
+    m_count--;
+    m_version++;
+    return true;
+}
+
+void HomeAssistantEntityStore::clear() {
+    if (!m_devices) {
+        return;
+    }
+
+    for (uint16_t i = 0; i < m_capacity; i++) {
+        if (m_flags[i] & SLOT_USED) {
+            m_devices[i] = HomeAssistantDevice();
+        }
+        m_flags[i] = 0;
+        // Lowest slots are handed out first
+        m_freeSlots[i] = m_capacity - 1 - i;
+    }
+    memset(m_index, 0, sizeof(uint16_t) * ((uint32_t)m_indexMask + 1));
+    m_freeCount = m_capacity;
+    m_count = 0;
+    m_version++;
+}
+
+bool HomeAssistantEntityStore::updateStateHash(const HomeAssistantDevice& device, uint32_t hash) {
+    uint32_t& stored = m_stateHashes[slotOf(device)];
+    if (stored == hash && hash != 0) {
+        return false;
+    }
+    stored = hash;
+    return true;
+}
+
+const HomeAssistantDevice* HomeAssistantEntityStore::getSlot(uint16_t slot) const {
+    if (slot >= m_capacity || !(m_flags[slot] & SLOT_USED)) {
+        return nullptr;
+    }
+    return &m_devices[slot];
+}
+
+HomeAssistantDeviceSpan HomeAssistantEntityStore::all() const {
+    if (!m_devices) {
+        return HomeAssistantDeviceSpan();
+    }
+    rebuildTypeOrder();
+    return HomeAssistantDeviceSpan(this, m_typeOrder, m_count);
+}
+
+HomeAssistantDeviceSpan HomeAssistantEntityStore::byType(HomeAssistantDeviceType type) const {
+    int t = (int)type;
+    if (!m_devices || t < 0 || t >= TYPE_COUNT) {
+        return HomeAssistantDeviceSpan();
+    }
+    rebuildTypeOrder();
+    return HomeAssistantDeviceSpan(this, m_typeOrder + m_typeStart[t], m_typeStart[t + 1] - m_typeStart[t]);
+}
+
+void HomeAssistantEntityStore::beginSweep() {
+    for (uint16_t i = 0; i < m_capacity; i++) {
+        m_flags[i] &= ~SLOT_SEEN;
+    }
+}
+
+int HomeAssistantEntityStore::endSweep() {
+    int removed = 0;
+    for (uint16_t i = 0; i < m_capacity; i++) {
+        if ((m_flags[i] & SLOT_USED) && !(m_flags[i] & SLOT_SEEN)) {
+            String entityId = m_devices[i].getEntityId();
+            DEBUG_PRINTF("[HomeAssistantEntityStore] Entity gone: %s\n", entityId.c_str());
+            remove(entityId);
+            removed++;
+        }
+    }
+    return removed;
+}
+
+int HomeAssistantEntityStore::findSlot(const String& entityId, uint32_t hash) const {
+    if (!m_devices) {
+        return -1;
+    }
+
+    // Hash compare first; the String compare only runs for a real candidate
+    uint16_t bucket = hash & m_indexMask;
+    while (m_index[bucket] != 0) {
+        uint16_t slot = m_index[bucket] - 1;
+        if (m_hashes[slot] == hash && m_devices[slot].hasEntityId(entityId)) {
+            return slot;
+        }
+        bucket = (bucket + 1) & m_indexMask;
+    }
+    return -1;
+}
+
+void HomeAssistantEntityStore::eraseIndex(uint16_t slot) {
+    uint16_t hole = m_hashes[slot] & m_indexMask;
+    while (m_index[hole] != slot + 1) {
+        hole = (hole + 1) & m_indexMask;
+    }
+
+    // Backward-shift deletion: no tombstones, probe chains stay short
+    uint16_t bucket = hole;
+    while (true) {
+        bucket = (bucket + 1) & m_indexMask;
+        uint16_t entry = m_index[bucket];
+        if (entry == 0) {
+            break;
+        }
+
+        uint16_t home = m_hashes[entry - 1] & m_indexMask;
+        bool movable = (bucket > hole) ? (home <= hole || home > bucket)
+                                       : (home <= hole && home > bucket);
+        if (movable) {
+            m_index[hole] = entry;
+            hole = bucket;
+        }
+    }
+    m_index[hole] = 0;
+}
+
+void HomeAssistantEntityStore::rebuildTypeOrder() const {
+    if (m_typeOrderVersion == m_version) {
+        return;
+    }
+
+    // Counting sort by type; slot order within a type is kept
+    uint16_t counts[TYPE_COUNT] = {0};
+    for (uint16_t i = 0; i < m_capacity; i++) {
+        if (m_flags[i] & SLOT_USED) {
+            counts[(int)m_devices[i].type]++;
+        }
+    }
+
+    m_typeStart[0] = 0;
+    for (int t = 0; t < TYPE_COUNT; t++) {
+        m_typeStart[t + 1] = m_typeStart[t] + counts[t];
+    }
+
+    uint16_t next[TYPE_COUNT];
+    memcpy(next, m_typeStart, sizeof(next));
+    for (uint16_t i = 0; i < m_capacity; i++) {
+        if (m_flags[i] & SLOT_USED) {
+            m_typeOrder[next[(int)m_devices[i].type]++] = i;
+        }
+    }
+
+    m_typeOrderVersion = m_version;
+}
+
+size_t HomeAssistantEntityStore::getFootprint() const {
+    if (!m_devices) {
+        return 0;
+    }
+    size_t perSlot = sizeof(HomeAssistantDevice) + 2 * sizeof(uint32_t) + sizeof(uint8_t) + 2 * sizeof(uint16_t);
+    return perSlot * m_capacity + sizeof(uint16_t) * ((size_t)m_indexMask + 1);
+}
+
+uint32_t HomeAssistantEntityStore::hashId(const char* id) {
+    uint32_t hash = 2166136261u;
+    while (*id) {
+        hash ^= (uint8_t)*id++;
+        hash *= 16777619u;
+    }
+    return hash;
+}
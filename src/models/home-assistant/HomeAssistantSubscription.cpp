@@ -0,0 +1,234 @@
+/**
+ * @file HomeAssistantSubscription.cpp
+ * @brief Implementation of HomeAssistantSubscription
+ */
+
+#include "models/home-assistant/HomeAssistantSubscription.h"
+
+// Values end up in the line format; quoting for SQL and templates is left to the writers
+static bool isValidValue(const String& value) {
+    return value.length() > 0 && !strpbrk(value.c_str(), "\t\n");
+}
+
+HomeAssistantSubscription::HomeAssistantSubscription()
+    : m_entityCount(0)
+    , m_pinnedCount(0)
+    , m_domainCount(0)
+    , m_areaCount(0)
+    , m_areasResolved(false) {
+}
+
+bool HomeAssistantSubscription::matches(const char* entityId) const {
+    if (isEmpty()) {
+        return true;
+    }
+    if (!entityId || !entityId[0]) {
+        return false;
+    }
+
+    const char* dot = strchr(entityId, '.');
+    if (dot) {
+        size_t domainLength = dot - entityId;
+        for (int i = 0; i < m_domainCount; i++) {
+            if (m_domains[i].length() == domainLength && strncmp(m_domains[i].c_str(), entityId, domainLength) == 0) {
+                return true;
+            }
+        }
+    }
+
+    return findEntity(entityId, hashId(entityId)) >= 0;
+}
+
+bool HomeAssistantSubscription::addEntity(const String& entityId) {
+    int index = findEntity(entityId.c_str(), hashId(entityId.c_str()));
+    if (index >= 0) {
+        // Pinning an area member keeps it when the area is dropped
+        if (m_entities[index].fromArea) {
+            m_entities[index].fromArea = false;
+            m_pinnedCount++;
+        }
+        return true;
+    }
+    return addEntry(entityId, false);
+}
+
+bool HomeAssistantSubscription::removeEntity(const String& entityId) {
+    int index = findEntity(entityId.c_str(), hashId(entityId.c_str()));
+    if (index < 0 || m_entities[index].fromArea) {
+        return false;
+    }
+    removeAt(index);
+    return true;
+}
+
+bool HomeAssistantSubscription::addDomain(const String& domain) {
+    if (!isValidValue(domain)) {
+        return false;
+    }
+    for (int i = 0; i < m_domainCount; i++) {
+        if (m_domains[i] == domain) {
+            return true;
+        }
+    }
+    if (m_domainCount >= HA_SUBSCRIPTION_MAX_DOMAINS) {
+        return false;
+    }
+    m_domains[m_domainCount++] = domain;
+    return true;
+}
+
+bool HomeAssistantSubscription::addArea(const String& area) {
+    if (!isValidValue(area)) {
+        return false;
+    }
+    for (int i = 0; i < m_areaCount; i++) {
+        if (m_areas[i] == area) {
+            return true;
+        }
+    }
+    if (m_areaCount >= HA_SUBSCRIPTION_MAX_AREAS) {
+        return false;
+    }
+    m_areas[m_areaCount++] = area;
+    m_areasResolved = false;
+    return true;
+}
+
+void HomeAssistantSubscription::clear() {
+    for (int i = 0; i < m_entityCount; i++) {
+        m_entities[i].entityId = "";
+    }
+    m_entityCount = 0;
+    m_pinnedCount = 0;
+    m_domainCount = 0;
+    m_areaCount = 0;
+    m_areasResolved = false;
+}
+
+int HomeAssistantSubscription::setAreaEntities(const String& entityIds) {
+    for (int i = m_entityCount - 1; i >= 0; i--) {
+        if (m_entities[i].fromArea) {
+            removeAt(i);
+        }
+    }
+
+    int added = 0;
+    int start = 0;
+    int length = entityIds.length();
+    while (start < length) {
+        int end = entityIds.indexOf(',', start);
+        if (end < 0) end = length;
+
+        String entityId = entityIds.substring(start, end);
+        entityId.trim();
+        if (entityId.length() > 0 && findEntity(entityId.c_str(), hashId(entityId.c_str())) < 0) {
+            if (!addEntry(entityId, true)) {
+                DEBUG_PRINTLN("[HomeAssistantSubscription] Entity list full, area members dropped");
+                break;
+            }
+            added++;
+        }
+        start = end + 1;
+    }
+
+    m_areasResolved = true;
+    return added;
+}
+
+String HomeAssistantSubscription::serialize() const {
+    // Area members are not stored: they are resolved again each session
+    String data;
+    for (int i = 0; i < m_entityCount; i++) {
+        if (!m_entities[i].fromArea) {
+            data += "E\t";
+            data += m_entities[i].entityId;
+            data += '\n';
+        }
+    }
+    for (int i = 0; i < m_domainCount; i++) {
+        data += "D\t";
+        data += m_domains[i];
+        data += '\n';
+    }
+    for (int i = 0; i < m_areaCount; i++) {
+        data += "A\t";
+        data += m_areas[i];
+        data += '\n';
+    }
+    return data;
+}
+
+int HomeAssistantSubscription::deserialize(const String& data) {
+    clear();
+
+    int loaded = 0;
+    int start = 0;
+    int length = data.length();
+    while (start < length) {
+        int end = data.indexOf('\n', start);
+        if (end < 0) end = length;
+
+        if (end - start > 2 && data[start + 1] == '\t') {
+            String value = data.substring(start + 2, end);
+            bool added = false;
+            switch (data[start]) {
+                case 'E': added = addEntity(value); break;
+                case 'D': added = addDomain(value); break;
+                case 'A': added = addArea(value); break;
+                default: break;
+            }
+            if (added) {
+                loaded++;
+            }
+        }
+        start = end + 1;
+    }
+
+    return loaded;
+}
+
+int HomeAssistantSubscription::findEntity(const char* entityId, uint32_t hash) const {
+    for (int i = 0; i < m_entityCount; i++) {
+        if (m_entities[i].hash == hash && strcmp(m_entities[i].entityId.c_str(), entityId) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+bool HomeAssistantSubscription::addEntry(const String& entityId, bool fromArea) {
+    if (!isValidValue(entityId) || m_entityCount >= HA_SUBSCRIPTION_MAX_ENTITIES) {
+        return false;
+    }
+
+    Entry& entry = m_entities[m_entityCount++];
+    entry.entityId = entityId;
+    entry.hash = hashId(entityId.c_str());
+    entry.fromArea = fromArea;
+    if (!fromArea) {
+        m_pinnedCount++;
+    }
+    return true;
+}
+
+void HomeAssistantSubscription::removeAt(int index) {
+    if (!m_entities[index].fromArea) {
+        m_pinnedCount--;
+    }
+
+    // Order does not matter: move the last entry into the hole
+    m_entityCount--;
+    if (index != m_entityCount) {
+        m_entities[index] = m_entities[m_entityCount];
+    }
+    m_entities[m_entityCount].entityId = "";
+}
+
+uint32_t HomeAssistantSubscription::hashId(const char* id) {
+    uint32_t hash = 2166136261u;
+    while (*id) {
+        hash ^= (uint8_t)*id++;
+        hash *= 16777619u;
+    }
+    return hash;
+}
@@ -0,0 +1,193 @@
+/**
+ * @file SlackDirectory.cpp
+ * @brief Implementation of SlackDirectory
+ */
+
+#include "models/slack/SlackDirectory.h"
+#include <esp_heap_caps.h>
+
+static_assert(SLACK_DIRECTORY_ARENA_SIZE <= 65535, "Arena offsets are 16-bit");
+
+SlackDirectory::SlackDirectory()
+    : m_arena(nullptr)
+    , m_arenaUsed(0)
+    , m_entryCount(0) {
+    // Large and rarely touched: keep it out of internal RAM when PSRAM exists
+    m_arena = (char*)heap_caps_malloc(SLACK_DIRECTORY_ARENA_SIZE, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (!m_arena) {
+        m_arena = (char*)malloc(SLACK_DIRECTORY_ARENA_SIZE);
+    }
+    if (!m_arena) {
+        DEBUG_PRINTLN("[SlackDirectory] Out of memory for name arena");
+    }
+}
+
+SlackDirectory::~SlackDirectory() {
+    free(m_arena);
+}
+
+bool SlackDirectory::put(SlackDirectoryKind kind, const char* id, const char* name) {
+    if (!m_arena || !id || !id[0]) {
+        return false;
+    }
+    if (!name) {
+        name = "";
+    }
+
+    uint32_t idHash = hashId(id);
+    int index = find(kind, id, idHash);
+    if (index >= 0) {
+        Entry& entry = m_entries[index];
+        if (strcmp(m_arena + entry.nameOffset, name) == 0) {
+            return true;
+        }
+
+        // Renamed: the old name stays in the arena until the next compaction
+        // (which keeps the entry's current name, so it may run first)
+        if (!reserve(strlen(name) + 1)) {
+            return false;
+        }
+        m_entries[index].nameOffset = append(name);
+        return true;
+    }
+
+    if (m_entryCount >= SLACK_DIRECTORY_MAX_ENTRIES) {
+        return false;
+    }
+
+    // Room for both strings up front: a compaction between the two would
+    // drop the id, which no entry owns yet
+    if (!reserve(strlen(id) + 1 + strlen(name) + 1)) {
+        return false;
+    }
+
+    Entry& entry = m_entries[m_entryCount++];
+    entry.idHash = idHash;
+    entry.idOffset = append(id);
+    entry.nameOffset = append(name);
+    entry.kind = kind;
+    return true;
+}
+
+const char* SlackDirectory::lookup(SlackDirectoryKind kind, const String& id) const {
+    if (!m_arena || id.length() == 0) {
+        return nullptr;
+    }
+
+    int index = find(kind, id.c_str(), hashId(id.c_str()));
+    return index >= 0 ? m_arena + m_entries[index].nameOffset : nullptr;
+}
+
+void SlackDirectory::clear() {
+    m_entryCount = 0;
+    m_arenaUsed = 0;
+}
+
+String SlackDirectory::serialize() const {
+    String data;
+    data.reserve(m_arenaUsed + m_entryCount * 3);
+    for (uint16_t i = 0; i < m_entryCount; i++) {
+        const Entry& entry = m_entries[i];
+        data += entry.kind == SlackDirectoryKind::USER ? 'U' : 'C';
+        data += '\t';
+        data += m_arena + entry.idOffset;
+        data += '\t';
+        data += m_arena + entry.nameOffset;
+        data += '\n';
+    }
+    return data;
+}
+
+int SlackDirectory::deserialize(const String& data) {
+    clear();
+
+    int start = 0;
+    int length = data.length();
+    while (start < length) {
+        int end = data.indexOf('\n', start);
+        if (end < 0) end = length;
+
+        int idStart = start + 2;
+        int nameStart = data.indexOf('\t', idStart);
+        if (end - start > 2 && data[start + 1] == '\t' && nameStart > idStart && nameStart < end) {
+            SlackDirectoryKind kind = data[start] == 'U' ? SlackDirectoryKind::USER : SlackDirectoryKind::CHANNEL;
+            String id = data.substring(idStart, nameStart);
+            String name = data.substring(nameStart + 1, end);
+            if (!put(kind, id.c_str(), name.c_str())) {
+                break;
+            }
+        }
+        start = end + 1;
+    }
+
+    return m_entryCount;
+}
+
+int SlackDirectory::find(SlackDirectoryKind kind, const char* id, uint32_t idHash) const {
+    // Hash compare first: one 32-bit load per entry until a real candidate
+    for (uint16_t i = 0; i < m_entryCount; i++) {
+        const Entry& entry = m_entries[i];
+        if (entry.idHash == idHash && entry.kind == kind && strcmp(m_arena + entry.idOffset, id) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+bool SlackDirectory::reserve(size_t bytes) {
+    if (m_arenaUsed + bytes > SLACK_DIRECTORY_ARENA_SIZE) {
+        compact();
+        if (m_arenaUsed + bytes > SLACK_DIRECTORY_ARENA_SIZE) {
+            DEBUG_PRINTLN("[SlackDirectory] Name arena full");
+            return false;
+        }
+    }
+    return true;
+}
+
+uint16_t SlackDirectory::append(const char* text) {
+    size_t length = strlen(text) + 1;
+    uint16_t offset = (uint16_t)m_arenaUsed;
+    memcpy(m_arena + offset, text, length);
+    m_arenaUsed += length;
+    return offset;
+}
+
+void SlackDirectory::compact() {
+    // Names orphaned by renames are the only garbage; rebuild in a scratch copy
+    char* scratch = (char*)malloc(m_arenaUsed);
+    if (!scratch) {
+        return;
+    }
+    memcpy(scratch, m_arena, m_arenaUsed);
+
+    size_t used = 0;
+    for (uint16_t i = 0; i < m_entryCount; i++) {
+        Entry& entry = m_entries[i];
+        const char* id = scratch + entry.idOffset;
+        const char* name = scratch + entry.nameOffset;
+
+        size_t idLength = strlen(id) + 1;
+        memcpy(m_arena + used, id, idLength);
+        entry.idOffset = (uint16_t)used;
+        used += idLength;
+
+        size_t nameLength = strlen(name) + 1;
+        memcpy(m_arena + used, name, nameLength);
+        entry.nameOffset = (uint16_t)used;
+        used += nameLength;
+    }
+
+    DEBUG_PRINTF("[SlackDirectory] Compacted arena %u -> %u bytes\n", (unsigned)m_arenaUsed, (unsigned)used);
+    m_arenaUsed = used;
+    free(scratch);
+}
+
+uint32_t SlackDirectory::hashId(const char* id) {
+    uint32_t hash = 2166136261u;
+    while (*id) {
+        hash ^= (uint8_t)*id++;
+        hash *= 16777619u;
+    }
+    return hash;
+}
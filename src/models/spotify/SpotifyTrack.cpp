@@ -13,6 +13,8 @@ SpotifyTrack::SpotifyTrack()
     , m_albumArtUrl("")
     , m_duration(0)
     , m_position(0)
+    , m_positionSyncedAt(0)
+    , m_serverTimestamp(0)
     , m_playbackState(PlaybackState::STOPPED)
     , m_volume(70)
     , m_shuffle(false)
@@ -29,6 +31,8 @@ SpotifyTrack::SpotifyTrack(const String& id, const String& name, const String& a
     , m_albumArtUrl("")
     , m_duration(duration)
     , m_position(0)
+    , m_positionSyncedAt(0)
+    , m_serverTimestamp(0)
     , m_playbackState(PlaybackState::STOPPED)
     , m_volume(70)
     , m_shuffle(false)
@@ -42,9 +46,36 @@ void SpotifyTrack::setVolume(int volume) {
     m_volume = volume;
 }
 
+void SpotifyTrack::setPosition(int position, uint32_t syncedAt) {
+    m_position = position;
+    m_positionSyncedAt = syncedAt;
+}
+
+void SpotifyTrack::setPlaybackState(PlaybackState state) {
+    // Pin the clock where it stopped, otherwise a pause would rewind the UI
+    if (isPlaying() && state != PlaybackState::PLAYING) {
+        setPosition(getEstimatedPosition());
+    } else if (!isPlaying() && state == PlaybackState::PLAYING) {
+        m_positionSyncedAt = millis();
+    }
+    m_playbackState = state;
+}
+
+int SpotifyTrack::getEstimatedPosition() const {
+    if (!isPlaying()) {
+        return m_position;
+    }
+
+    int position = m_position + (int)(millis() - m_positionSyncedAt);
+    if (m_duration > 0 && position > m_duration) {
+        position = m_duration;
+    }
+    return position;
+}
+
 int SpotifyTrack::getProgressPercent() const {
     if (m_duration <= 0) return 0;
-    return (m_position * 100) / m_duration;
+    return (getEstimatedPosition() * 100) / m_duration;
 }
 
 String SpotifyTrack::formatDuration() const {
@@ -52,7 +83,7 @@ String SpotifyTrack::formatDuration() const {
 }
 
 String SpotifyTrack::formatPosition() const {
-    return formatTime(m_position);
+    return formatTime(getEstimatedPosition());
 }
 
 String SpotifyTrack::formatTime(int milliseconds) const {
@@ -66,7 +97,7 @@ String SpotifyTrack::formatTime(int milliseconds) const {
 }
 
 int SpotifyTrack::getTimeRemaining() const {
-    return m_duration - m_position;
+    return m_duration - getEstimatedPosition();
 }
 
 bool SpotifyTrack::isValid() const {
@@ -81,6 +112,8 @@ void SpotifyTrack::clear() {
     m_albumArtUrl = "";
     m_duration = 0;
     m_position = 0;
+    m_positionSyncedAt = 0;
+    m_serverTimestamp = 0;
     m_playbackState = PlaybackState::STOPPED;
     m_volume = 70;
     m_shuffle = false;
@@ -0,0 +1,619 @@
+/**
+ * @file ApiService.cpp
+ * @brief Implementation of ApiService
+ */
+
+#include "services/ApiService.h"
+#include "services/NetworkService.h"
+#include "services/ResumableTlsClient.h"
+#include "services/TlsSessionCache.h"
+#include "utils/HttpBodyStream.h"
+
+ApiService& ApiService::getInstance() {
+    static ApiService instance;
+    return instance;
+}
+
+ApiService::ApiService()
+    : m_initialized(false) {
+    for (int i = 0; i < API_POOL_MAX_CONNECTIONS; i++) {
+        m_pool[i].secure = false;
+        m_pool[i].host = "";
+        m_pool[i].port = 0;
+        m_pool[i].client = nullptr;
+        m_pool[i].lastUsed = 0;
+        m_pool[i].inUse = false;
+    }
+    for (int i = 0; i < API_CACHE_MAX_ENTRIES; i++) {
+        m_cache[i].headerHash = 0;
+        m_cache[i].bodySize = 0;
+        m_cache[i].lastUsed = 0;
+    }
+    resetStats();
+}
+
+ApiService::~ApiService() {
+    closeAll();
+}
+
+bool ApiService::init() {
+    if (m_initialized) {
+        return true;
+    }
+
+    DEBUG_PRINTLN("[ApiService] Initializing...");
+    DEBUG_PRINTF("[ApiService] Pool: %d connections, idle timeout %d ms\n",
+                 API_POOL_MAX_CONNECTIONS, API_POOL_IDLE_TIMEOUT_MS);
+
+    TlsSessionCache::getInstance().init();
+
+    m_initialized = true;
+    DEBUG_PRINTLN("[ApiService] Initialized");
+    return true;
+}
+
+void ApiService::update() {
+    if (!m_initialized) return;
+
+    // Close connections that have been idle too long (server would drop them anyway)
+    uint32_t currentTime = millis();
+    for (int i = 0; i < API_POOL_MAX_CONNECTIONS; i++) {
+        PooledConnection& conn = m_pool[i];
+        if (conn.client && !conn.inUse && currentTime - conn.lastUsed >= API_POOL_IDLE_TIMEOUT_MS) {
+            DEBUG_PRINTF("[ApiService] Evicting idle connection: %s:%d\n", conn.host.c_str(), conn.port);
+            closeConnection(&conn);
+            m_stats.evictions++;
+        }
+    }
+
+    TlsSessionCache::getInstance().update();
+}
+
+int ApiService::request(const String& method, const String& url, const String& body,
+                        const ApiHeader* headers, int headerCount, String& response,
+                        bool conditional) {
+    conditional = conditional && method == "GET";
+    uint32_t headerHash = conditional ? hashHeaders(headers, headerCount) : 0;
+    CacheEntry* cached = conditional ? findCacheEntry(url, headerHash) : nullptr;
+
+    PooledConnection* conn = nullptr;
+    int httpCode = execute(method, url, body, headers, headerCount, cached, conn);
+    if (!conn) {
+        return httpCode;
+    }
+
+    if (httpCode == HTTP_CODE_NOT_MODIFIED) {
+        recordNotModified(cached);
+    } else if (httpCode > 0) {
+        response = conn->http.getString();
+        if (conditional && httpCode == HTTP_CODE_OK) {
+            updateCache(conn, url, headerHash, response.length());
+        }
+    }
+
+    // end() keeps the socket open when reuse is enabled and the server agreed to keep-alive
+    conn->http.end();
+    release(conn);
+
+    return httpCode;
+}
+
+int ApiService::requestStream(const String& method, const String& url, const String& body,
+                              const ApiHeader* headers, int headerCount,
+                              ApiStreamHandler handler, void* context,
+                              bool conditional) {
+    conditional = conditional && method == "GET";
+    uint32_t headerHash = conditional ? hashHeaders(headers, headerCount) : 0;
+    CacheEntry* cached = conditional ? findCacheEntry(url, headerHash) : nullptr;
+
+    // Compressed bodies are only worth it when a handler streams them; the
+    // inflate buffers are allocated on first use and kept
+    bool acceptCompressed = API_ACCEPT_COMPRESSED && handler && m_inflate.allocate();
+
+    PooledConnection* conn = nullptr;
+    int httpCode = execute(method, url, body, headers, headerCount, cached, conn, acceptCompressed);
+    if (!conn) {
+        return httpCode;
+    }
+
+    if (httpCode == HTTP_CODE_NOT_MODIFIED) {
+        recordNotModified(cached);
+    } else if (httpCode >= 200 && httpCode < 300 && handler && hasBody(method, httpCode)) {
+        size_t bodySize = 0;
+        if (!consumeStream(conn, handler, context, bodySize)) {
+            httpCode = HTTPC_ERROR_STREAM_WRITE;
+        } else if (conditional && httpCode == HTTP_CODE_OK) {
+            // Only remember validators for a body the caller actually ingested
+            updateCache(conn, url, headerHash, bodySize);
+        }
+    }
+
+    conn->http.end();
+    release(conn);
+
+    return httpCode;
+}
+
+int ApiService::execute(const String& method, const String& url, const String& body,
+                        const ApiHeader* headers, int headerCount, const CacheEntry* validators,
+                        PooledConnection*& conn, bool acceptCompressed) {
+    conn = nullptr;
+
+    if (!NetworkService::getInstance().isConnected()) {
+        DEBUG_PRINTLN("[ApiService] Not connected to network");
+        return HTTPC_ERROR_NOT_CONNECTED;
+    }
+
+    bool secure;
+    String host;
+    uint16_t port;
+    if (!parseUrl(url, secure, host, port)) {
+        DEBUG_PRINTF("[ApiService] Invalid URL: %s\n", url.c_str());
+        return HTTPC_ERROR_CONNECTION_REFUSED;
+    }
+
+    // A backed-off origin costs nothing until its probe time, so check before
+    // the pool might evict another origin's kept-alive connection
+    CircuitBreaker* circuit = findCircuit(host, port, true);
+    if (circuit && !circuit->allowRequest()) {
+        m_stats.circuitRejected++;
+        return API_ERROR_CIRCUIT_OPEN;
+    }
+
+    conn = acquire(secure, host, port);
+    if (!conn) {
+        DEBUG_PRINTLN("[ApiService] No pooled connection available");
+        if (circuit) {
+            circuit->cancelProbe();
+        }
+        return HTTPC_ERROR_TOO_LESS_RAM;
+    }
+
+    m_stats.requests++;
+    if (validators) {
+        m_cacheStats.conditionalRequests++;
+    }
+
+    // A kept-alive socket may have been closed by the server since the last
+    // request; in that case retry once on a fresh connection, unless the
+    // server may already have acted on the request.
+    bool reused = conn->client->connected();
+    int httpCode = sendOnConnection(conn, method, url, body, headers, headerCount, validators,
+                                    acceptCompressed);
+    if (httpCode < 0 && reused && isRetryable(method, httpCode)) {
+        DEBUG_PRINTF("[ApiService] Kept-alive connection to %s closed, reconnecting\n", host.c_str());
+        conn->http.end();
+        conn->client->stop();
+        m_stats.reconnects++;
+        reused = false;
+        httpCode = sendOnConnection(conn, method, url, body, headers, headerCount, validators,
+                                    acceptCompressed);
+    }
+
+    if (reused) {
+        m_stats.handshakesSaved++;
+    } else {
+        m_stats.handshakes++;
+        if (secure && httpCode > 0) {
+            ResumableTlsClient* tls = static_cast<ResumableTlsClient*>(conn->client);
+            if (tls->wasResumed()) {
+                m_stats.tlsResumed++;
+                m_resumedHandshakes.record(tls->getLastHandshakeMs());
+            } else {
+                m_fullHandshakes.record(tls->getLastHandshakeMs());
+            }
+        }
+    }
+
+    if (httpCode <= 0) {
+        DEBUG_PRINTF("[ApiService] Request failed: %s\n", HTTPClient::errorToString(httpCode).c_str());
+    }
+
+    recordOutcome(circuit, conn, httpCode);
+    return httpCode;
+}
+
+bool ApiService::consumeStream(PooledConnection* conn, ApiStreamHandler handler, void* context, size_t& bodySize) {
+    int size = conn->http.getSize();
+    bool chunked = conn->http.header("Transfer-Encoding").equalsIgnoreCase("chunked");
+    if (size == 0 && !chunked) {
+        return true;  // Content-Length: 0
+    }
+
+    // HTTPClient has no stream once the peer closed with nothing buffered
+    WiFiClient* source = conn->http.getStreamPtr();
+    if (!source) {
+        DEBUG_PRINTF("[ApiService] %s closed before the body, closing connection\n", conn->host.c_str());
+        conn->client->stop();
+        bodySize = 0;
+        return false;
+    }
+
+    HttpBodyStream stream(*source, chunked ? -1 : size, chunked);
+
+    bool handled;
+    InflateFormat format;
+    if (InflateStream::parseEncoding(conn->http.header("Content-Encoding"), format)) {
+        if (m_inflate.begin(stream, format)) {
+            handled = handler(m_inflate, context) && !m_inflate.hasError();
+        } else {
+            handled = false;
+        }
+        m_stats.compressedResponses++;
+        m_stats.bytesInflated += m_inflate.getBytesOut();
+    } else {
+        handled = handler(stream, context);
+    }
+
+    // Skip whatever the handler didn't need so the next response on this
+    // connection starts at a header. If that's too much, drop the connection.
+    if (!stream.drain(API_STREAM_DRAIN_MAX_BYTES)) {
+        DEBUG_PRINTF("[ApiService] Unread body on %s, closing connection\n", conn->host.c_str());
+        conn->client->stop();
+    }
+    m_stats.bytesStreamed += stream.getBytesRead();
+    bodySize = stream.getBytesRead();
+
+    return handled;
+}
+
+void ApiService::closeAll() {
+    for (int i = 0; i < API_POOL_MAX_CONNECTIONS; i++) {
+        closeConnection(&m_pool[i]);
+    }
+}
+
+ApiCacheStats ApiService::getCacheStats() const {
+    ApiCacheStats stats = m_cacheStats;
+    stats.entries = 0;
+    for (int i = 0; i < API_CACHE_MAX_ENTRIES; i++) {
+        if (m_cache[i].url.length() > 0) {
+            stats.entries++;
+        }
+    }
+    return stats;
+}
+
+void ApiService::clearCache() {
+    for (int i = 0; i < API_CACHE_MAX_ENTRIES; i++) {
+        m_cache[i].url = "";
+        m_cache[i].etag = "";
+        m_cache[i].lastModified = "";
+    }
+}
+
+ApiPoolStats ApiService::getStats() const {
+    ApiPoolStats stats = m_stats;
+    stats.openConnections = 0;
+    for (int i = 0; i < API_POOL_MAX_CONNECTIONS; i++) {
+        if (m_pool[i].client && m_pool[i].client->connected()) {
+            stats.openConnections++;
+        }
+    }
+    return stats;
+}
+
+void ApiService::resetStats() {
+    m_stats.requests = 0;
+    m_stats.handshakes = 0;
+    m_stats.handshakesSaved = 0;
+    m_stats.tlsResumed = 0;
+    m_stats.reconnects = 0;
+    m_stats.evictions = 0;
+    m_stats.bytesStreamed = 0;
+    m_stats.circuitRejected = 0;
+    m_stats.compressedResponses = 0;
+    m_stats.bytesInflated = 0;
+    m_cacheStats.conditionalRequests = 0;
+    m_cacheStats.notModified = 0;
+    m_cacheStats.bytesSaved = 0;
+    m_cacheStats.entries = 0;
+    m_stats.openConnections = 0;
+    m_fullHandshakes.reset();
+    m_resumedHandshakes.reset();
+}
+
+ApiService::PooledConnection* ApiService::acquire(bool secure, const String& host, uint16_t port) {
+    // Prefer an idle connection to the same origin
+    for (int i = 0; i < API_POOL_MAX_CONNECTIONS; i++) {
+        PooledConnection& conn = m_pool[i];
+        if (conn.client && !conn.inUse && conn.secure == secure && conn.port == port && conn.host == host) {
+            conn.inUse = true;
+            return &conn;
+        }
+    }
+
+    // Otherwise take an empty slot, or evict the least recently used idle one
+    PooledConnection* slot = nullptr;
+    for (int i = 0; i < API_POOL_MAX_CONNECTIONS; i++) {
+        PooledConnection& conn = m_pool[i];
+        if (conn.inUse) continue;
+        if (!conn.client) {
+            slot = &conn;
+            break;
+        }
+        if (!slot || conn.lastUsed < slot->lastUsed) {
+            slot = &conn;
+        }
+    }
+
+    if (!slot) {
+        return nullptr;
+    }
+
+    if (slot->client) {
+        DEBUG_PRINTF("[ApiService] Pool full, evicting: %s:%d\n", slot->host.c_str(), slot->port);
+        closeConnection(slot);
+        m_stats.evictions++;
+    }
+
+    if (secure) {
+        slot->client = new ResumableTlsClient();
+    } else {
+        slot->client = new WiFiClient();
+    }
+
+    slot->secure = secure;
+    slot->host = host;
+    slot->port = port;
+    slot->http.setReuse(true);
+    slot->http.setTimeout(HTTP_TIMEOUT_MS);
+    slot->inUse = true;
+    return slot;
+}
+
+void ApiService::release(PooledConnection* conn) {
+    conn->lastUsed = millis();
+    conn->inUse = false;
+}
+
+void ApiService::closeConnection(PooledConnection* conn) {
+    if (!conn->client) return;
+
+    conn->http.end();
+    conn->client->stop();
+    delete conn->client;
+    conn->client = nullptr;
+    conn->host = "";
+    conn->port = 0;
+    conn->inUse = false;
+}
+
+bool ApiService::hasBody(const String& method, int httpCode) {
+    // Never a body, whatever the length headers say (RFC 9110 6.4.1)
+    if (method == "HEAD") {
+        return false;
+    }
+    return httpCode >= 200 && httpCode != HTTP_CODE_NO_CONTENT && httpCode != HTTP_CODE_RESET_CONTENT &&
+           httpCode != HTTP_CODE_NOT_MODIFIED;
+}
+
+bool ApiService::isRetryable(const String& method, int httpCode) {
+    // Safe methods can always be repeated
+    if (method == "GET" || method == "HEAD") {
+        return true;
+    }
+
+    // Anything else only if the request never got past the headers: once they
+    // are out the server may have seen it, and a POST must not run twice
+    return httpCode == HTTPC_ERROR_CONNECTION_REFUSED ||
+           httpCode == HTTPC_ERROR_SEND_HEADER_FAILED ||
+           httpCode == HTTPC_ERROR_NOT_CONNECTED;
+}
+
+int ApiService::sendOnConnection(PooledConnection* conn, const String& method, const String& url,
+                                 const String& body, const ApiHeader* headers, int headerCount,
+                                 const CacheEntry* validators, bool acceptCompressed) {
+    if (!conn->http.begin(*conn->client, url)) {
+        return HTTPC_ERROR_CONNECTION_REFUSED;
+    }
+
+    // The pooled HTTPClient keeps this between requests, so always set it
+    conn->http.setAcceptEncoding(acceptCompressed ? "gzip, deflate" : "identity;q=1,chunked;q=0.1,*;q=0");
+
+    for (int i = 0; i < headerCount; i++) {
+        conn->http.addHeader(headers[i].name, headers[i].value);
+    }
+
+    if (validators) {
+        if (validators->etag.length() > 0) {
+            conn->http.addHeader("If-None-Match", validators->etag);
+        }
+        if (validators->lastModified.length() > 0) {
+            conn->http.addHeader("If-Modified-Since", validators->lastModified);
+        }
+    }
+
+    // Transfer-Encoding frames streamed bodies (HTTPClient only de-chunks for
+    // getString/writeToStream); validators feed the conditional GET cache;
+    // Retry-After feeds the circuit breaker; Content-Encoding selects the inflater
+    static const char* collectedHeaders[] = { "Transfer-Encoding", "ETag", "Last-Modified", "Retry-After",
+                                              "Content-Encoding" };
+    conn->http.collectHeaders(collectedHeaders, sizeof(collectedHeaders) / sizeof(collectedHeaders[0]));
+
+    return conn->http.sendRequest(method.c_str(), body);
+}
+
+CircuitState ApiService::getCircuitState(const String& url) {
+    CircuitBreaker* circuit = findCircuit(url);
+    return circuit ? circuit->getState() : CircuitState::CLOSED;
+}
+
+uint32_t ApiService::getCircuitRetryDelay(const String& url) {
+    CircuitBreaker* circuit = findCircuit(url);
+    return circuit ? circuit->getRetryDelay() : 0;
+}
+
+void ApiService::reportFailure(const String& url, uint32_t retryAfterMs) {
+    bool secure;
+    String host;
+    uint16_t port;
+    if (!parseUrl(url, secure, host, port)) return;
+
+    CircuitBreaker* circuit = findCircuit(host, port, true);
+    if (!circuit) return;
+
+    if (retryAfterMs > 0) {
+        circuit->openFor(retryAfterMs);
+    } else {
+        circuit->trip();
+    }
+    DEBUG_PRINTF("[ApiService] %s backed off for %u ms\n", host.c_str(), circuit->getRetryDelay());
+}
+
+CircuitBreaker* ApiService::findCircuit(const String& host, uint16_t port, bool create) {
+    OriginCircuit* empty = nullptr;
+    for (int i = 0; i < API_CIRCUIT_MAX_ORIGINS; i++) {
+        OriginCircuit& circuit = m_circuits[i];
+        if (circuit.host.length() == 0) {
+            if (!empty) empty = &circuit;
+        } else if (circuit.port == port && circuit.host == host) {
+            return &circuit.breaker;
+        }
+    }
+
+    if (!create || !empty) {
+        return nullptr;
+    }
+
+    empty->host = host;
+    empty->port = port;
+    empty->breaker.reset();
+    return &empty->breaker;
+}
+
+CircuitBreaker* ApiService::findCircuit(const String& url) {
+    bool secure;
+    String host;
+    uint16_t port;
+    if (!parseUrl(url, secure, host, port)) return nullptr;
+    return findCircuit(host, port, false);
+}
+
+void ApiService::recordOutcome(CircuitBreaker* circuit, PooledConnection* conn, int httpCode) {
+    if (!circuit) return;
+
+    // Rate limited or temporarily unavailable: the server says when to come back
+    if (httpCode == HTTP_CODE_TOO_MANY_REQUESTS || httpCode == HTTP_CODE_SERVICE_UNAVAILABLE) {
+        long retryAfter = conn->http.header("Retry-After").toInt();
+        if (retryAfter > 0) {
+            DEBUG_PRINTF("[ApiService] %s asked to retry after %ld s\n", conn->host.c_str(), retryAfter);
+            circuit->openFor((uint32_t)retryAfter * 1000);
+            return;
+        }
+        if (httpCode == HTTP_CODE_TOO_MANY_REQUESTS) {
+            circuit->trip();
+            return;
+        }
+    }
+
+    // Timeouts, refused connections and 5xx count against the origin; 4xx
+    // are the caller's problem and prove the server is up
+    if (httpCode < 0 || httpCode >= 500) {
+        circuit->recordFailure();
+        if (circuit->getState() == CircuitState::OPEN) {
+            DEBUG_PRINTF("[ApiService] Circuit open for %s, retry in %u ms\n",
+                         conn->host.c_str(), circuit->getRetryDelay());
+        }
+    } else {
+        circuit->recordSuccess();
+    }
+}
+
+ApiService::CacheEntry* ApiService::findCacheEntry(const String& url, uint32_t headerHash) {
+    for (int i = 0; i < API_CACHE_MAX_ENTRIES; i++) {
+        CacheEntry& entry = m_cache[i];
+        if (entry.headerHash == headerHash && entry.url == url) {
+            entry.lastUsed = millis();
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+void ApiService::updateCache(PooledConnection* conn, const String& url, uint32_t headerHash, size_t bodySize) {
+    String etag = conn->http.header("ETag");
+    String lastModified = conn->http.header("Last-Modified");
+    CacheEntry* entry = findCacheEntry(url, headerHash);
+
+    if (etag.length() == 0 && lastModified.length() == 0) {
+        // Server stopped sending validators; don't keep stale ones around
+        if (entry) {
+            entry->url = "";
+            entry->etag = "";
+            entry->lastModified = "";
+        }
+        return;
+    }
+
+    if (!entry) {
+        // Take an empty slot, or replace the least recently used one
+        entry = &m_cache[0];
+        for (int i = 0; i < API_CACHE_MAX_ENTRIES; i++) {
+            if (m_cache[i].url.length() == 0) {
+                entry = &m_cache[i];
+                break;
+            }
+            if (m_cache[i].lastUsed < entry->lastUsed) {
+                entry = &m_cache[i];
+            }
+        }
+        entry->url = url;
+        entry->headerHash = headerHash;
+    }
+
+    entry->etag = etag;
+    entry->lastModified = lastModified;
+    entry->bodySize = bodySize;
+    entry->lastUsed = millis();
+}
+
+void ApiService::recordNotModified(CacheEntry* entry) {
+    m_cacheStats.notModified++;
+    if (entry) {
+        m_cacheStats.bytesSaved += entry->bodySize;
+    }
+}
+
+uint32_t ApiService::hashHeaders(const ApiHeader* headers, int headerCount) {
+    // FNV-1a over header values (the Authorization token is what matters)
+    uint32_t hash = 2166136261UL;
+    for (int i = 0; i < headerCount; i++) {
+        const char* value = headers[i].value.c_str();
+        while (*value) {
+            hash ^= (uint8_t)*value++;
+            hash *= 16777619UL;
+        }
+    }
+    return hash;
+}
+
+bool ApiService::parseUrl(const String& url, bool& secure, String& host, uint16_t& port) {
+    int schemeEnd = url.indexOf("://");
+    if (schemeEnd < 0) return false;
+
+    String scheme = url.substring(0, schemeEnd);
+    if (scheme == "https" || scheme == "wss") {
+        secure = true;
+        port = 443;
+    } else if (scheme == "http" || scheme == "ws") {
+        secure = false;
+        port = 80;
+    } else {
+        return false;
+    }
+
+    int hostStart = schemeEnd + 3;
+    int pathStart = url.indexOf('/', hostStart);
+    String authority = (pathStart < 0) ? url.substring(hostStart) : url.substring(hostStart, pathStart);
+
+    int portSep = authority.indexOf(':');
+    if (portSep >= 0) {
+        port = (uint16_t)authority.substring(portSep + 1).toInt();
+        host = authority.substring(0, portSep);
+    } else {
+        host = authority;
+    }
+
+    return host.length() > 0;
+}
@@ -387,8 +387,9 @@ bool DatabaseService::deleteToken(int userId, const String& appName) {
 bool DatabaseService::saveSetting(int userId, const String& key, const String& value) {
     if (!m_initialized) return false;
 
+    // Settings hold free text (e.g. area names), so quote them properly
     String sql = "INSERT OR REPLACE INTO settings (user_id, setting_key, setting_value) VALUES (" +
-                 String(userId) + ", '" + key + "', '" + value + "');";
+                 String(userId) + ", '" + escapeSQL(key) + "', '" + escapeSQL(value) + "');";
     
     return executeSQL(sql);
 }
@@ -397,7 +398,7 @@ String DatabaseService::getSetting(int userId, const String& key, const String&
     if (!m_initialized) return defaultValue;
 
     String sql = "SELECT setting_value FROM settings WHERE user_id = " + String(userId) +
-                 " AND setting_key = '" + key + "';";
+                 " AND setting_key = '" + escapeSQL(key) + "';";
     
     sqlite3_stmt* stmt;
     if (sqlite3_prepare_v2(m_db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
@@ -417,6 +418,13 @@ bool DatabaseService::executeQuery(const String& sql) {
     return executeSQL(sql);
 }
 
+String DatabaseService::escapeSQL(const String& value) {
+    // Inside a '...' literal a quote is written twice
+    String escaped = value;
+    escaped.replace("'", "''");
+    return escaped;
+}
+
 // Encryption helpers
 String DatabaseService::encrypt(const String& plaintext) {
     if (plaintext.length() == 0) {
@@ -6,20 +6,49 @@
 #include "services/NetworkService.h"
 #include "services/DatabaseService.h"
 #include "services/AuthService.h"
+#include "esp_random.h"
+#include "esp_netif.h"
+#include "esp_netif_net_stack.h"
+#include "lwip/dhcp.h"
+#include <Preferences.h>
 
 NetworkService& NetworkService::getInstance() {
     static NetworkService instance;
     return instance;
 }
 
+// Wi-Fi events are raised on the system event task; update() drains them
+static portMUX_TYPE s_eventMux = portMUX_INITIALIZER_UNLOCKED;
+
 NetworkService::NetworkService()
     : m_status(NetworkStatus::DISCONNECTED)
     , m_ssid("")
     , m_password("")
     , m_autoReconnect(true)
-    , m_lastReconnectAttempt(0)
-    , m_reconnectInterval(30000)  // 30 seconds
-    , m_initialized(false) {
+    , m_initialized(false)
+    , m_attemptTimeout(WIFI_TIMEOUT_MS)
+    , m_attemptStart(0)
+    , m_retryAt(0)
+    , m_retryDelay(0)
+    , m_failedAttempts(0)
+    , m_fastAttempt(false)
+    , m_leaseReused(false)
+    , m_bootToOnlineMs(0)
+    , m_bootFastPath(false)
+    , m_pendingEvents(0)
+    , m_disconnectReason(0) {
+    memset(&m_cache.bssid, 0, sizeof(m_cache.bssid));
+    m_cache.valid = false;
+    m_cache.channel = 0;
+    m_cache.lease = {false, 0, 0, 0, 0};
+    m_cache.leaseObtainedAt = 0;
+    m_cache.leaseRenewMs = 0;
+    m_staticIP = {false, 0, 0, 0, 0};
+
+    for (int i = 0; i < NETWORK_MAX_LISTENERS; i++) {
+        m_listeners[i].callback = nullptr;
+        m_listeners[i].context = nullptr;
+    }
 }
 
 NetworkService::~NetworkService() {
@@ -33,9 +62,13 @@ bool NetworkService::init() {
 
     DEBUG_PRINTLN("[NetworkService] Initializing...");
 
-    // Set Wi-Fi mode
+    // Set Wi-Fi mode; reconnects are handled here (with backoff), not by the driver
     WiFi.mode(WIFI_STA);
-    WiFi.setAutoReconnect(m_autoReconnect);
+    WiFi.setAutoReconnect(false);
+    WiFi.onEvent(onWiFiEvent);
+
+    m_initialized = true;
+    loadConnectionCache();
 
     // Load saved credentials
     String savedSSID, savedPassword;
@@ -44,7 +77,7 @@ bool NetworkService::init() {
         m_ssid = savedSSID;
         m_password = savedPassword;
         
-        // Auto-connect if credentials exist
+        // Auto-connect if credentials exist (completes in the background)
         if (m_autoReconnect) {
             DEBUG_PRINTLN("[NetworkService] Auto-connecting...");
             connect(m_ssid, m_password);
@@ -53,7 +86,6 @@ bool NetworkService::init() {
         DEBUG_PRINTLN("[NetworkService] No saved credentials found");
     }
 
-    m_initialized = true;
     DEBUG_PRINTLN("[NetworkService] Initialized");
     return true;
 }
@@ -65,49 +97,28 @@ bool NetworkService::connect(const String& ssid, const String& password, uint32_
         return false;
     }
 
-    DEBUG_PRINTF("[NetworkService] Connecting to: %s\n", ssid.c_str());
-    m_status = NetworkStatus::CONNECTING;
     m_ssid = ssid;
     m_password = password;
+    m_attemptTimeout = timeout;
+    m_failedAttempts = 0;
+    m_retryDelay = 0;
 
-    // Disconnect if already connected
-    if (WiFi.status() == WL_CONNECTED) {
-        WiFi.disconnect();
-        delay(100);
-    }
-
-    // Start connection
-    WiFi.begin(ssid.c_str(), password.c_str());
-
-    // Wait for connection
-    uint32_t startTime = millis();
-    while (WiFi.status() != WL_CONNECTED && millis() - startTime < timeout) {
-        delay(100);
-        DEBUG_PRINT(".");
-    }
-    DEBUG_PRINTLN();
-
-    if (WiFi.status() == WL_CONNECTED) {
-        m_status = NetworkStatus::CONNECTED;
-        DEBUG_PRINTLN("[NetworkService] Connected successfully!");
-        DEBUG_PRINTF("[NetworkService] IP Address: %s\n", WiFi.localIP().toString().c_str());
-        DEBUG_PRINTF("[NetworkService] Signal: %d dBm\n", WiFi.RSSI());
-        
-        // Save credentials
-        saveCredentials(ssid, password);
-        
-        return true;
-    } else {
-        m_status = NetworkStatus::FAILED;
-        DEBUG_PRINTLN("[NetworkService] Connection failed!");
-        return false;
-    }
+    startAttempt();
+    return true;
 }
 
 void NetworkService::disconnect() {
     DEBUG_PRINTLN("[NetworkService] Disconnecting...");
-    WiFi.disconnect();
+    bool wasConnected = m_status == NetworkStatus::CONNECTED;
+
+    // Set state first so the resulting driver event is not treated as a drop
     m_status = NetworkStatus::DISCONNECTED;
+    m_retryAt = 0;
+    WiFi.disconnect();
+
+    if (wasConnected) {
+        publish(NetworkEvent::DISCONNECTED);
+    }
 }
 
 bool NetworkService::isConnected() {
@@ -115,17 +126,6 @@ bool NetworkService::isConnected() {
 }
 
 NetworkStatus NetworkService::getStatus() {
-    // Update status based on WiFi status
-    if (WiFi.status() == WL_CONNECTED) {
-        m_status = NetworkStatus::CONNECTED;
-    } else if (WiFi.status() == WL_CONNECT_FAILED) {
-        m_status = NetworkStatus::FAILED;
-    } else if (WiFi.status() == WL_NO_SSID_AVAIL) {
-        m_status = NetworkStatus::NO_SSID;
-    } else if (WiFi.status() == WL_DISCONNECTED) {
-        m_status = NetworkStatus::DISCONNECTED;
-    }
-    
     return m_status;
 }
 
@@ -227,34 +227,363 @@ int NetworkService::getScanResults(WiFiNetwork* networks, int maxNetworks) {
 
 void NetworkService::setAutoReconnect(bool enable) {
     m_autoReconnect = enable;
-    WiFi.setAutoReconnect(enable);
     DEBUG_PRINTF("[NetworkService] Auto-reconnect: %s\n", enable ? "ON" : "OFF");
+
+    if (!enable && m_status == NetworkStatus::RETRY_WAIT) {
+        m_status = NetworkStatus::DISCONNECTED;
+        m_retryAt = 0;
+    } else if (enable && m_ssid.length() > 0 &&
+               (m_status == NetworkStatus::FAILED || m_status == NetworkStatus::NO_SSID)) {
+        scheduleRetry();
+    }
 }
 
 void NetworkService::update() {
     if (!m_initialized) return;
 
-    // Handle auto-reconnect
+    portENTER_CRITICAL(&s_eventMux);
+    uint32_t events = m_pendingEvents;
+    uint8_t reason = m_disconnectReason;
+    m_pendingEvents = 0;
+    portEXIT_CRITICAL(&s_eventMux);
+
+    if ((events & EVENT_GOT_IP) && m_status != NetworkStatus::CONNECTED) {
+        m_status = NetworkStatus::CONNECTED;
+        m_failedAttempts = 0;
+        m_retryDelay = 0;
+        uint32_t elapsed = millis() - m_attemptStart;
+        (m_fastAttempt ? m_fastConnects : m_fullConnects).record(elapsed);
+        DEBUG_PRINTF("[NetworkService] Connected in %lu ms (%s)\n",
+                     (unsigned long)elapsed, m_fastAttempt ? "cached AP" : "full scan");
+
+        if (m_bootToOnlineMs == 0) {
+            m_bootToOnlineMs = millis();
+            m_bootFastPath = m_fastAttempt;
+            DEBUG_PRINTF("[NetworkService] Boot to online: %lu ms\n", (unsigned long)m_bootToOnlineMs);
+        }
+        DEBUG_PRINTF("[NetworkService] IP Address: %s\n", WiFi.localIP().toString().c_str());
+        DEBUG_PRINTF("[NetworkService] Signal: %d dBm\n", WiFi.RSSI());
+
+        saveCredentials(m_ssid, m_password);
+        storeConnectionCache();
+        publish(NetworkEvent::CONNECTED);
+    } else if ((events & EVENT_GOT_IP) && !m_leaseReused) {
+        // DHCP renewed or replaced the address while connected
+        storeConnectionCache();
+    }
+
+    // A reapplied lease runs without a DHCP client; hand back to DHCP at T1
+    if (m_leaseReused && m_status == NetworkStatus::CONNECTED &&
+        millis() - m_cache.leaseObtainedAt >= m_cache.leaseRenewMs) {
+        DEBUG_PRINTLN("[NetworkService] Reused lease due for renewal, restarting DHCP");
+        m_leaseReused = false;
+        WiFi.config(INADDR_NONE, INADDR_NONE, INADDR_NONE);
+    }
+
+    if (events & EVENT_DISCONNECTED) {
+        if (m_status == NetworkStatus::CONNECTED) {
+            handleConnectionLost(reason);
+        } else if (m_status == NetworkStatus::CONNECTING && reason != WIFI_REASON_ASSOC_LEAVE) {
+            // ASSOC_LEAVE is our own disconnect before WiFi.begin()
+            handleAttemptFailed(reason);
+        }
+    }
+
+    uint32_t now = millis();
+    uint32_t timeout = m_fastAttempt ? min(m_attemptTimeout, (uint32_t)WIFI_FAST_CONNECT_TIMEOUT_MS)
+                                     : m_attemptTimeout;
+    if (m_status == NetworkStatus::CONNECTING && now - m_attemptStart >= timeout) {
+        DEBUG_PRINTLN("[NetworkService] Connection attempt timed out");
+        WiFi.disconnect();
+        handleAttemptFailed(0);
+    } else if (m_status == NetworkStatus::RETRY_WAIT && (int32_t)(now - m_retryAt) >= 0) {
+        startAttempt();
+    }
+}
+
+bool NetworkService::addListener(NetworkEventCallback callback, void* context) {
+    if (!callback) return false;
+
+    for (int i = 0; i < NETWORK_MAX_LISTENERS; i++) {
+        if (!m_listeners[i].callback) {
+            m_listeners[i].callback = callback;
+            m_listeners[i].context = context;
+            return true;
+        }
+    }
+
+    DEBUG_PRINTLN("[NetworkService] ERROR: Listener table full");
+    return false;
+}
+
+void NetworkService::removeListener(NetworkEventCallback callback, void* context) {
+    for (int i = 0; i < NETWORK_MAX_LISTENERS; i++) {
+        if (m_listeners[i].callback == callback && m_listeners[i].context == context) {
+            m_listeners[i].callback = nullptr;
+            m_listeners[i].context = nullptr;
+        }
+    }
+}
+
+uint32_t NetworkService::getRetryDelay() const {
+    if (m_status != NetworkStatus::RETRY_WAIT) return 0;
+
+    int32_t remaining = (int32_t)(m_retryAt - millis());
+    return remaining > 0 ? (uint32_t)remaining : 0;
+}
+
+void NetworkService::onWiFiEvent(arduino_event_id_t event, arduino_event_info_t info) {
+    NetworkService& self = getInstance();
+
+    // Only the latest of connect / disconnect matters to update()
+    switch (event) {
+        case ARDUINO_EVENT_WIFI_STA_GOT_IP:
+            portENTER_CRITICAL(&s_eventMux);
+            self.m_pendingEvents = (self.m_pendingEvents & ~EVENT_DISCONNECTED) | EVENT_GOT_IP;
+            portEXIT_CRITICAL(&s_eventMux);
+            break;
+
+        case ARDUINO_EVENT_WIFI_STA_DISCONNECTED:
+        case ARDUINO_EVENT_WIFI_STA_LOST_IP:
+            portENTER_CRITICAL(&s_eventMux);
+            self.m_pendingEvents = (self.m_pendingEvents & ~EVENT_GOT_IP) | EVENT_DISCONNECTED;
+            self.m_disconnectReason = (event == ARDUINO_EVENT_WIFI_STA_DISCONNECTED)
+                ? info.wifi_sta_disconnected.reason : 0;
+            portEXIT_CRITICAL(&s_eventMux);
+            break;
+
+        default:
+            break;
+    }
+}
+
+void NetworkService::startAttempt() {
+    DEBUG_PRINTF("[NetworkService] Connecting to: %s (attempt %u)\n", m_ssid.c_str(), m_failedAttempts + 1);
+
+    // Drop stale events from a previous association
+    portENTER_CRITICAL(&s_eventMux);
+    m_pendingEvents = 0;
+    portEXIT_CRITICAL(&s_eventMux);
+
+    m_status = NetworkStatus::CONNECTING;
+    m_attemptStart = millis();
+    m_retryAt = 0;
+    m_fastAttempt = WIFI_FAST_CONNECT_ENABLED && m_cache.valid && m_cache.ssid == m_ssid;
+
+    if (WiFi.status() == WL_CONNECTED) {
+        WiFi.disconnect();
+    }
+
+    m_leaseReused = false;
+    if (m_staticIP.valid) {
+        applyIPConfig(m_staticIP);
+    } else if (m_fastAttempt && WIFI_REUSE_DHCP_LEASE && isLeaseReusable()) {
+        applyIPConfig(m_cache.lease);
+        m_leaseReused = true;
+    } else {
+        WiFi.config(INADDR_NONE, INADDR_NONE, INADDR_NONE);
+    }
+
+    if (m_fastAttempt) {
+        // Directed association: no scan, straight to the last AP
+        WiFi.begin(m_ssid.c_str(), m_password.c_str(), m_cache.channel, m_cache.bssid);
+    } else {
+        WiFi.begin(m_ssid.c_str(), m_password.c_str());
+    }
+
+    publish(NetworkEvent::CONNECTING);
+}
+
+void NetworkService::handleAttemptFailed(uint8_t reason) {
+    if (m_fastAttempt) {
+        // AP moved, changed channel or the lease went stale; not a real failure
+        DEBUG_PRINTF("[NetworkService] Cached AP failed (reason %u), falling back to full scan\n", reason);
+        clearConnectionCache();
+        startAttempt();
+        return;
+    }
+
+    m_failedAttempts++;
+    m_status = (reason == WIFI_REASON_NO_AP_FOUND) ? NetworkStatus::NO_SSID : NetworkStatus::FAILED;
+    DEBUG_PRINTF("[NetworkService] Connection failed (reason %u, %u consecutive)\n", reason, m_failedAttempts);
+
+    publish(NetworkEvent::CONNECT_FAILED);
+
     if (m_autoReconnect) {
-        handleAutoReconnect();
+        scheduleRetry();
+    }
+}
+
+void NetworkService::handleConnectionLost(uint8_t reason) {
+    DEBUG_PRINTF("[NetworkService] Connection lost (reason %u)\n", reason);
+    m_status = NetworkStatus::DISCONNECTED;
+
+    // A drop from a working link retries quickly; backoff grows from there
+    m_retryDelay = 0;
+    publish(NetworkEvent::DISCONNECTED);
+
+    if (m_autoReconnect) {
+        scheduleRetry();
+    }
+}
+
+void NetworkService::scheduleRetry() {
+    if (m_ssid.length() == 0) return;
+
+    m_retryDelay = (m_retryDelay == 0) ? WIFI_RETRY_MIN_MS : min((uint32_t)WIFI_RETRY_MAX_MS, m_retryDelay * 2);
+
+    // Jitter keeps several devices from hammering a recovering AP in lockstep
+    uint32_t span = m_retryDelay * WIFI_RETRY_JITTER / 100;
+    uint32_t delayMs = m_retryDelay - span + (esp_random() % (2 * span + 1));
+
+    m_retryAt = millis() + delayMs;
+    m_status = NetworkStatus::RETRY_WAIT;
+    DEBUG_PRINTF("[NetworkService] Retrying in %lu ms\n", (unsigned long)delayMs);
+
+    publish(NetworkEvent::RETRY_SCHEDULED);
+}
+
+void NetworkService::setStaticIP(const IPAddress& ip, const IPAddress& gateway,
+                                 const IPAddress& subnet, const IPAddress& dns) {
+    m_staticIP = {true, (uint32_t)ip, (uint32_t)gateway, (uint32_t)subnet, (uint32_t)dns};
+
+    Preferences prefs;
+    if (prefs.begin(WIFI_NVS_NAMESPACE, false)) {
+        prefs.putUInt("s_ip", m_staticIP.ip);
+        prefs.putUInt("s_gw", m_staticIP.gateway);
+        prefs.putUInt("s_mask", m_staticIP.subnet);
+        prefs.putUInt("s_dns", m_staticIP.dns);
+        prefs.end();
     }
 
-    // Update status
-    getStatus();
+    DEBUG_PRINTF("[NetworkService] Static IP: %s\n", ip.toString().c_str());
+}
+
+void NetworkService::clearStaticIP() {
+    m_staticIP.valid = false;
+
+    Preferences prefs;
+    if (prefs.begin(WIFI_NVS_NAMESPACE, false)) {
+        prefs.remove("s_ip");
+        prefs.end();
+    }
+
+    DEBUG_PRINTLN("[NetworkService] Static IP cleared, using DHCP");
+}
+
+void NetworkService::clearConnectionCache() {
+    if (!m_cache.valid) return;
+    m_cache.valid = false;
+    m_cache.lease.valid = false;
+
+    Preferences prefs;
+    if (prefs.begin(WIFI_NVS_NAMESPACE, false)) {
+        prefs.remove("ssid");
+        prefs.remove("ip");
+        prefs.end();
+    }
 }
 
-void NetworkService::handleAutoReconnect() {
-    // Only try to reconnect if disconnected and credentials exist
-    if (isConnected() || m_ssid.length() == 0) {
+void NetworkService::loadConnectionCache() {
+    Preferences prefs;
+    if (!prefs.begin(WIFI_NVS_NAMESPACE, true)) {
+        return;  // Namespace doesn't exist until the first connection
+    }
+
+    m_cache.ssid = prefs.getString("ssid", "");
+    m_cache.valid = m_cache.ssid.length() > 0 &&
+                    prefs.getBytes("bssid", m_cache.bssid, sizeof(m_cache.bssid)) == sizeof(m_cache.bssid);
+    m_cache.channel = prefs.getUChar("chan", 0);
+
+    // No lease: its age across the reboot is unknown
+    m_cache.lease.valid = false;
+
+    m_staticIP.ip = prefs.getUInt("s_ip", 0);
+    m_staticIP.gateway = prefs.getUInt("s_gw", 0);
+    m_staticIP.subnet = prefs.getUInt("s_mask", 0);
+    m_staticIP.dns = prefs.getUInt("s_dns", 0);
+    m_staticIP.valid = m_staticIP.ip != 0;
+
+    prefs.end();
+
+    if (m_cache.valid) {
+        DEBUG_PRINTF("[NetworkService] Cached AP for %s on channel %u\n", m_cache.ssid.c_str(), m_cache.channel);
+    }
+}
+
+void NetworkService::storeConnectionCache() {
+    ConnectionCache current;
+    current.valid = true;
+    current.ssid = m_ssid;
+    memcpy(current.bssid, WiFi.BSSID(), sizeof(current.bssid));
+    current.channel = (uint8_t)WiFi.channel();
+    current.lease = {false, 0, 0, 0, 0};
+    current.leaseObtainedAt = 0;
+    current.leaseRenewMs = 0;
+
+    if (m_leaseReused) {
+        // Same grant as before, not a new one: keep its original age
+        current.lease = m_cache.lease;
+        current.leaseObtainedAt = m_cache.leaseObtainedAt;
+        current.leaseRenewMs = m_cache.leaseRenewMs;
+    } else if (!m_staticIP.valid) {
+        // A static configuration isn't a lease worth remembering
+        current.lease = {true, (uint32_t)WiFi.localIP(), (uint32_t)WiFi.gatewayIP(),
+                         (uint32_t)WiFi.subnetMask(), (uint32_t)WiFi.dnsIP(0)};
+        current.leaseObtainedAt = millis();
+        current.leaseRenewMs = WIFI_LEASE_REUSE_MAX_MS;
+
+        // T1 as granted by the server (seconds), when lwIP has it
+        esp_netif_t* sta = esp_netif_get_handle_from_ifkey("WIFI_STA_DEF");
+        struct netif* netif = sta ? (struct netif*)esp_netif_get_netif_impl(sta) : nullptr;
+        struct dhcp* dhcp = netif ? netif_dhcp_data(netif) : nullptr;
+        if (dhcp && dhcp->offered_t1_renew > 0 && dhcp->offered_t1_renew < WIFI_LEASE_REUSE_MAX_MS / 1000) {
+            current.leaseRenewMs = dhcp->offered_t1_renew * 1000UL;
+        }
+    }
+
+    // Skip the flash write when the AP didn't change (the common case)
+    bool unchanged = m_cache.valid && m_cache.ssid == current.ssid &&
+                     memcmp(m_cache.bssid, current.bssid, sizeof(current.bssid)) == 0 &&
+                     m_cache.channel == current.channel;
+    m_cache.lease = current.lease;
+    m_cache.leaseObtainedAt = current.leaseObtainedAt;
+    m_cache.leaseRenewMs = current.leaseRenewMs;
+    if (unchanged) {
         return;
     }
 
-    uint32_t currentTime = millis();
-    if (currentTime - m_lastReconnectAttempt >= m_reconnectInterval) {
-        m_lastReconnectAttempt = currentTime;
-        
-        DEBUG_PRINTLN("[NetworkService] Auto-reconnect attempt...");
-        connect(m_ssid, m_password, 10000);  // 10 second timeout
+    Preferences prefs;
+    if (!prefs.begin(WIFI_NVS_NAMESPACE, false)) {
+        DEBUG_PRINTLN("[NetworkService] ERROR: Cannot open NVS for connection cache");
+        return;
+    }
+
+    prefs.putString("ssid", current.ssid);
+    prefs.putBytes("bssid", current.bssid, sizeof(current.bssid));
+    prefs.putUChar("chan", current.channel);
+    prefs.end();
+
+    m_cache = current;
+    DEBUG_PRINTF("[NetworkService] Cached AP %02X:%02X:%02X:%02X:%02X:%02X on channel %u\n",
+                 current.bssid[0], current.bssid[1], current.bssid[2],
+                 current.bssid[3], current.bssid[4], current.bssid[5], current.channel);
+}
+
+bool NetworkService::isLeaseReusable() const {
+    return m_cache.lease.valid && millis() - m_cache.leaseObtainedAt < m_cache.leaseRenewMs;
+}
+
+void NetworkService::applyIPConfig(const IPConfig& config) {
+    WiFi.config(IPAddress(config.ip), IPAddress(config.gateway),
+                IPAddress(config.subnet), IPAddress(config.dns));
+}
+
+void NetworkService::publish(NetworkEvent event) {
+    for (int i = 0; i < NETWORK_MAX_LISTENERS; i++) {
+        if (m_listeners[i].callback) {
+            m_listeners[i].callback(event, m_listeners[i].context);
+        }
     }
 }
 
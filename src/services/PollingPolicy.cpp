@@ -0,0 +1,129 @@
+/**
+ * @file PollingPolicy.cpp
+ * @brief Implementation of PollingPolicy and PollSchedule
+ */
+
+#include "services/PollingPolicy.h"
+#include "controllers/NavigationController.h"
+#include "hardware/display/DisplayDriver.h"
+#include "hardware/power/BatteryMonitor.h"
+
+PollingPolicy& PollingPolicy::getInstance() {
+    static PollingPolicy instance;
+    return instance;
+}
+
+PollingPolicy::PollingPolicy()
+    : m_currentRoute("")
+    , m_screenOn(true)
+    , m_batteryScale(1.0f)
+    , m_lastUpdate(0) {
+}
+
+void PollingPolicy::update() {
+    uint32_t currentTime = millis();
+    if (m_lastUpdate != 0 && currentTime - m_lastUpdate < POLL_CONTEXT_REFRESH_MS) {
+        return;
+    }
+    m_lastUpdate = currentTime;
+
+    Route* route = NavigationController::getInstance().getCurrentRoute();
+    m_currentRoute = route ? route->path : "";
+
+    m_screenOn = DisplayDriver::getInstance().getBrightness() > 0 && m_currentRoute != "/lock";
+
+    BatteryMonitor& battery = BatteryMonitor::getInstance();
+    if (battery.isCharging()) {
+        m_batteryScale = 1.0f;
+    } else if (battery.isBatteryCritical()) {
+        m_batteryScale = POLL_BATTERY_CRITICAL_FACTOR;
+    } else if (battery.isBatteryLow()) {
+        m_batteryScale = POLL_BATTERY_LOW_FACTOR;
+    } else {
+        m_batteryScale = 1.0f;
+    }
+}
+
+bool PollingPolicy::isVisible(const char* routePath) const {
+    return m_screenOn && routePath && m_currentRoute == routePath;
+}
+
+float PollingPolicy::getScale(const char* routePath) const {
+    float scale;
+    if (!m_screenOn) {
+        scale = POLL_SCREEN_OFF_FACTOR;
+    } else if (isVisible(routePath)) {
+        scale = 1.0f;
+    } else {
+        scale = POLL_HIDDEN_FACTOR;
+    }
+    return scale * m_batteryScale;
+}
+
+PollSchedule::PollSchedule(const char* routePath, uint32_t baseIntervalMs,
+                           uint32_t minIntervalMs, uint32_t maxIntervalMs)
+    : m_routePath(routePath)
+    , m_baseInterval(baseIntervalMs)
+    , m_minInterval(minIntervalMs)
+    , m_maxInterval(maxIntervalMs)
+    , m_lastStart(0)
+    , m_hintAt(0)
+    , m_hasHint(false)
+    , m_started(false)
+    , m_changeRate(0.5f) {
+}
+
+bool PollSchedule::isDue() const {
+    if (!m_started) return true;
+
+    uint32_t currentTime = millis();
+    if (m_hasHint && (int32_t)(currentTime - m_hintAt) >= 0) {
+        return true;
+    }
+    return currentTime - m_lastStart >= getInterval();
+}
+
+void PollSchedule::start() {
+    m_lastStart = millis();
+    m_hasHint = false;
+    m_started = true;
+}
+
+void PollSchedule::recordResult(bool changed) {
+    m_changeRate += POLL_CHANGE_SMOOTHING * ((changed ? 1.0f : 0.0f) - m_changeRate);
+}
+
+void PollSchedule::pollAt(uint32_t delayMs) {
+    uint32_t at = millis() + delayMs;
+    if (!m_hasHint || (int32_t)(at - m_hintAt) < 0) {
+        m_hintAt = at;
+        m_hasHint = true;
+    }
+}
+
+void PollSchedule::pollNow() {
+    m_hintAt = millis();
+    m_hasHint = true;
+}
+
+uint32_t PollSchedule::getInterval() const {
+    // 0.5 is the neutral change rate: quieter data is polled up to
+    // POLL_IDLE_FACTOR slower, busier data up to POLL_ACTIVE_FACTOR faster
+    float activity;
+    if (m_changeRate < 0.5f) {
+        activity = POLL_IDLE_FACTOR + (1.0f - POLL_IDLE_FACTOR) * (m_changeRate * 2.0f);
+    } else {
+        activity = 1.0f + (POLL_ACTIVE_FACTOR - 1.0f) * ((m_changeRate - 0.5f) * 2.0f);
+    }
+
+    float interval = m_baseInterval * activity;
+    interval = constrain(interval, (float)m_minInterval, (float)m_maxInterval);
+
+    // Context scaling may go past the per-resource maximum (nobody is looking)
+    interval *= PollingPolicy::getInstance().getScale(m_routePath);
+    return (uint32_t)min(interval, (float)POLL_ABSOLUTE_MAX_MS);
+}
+
+bool PollSchedule::isVisible() const {
+    return PollingPolicy::getInstance().isVisible(m_routePath);
+}
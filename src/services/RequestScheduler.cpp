@@ -0,0 +1,185 @@
+/**
+ * @file RequestScheduler.cpp
+ * @brief Implementation of RequestScheduler
+ */
+
+#include "services/RequestScheduler.h"
+
+RequestScheduler& RequestScheduler::getInstance() {
+    static RequestScheduler instance;
+    return instance;
+}
+
+RequestScheduler::RequestScheduler()
+    : m_sequence(0) {
+    memset(m_jobs, 0, sizeof(m_jobs));
+    memset(m_stats, 0, sizeof(m_stats));
+}
+
+bool RequestScheduler::submit(RequestPriority priority, ScheduledRequestFunction function, void* context,
+                              const char* key, uint32_t deadlineMs) {
+    if (!function) return false;
+
+    RequestClassStats& stats = m_stats[(int)priority];
+    uint32_t now = millis();
+
+    Job* job = findJob(key);
+    if (job) {
+        // Keep the original queue position; a more urgent resubmit promotes the job
+        job->function = function;
+        job->context = context;
+        if (priority < job->priority) {
+            job->priority = priority;
+        }
+        job->deadline = deadlineMs > 0 ? now + deadlineMs : 0;
+        stats.coalesced++;
+        return true;
+    }
+
+    job = allocateJob(priority);
+    if (!job) {
+        stats.rejected++;
+        DEBUG_PRINTF("[RequestScheduler] Queue full, rejected %s job %s\n",
+                     getPriorityName(priority), key ? key : "");
+        return false;
+    }
+
+    job->used = true;
+    job->priority = priority;
+    job->function = function;
+    job->context = context;
+    job->key = key;
+    job->sequence = ++m_sequence;
+    job->enqueuedAt = now;
+    job->deadline = deadlineMs > 0 ? now + deadlineMs : 0;
+    stats.submitted++;
+    return true;
+}
+
+bool RequestScheduler::cancel(const char* key) {
+    Job* job = findJob(key);
+    if (!job) return false;
+
+    job->used = false;
+    return true;
+}
+
+bool RequestScheduler::isQueued(const char* key) const {
+    return const_cast<RequestScheduler*>(this)->findJob(key) != nullptr;
+}
+
+void RequestScheduler::update() {
+    expireJobs();
+
+    // Every waiting command goes out this frame, ahead of any poll
+    bool ranInteractive = false;
+    Job* job;
+    while ((job = nextJob(true)) != nullptr) {
+        run(job);
+        ranInteractive = true;
+    }
+
+    // At most one poll per frame, and none on a frame that already sent commands
+    if (!ranInteractive && (job = nextJob(false)) != nullptr) {
+        run(job);
+    }
+}
+
+uint8_t RequestScheduler::getQueuedCount(RequestPriority priority) const {
+    uint8_t count = 0;
+    for (int i = 0; i < REQUEST_QUEUE_SIZE; i++) {
+        if (m_jobs[i].used && m_jobs[i].priority == priority) {
+            count++;
+        }
+    }
+    return count;
+}
+
+const char* RequestScheduler::getPriorityName(RequestPriority priority) {
+    switch (priority) {
+        case RequestPriority::INTERACTIVE: return "interactive";
+        case RequestPriority::VISIBLE:     return "visible";
+        case RequestPriority::BACKGROUND:  return "background";
+    }
+    return "unknown";
+}
+
+RequestScheduler::Job* RequestScheduler::findJob(const char* key) {
+    if (!key) return nullptr;
+
+    for (int i = 0; i < REQUEST_QUEUE_SIZE; i++) {
+        if (m_jobs[i].used && m_jobs[i].key && strcmp(m_jobs[i].key, key) == 0) {
+            return &m_jobs[i];
+        }
+    }
+    return nullptr;
+}
+
+RequestScheduler::Job* RequestScheduler::nextJob(bool interactiveOnly) {
+    Job* best = nullptr;
+    for (int i = 0; i < REQUEST_QUEUE_SIZE; i++) {
+        Job& job = m_jobs[i];
+        if (!job.used) continue;
+        if (interactiveOnly && job.priority != RequestPriority::INTERACTIVE) continue;
+
+        if (!best || job.priority < best->priority ||
+            (job.priority == best->priority && job.sequence < best->sequence)) {
+            best = &job;
+        }
+    }
+    return best;
+}
+
+RequestScheduler::Job* RequestScheduler::allocateJob(RequestPriority priority) {
+    for (int i = 0; i < REQUEST_QUEUE_SIZE; i++) {
+        if (!m_jobs[i].used) {
+            return &m_jobs[i];
+        }
+    }
+
+    // Full: a more important job displaces the newest background poll
+    if (priority == RequestPriority::BACKGROUND) {
+        return nullptr;
+    }
+
+    Job* victim = nullptr;
+    for (int i = 0; i < REQUEST_QUEUE_SIZE; i++) {
+        Job& job = m_jobs[i];
+        if (job.priority == RequestPriority::BACKGROUND && (!victim || job.sequence > victim->sequence)) {
+            victim = &job;
+        }
+    }
+
+    if (victim) {
+        m_stats[(int)RequestPriority::BACKGROUND].expired++;
+        victim->used = false;
+    }
+    return victim;
+}
+
+void RequestScheduler::expireJobs() {
+    uint32_t now = millis();
+    for (int i = 0; i < REQUEST_QUEUE_SIZE; i++) {
+        Job& job = m_jobs[i];
+        if (job.used && job.deadline != 0 && (int32_t)(now - job.deadline) >= 0) {
+            DEBUG_PRINTF("[RequestScheduler] Dropped stale %s job %s\n",
+                         getPriorityName(job.priority), job.key ? job.key : "");
+            m_stats[(int)job.priority].expired++;
+            job.used = false;
+        }
+    }
+}
+
+void RequestScheduler::run(Job* job) {
+    // Copy out and free the slot first: the function may resubmit its own key
+    Job current = *job;
+    job->used = false;
+
+    int index = (int)current.priority;
+    m_queueWait[index].record(millis() - current.enqueuedAt);
+    m_stats[index].executed++;
+
+    if (!current.function(current.context)) {
+        m_stats[index].failed++;
+    }
+}
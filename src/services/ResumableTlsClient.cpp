@@ -0,0 +1,165 @@
+/**
+ * @file ResumableTlsClient.cpp
+ * @brief Implementation of ResumableTlsClient
+ */
+
+#include "services/ResumableTlsClient.h"
+#include "services/TlsSessionCache.h"
+#include "config/Config.h"
+#include <WiFi.h>
+#include <lwip/sockets.h>
+#include <lwip/netdb.h>
+#include "mbedtls/net_sockets.h"
+#include "ssl_client.h"
+
+static const char* DRBG_PERSONALIZATION = "esp-assistant-tls";
+
+ResumableTlsClient::ResumableTlsClient()
+    : WiFiClientSecure()
+    , m_resumed(false)
+    , m_lastHandshakeMs(0) {
+}
+
+int ResumableTlsClient::connect(const char* host, uint16_t port) {
+    return connect(host, port, HTTP_TIMEOUT_MS);
+}
+
+int ResumableTlsClient::connect(const char* host, uint16_t port, int32_t timeout) {
+    IPAddress address;
+    if (!WiFi.hostByName(host, address)) {
+        DEBUG_PRINTF("[ResumableTlsClient] DNS lookup failed: %s\n", host);
+        return 0;
+    }
+
+    // Release any previous session state before reusing the context
+    stop();
+
+    m_resumed = false;
+    uint32_t startTime = millis();
+    int ret = startSession(address, port, host, timeout);
+    m_lastHandshakeMs = millis() - startTime;
+
+    if (ret != 0) {
+        DEBUG_PRINTF("[ResumableTlsClient] Handshake with %s failed: -0x%04x\n", host, ret < 0 ? -ret : ret);
+        stop();
+        return 0;
+    }
+
+    _connected = true;
+    return 1;
+}
+
+int ResumableTlsClient::startSession(const IPAddress& ip, uint16_t port, const char* host, int32_t timeout) {
+    sslclient_context* ctx = sslclient;
+    if (timeout <= 0) {
+        timeout = HTTP_TIMEOUT_MS;
+    }
+
+    mbedtls_ssl_init(&ctx->ssl_ctx);
+    mbedtls_ssl_config_init(&ctx->ssl_conf);
+    mbedtls_ctr_drbg_init(&ctx->drbg_ctx);
+    mbedtls_entropy_init(&ctx->entropy_ctx);
+
+    // TCP connect with timeout (non-blocking connect + select)
+    ctx->socket = lwip_socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (ctx->socket < 0) {
+        return -1;
+    }
+
+    fcntl(ctx->socket, F_SETFL, fcntl(ctx->socket, F_GETFL, 0) | O_NONBLOCK);
+
+    struct sockaddr_in serverAddr;
+    memset(&serverAddr, 0, sizeof(serverAddr));
+    serverAddr.sin_family = AF_INET;
+    serverAddr.sin_addr.s_addr = (uint32_t)ip;
+    serverAddr.sin_port = htons(port);
+
+    int ret = lwip_connect(ctx->socket, (struct sockaddr*)&serverAddr, sizeof(serverAddr));
+    if (ret < 0 && errno != EINPROGRESS) {
+        return -1;
+    }
+
+    fd_set fdset;
+    FD_ZERO(&fdset);
+    FD_SET(ctx->socket, &fdset);
+    struct timeval tv;
+    tv.tv_sec = timeout / 1000;
+    tv.tv_usec = (timeout % 1000) * 1000;
+    if (lwip_select(ctx->socket + 1, nullptr, &fdset, nullptr, &tv) <= 0) {
+        return -1;
+    }
+
+    lwip_setsockopt(ctx->socket, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    lwip_setsockopt(ctx->socket, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+    int enable = 1;
+    lwip_setsockopt(ctx->socket, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+    lwip_setsockopt(ctx->socket, SOL_SOCKET, SO_KEEPALIVE, &enable, sizeof(enable));
+    fcntl(ctx->socket, F_SETFL, fcntl(ctx->socket, F_GETFL, 0) & ~O_NONBLOCK);
+
+    // TLS configuration
+    ret = mbedtls_ctr_drbg_seed(&ctx->drbg_ctx, mbedtls_entropy_func, &ctx->entropy_ctx,
+                                (const unsigned char*)DRBG_PERSONALIZATION, strlen(DRBG_PERSONALIZATION));
+    if (ret != 0) return ret;
+
+    ret = mbedtls_ssl_config_defaults(&ctx->ssl_conf, MBEDTLS_SSL_IS_CLIENT,
+                                      MBEDTLS_SSL_TRANSPORT_STREAM, MBEDTLS_SSL_PRESET_DEFAULT);
+    if (ret != 0) return ret;
+
+    // Trust model: the server certificate is not verified (as with the
+    // plain HTTPClient::begin(url) this client replaced), so traffic is
+    // encrypted but the peer is not authenticated. Anyone who can intercept
+    // the Wi-Fi or upstream path can impersonate an API host and read the
+    // bearer tokens sent to it. Resumption doesn't change this: a session is
+    // only offered to the host:port it was negotiated with.
+    mbedtls_ssl_conf_authmode(&ctx->ssl_conf, MBEDTLS_SSL_VERIFY_NONE);
+    mbedtls_ssl_conf_rng(&ctx->ssl_conf, mbedtls_ctr_drbg_random, &ctx->drbg_ctx);
+    mbedtls_ssl_conf_session_tickets(&ctx->ssl_conf, MBEDTLS_SSL_SESSION_TICKETS_ENABLED);
+
+    ret = mbedtls_ssl_setup(&ctx->ssl_ctx, &ctx->ssl_conf);
+    if (ret != 0) return ret;
+
+    ret = mbedtls_ssl_set_hostname(&ctx->ssl_ctx, host);
+    if (ret != 0) return ret;
+
+    // Offer the cached session (ticket or session ID) for an abbreviated handshake
+    mbedtls_ssl_session offered;
+    mbedtls_ssl_session_init(&offered);
+    bool hasOffer = TlsSessionCache::getInstance().load(host, port, &offered) &&
+                    mbedtls_ssl_set_session(&ctx->ssl_ctx, &offered) == 0;
+
+    mbedtls_ssl_set_bio(&ctx->ssl_ctx, &ctx->socket, mbedtls_net_send, mbedtls_net_recv, nullptr);
+
+    uint32_t handshakeStart = millis();
+    while ((ret = mbedtls_ssl_handshake(&ctx->ssl_ctx)) != 0) {
+        if (ret != MBEDTLS_ERR_SSL_WANT_READ && ret != MBEDTLS_ERR_SSL_WANT_WRITE) {
+            break;
+        }
+        if (millis() - handshakeStart > (uint32_t)timeout) {
+            ret = MBEDTLS_ERR_SSL_TIMEOUT;
+            break;
+        }
+        vTaskDelay(2);
+    }
+
+    if (ret != 0) {
+        if (hasOffer) {
+            // Don't keep offering a session the server chokes on
+            TlsSessionCache::getInstance().invalidate(host, port);
+        }
+        mbedtls_ssl_session_free(&offered);
+        return ret;
+    }
+
+    // The server resumed if it echoed the session ID we offered
+    mbedtls_ssl_session negotiated;
+    mbedtls_ssl_session_init(&negotiated);
+    if (mbedtls_ssl_get_session(&ctx->ssl_ctx, &negotiated) == 0) {
+        m_resumed = hasOffer && offered.id_len > 0 && negotiated.id_len == offered.id_len &&
+                    memcmp(negotiated.id, offered.id, offered.id_len) == 0;
+        TlsSessionCache::getInstance().store(host, port, &negotiated);
+    }
+
+    mbedtls_ssl_session_free(&negotiated);
+    mbedtls_ssl_session_free(&offered);
+    return 0;
+}
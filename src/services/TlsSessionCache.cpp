@@ -0,0 +1,339 @@
+/**
+ * @file TlsSessionCache.cpp
+ * @brief Implementation of TlsSessionCache
+ */
+
+#include "services/TlsSessionCache.h"
+#include "hardware/storage/SDCardDriver.h"
+#include "utils/CryptoUtils.h"
+#include <Preferences.h>
+
+static const char* CACHE_DIR = "/cache";
+static const char* CACHE_FILE = "/cache/tls_sessions.dat";
+static const char* CACHE_KEY_SALT = "esp_assistant_tls_cache_v2";
+
+TlsSessionCache& TlsSessionCache::getInstance() {
+    static TlsSessionCache instance;
+    return instance;
+}
+
+TlsSessionCache::TlsSessionCache()
+    : m_persistent(TLS_SESSION_PERSIST != 0)
+    , m_dirty(false)
+    , m_lastPersist(0)
+    , m_keyReady(false)
+    , m_initialized(false) {
+    for (int i = 0; i < TLS_SESSION_CACHE_SIZE; i++) {
+        m_entries[i].host = "";
+        m_entries[i].port = 0;
+        m_entries[i].data = nullptr;
+        m_entries[i].length = 0;
+        m_entries[i].storedAt = 0;
+    }
+    memset(m_storageKey, 0, sizeof(m_storageKey));
+}
+
+TlsSessionCache::~TlsSessionCache() {
+    clear();
+    memset(m_storageKey, 0, sizeof(m_storageKey));
+}
+
+bool TlsSessionCache::init() {
+    if (m_initialized) {
+        return true;
+    }
+
+    DEBUG_PRINTLN("[TlsSessionCache] Initializing...");
+
+    if (m_persistent && SDCardDriver::getInstance().isMounted()) {
+        restore();
+    }
+
+    m_initialized = true;
+    DEBUG_PRINTLN("[TlsSessionCache] Initialized");
+    return true;
+}
+
+bool TlsSessionCache::load(const char* host, uint16_t port, mbedtls_ssl_session* session) {
+    Entry* entry = findEntry(host, port);
+    if (!entry) {
+        return false;
+    }
+
+    if (millis() - entry->storedAt >= TLS_SESSION_TTL_MS) {
+        DEBUG_PRINTF("[TlsSessionCache] Session for %s expired\n", host);
+        freeEntry(*entry);
+        m_dirty = true;
+        return false;
+    }
+
+    int ret = mbedtls_ssl_session_load(session, entry->data, entry->length);
+    if (ret != 0) {
+        DEBUG_PRINTF("[TlsSessionCache] Failed to load session for %s: -0x%04x\n", host, -ret);
+        freeEntry(*entry);
+        m_dirty = true;
+        return false;
+    }
+
+    return true;
+}
+
+void TlsSessionCache::store(const char* host, uint16_t port, const mbedtls_ssl_session* session) {
+    // Query serialized size first
+    size_t length = 0;
+    int ret = mbedtls_ssl_session_save(session, nullptr, 0, &length);
+    if (ret != MBEDTLS_ERR_SSL_BUFFER_TOO_SMALL || length == 0 || length > TLS_SESSION_MAX_BYTES) {
+        DEBUG_PRINTF("[TlsSessionCache] Session for %s not cacheable (%u bytes)\n", host, (unsigned)length);
+        return;
+    }
+
+    uint8_t* data = (uint8_t*)malloc(length);
+    if (!data) {
+        return;
+    }
+
+    ret = mbedtls_ssl_session_save(session, data, length, &length);
+    if (ret != 0) {
+        free(data);
+        return;
+    }
+
+    // Reuse the host's slot, otherwise replace the oldest entry
+    Entry* slot = findEntry(host, port);
+    if (!slot) {
+        slot = &m_entries[0];
+        for (int i = 0; i < TLS_SESSION_CACHE_SIZE; i++) {
+            if (!m_entries[i].data) {
+                slot = &m_entries[i];
+                break;
+            }
+            if (m_entries[i].storedAt < slot->storedAt) {
+                slot = &m_entries[i];
+            }
+        }
+    }
+
+    freeEntry(*slot);
+    slot->host = host;
+    slot->port = port;
+    slot->data = data;
+    slot->length = length;
+    slot->storedAt = millis();
+    m_dirty = true;
+}
+
+void TlsSessionCache::invalidate(const char* host, uint16_t port) {
+    Entry* entry = findEntry(host, port);
+    if (entry) {
+        freeEntry(*entry);
+        m_dirty = true;
+    }
+}
+
+void TlsSessionCache::clear() {
+    for (int i = 0; i < TLS_SESSION_CACHE_SIZE; i++) {
+        freeEntry(m_entries[i]);
+    }
+    m_dirty = true;
+}
+
+void TlsSessionCache::update() {
+    if (!m_initialized || !m_persistent || !m_dirty) {
+        return;
+    }
+
+    // Batch writes so a burst of reconnects doesn't hammer the SD card
+    uint32_t currentTime = millis();
+    if (currentTime - m_lastPersist < TLS_SESSION_PERSIST_INTERVAL_MS) {
+        return;
+    }
+
+    m_lastPersist = currentTime;
+    if (persist()) {
+        m_dirty = false;
+    }
+}
+
+TlsSessionCache::Entry* TlsSessionCache::findEntry(const char* host, uint16_t port) {
+    for (int i = 0; i < TLS_SESSION_CACHE_SIZE; i++) {
+        if (m_entries[i].data && m_entries[i].port == port && m_entries[i].host == host) {
+            return &m_entries[i];
+        }
+    }
+    return nullptr;
+}
+
+void TlsSessionCache::freeEntry(Entry& entry) {
+    if (entry.data) {
+        // Session data holds the master secret - wipe before releasing
+        memset(entry.data, 0, entry.length);
+        free(entry.data);
+    }
+    entry.host = "";
+    entry.port = 0;
+    entry.data = nullptr;
+    entry.length = 0;
+    entry.storedAt = 0;
+}
+
+bool TlsSessionCache::persist() {
+    SDCardDriver& sd = SDCardDriver::getInstance();
+    if (!sd.isMounted()) {
+        return false;
+    }
+
+    // One line per session: "<host> <port> <remaining ttl ms> <base64 session>"
+    String plaintext = "";
+    uint32_t currentTime = millis();
+    for (int i = 0; i < TLS_SESSION_CACHE_SIZE; i++) {
+        const Entry& entry = m_entries[i];
+        if (!entry.data) continue;
+        uint32_t age = currentTime - entry.storedAt;
+        if (age >= TLS_SESSION_TTL_MS) continue;
+        plaintext += entry.host + " " + String(entry.port) + " " + String(TLS_SESSION_TTL_MS - age) + " " +
+                     CryptoUtils::base64Encode(entry.data, entry.length) + "\n";
+    }
+
+    if (plaintext.length() == 0) {
+        sd.deleteFile(CACHE_FILE);
+        return true;
+    }
+
+    uint8_t key[32];
+    if (!deriveStorageKey(key)) {
+        return false;
+    }
+
+    String ciphertext;
+    bool encrypted = CryptoUtils::encrypt(plaintext, key, ciphertext);
+    memset(key, 0, sizeof(key));
+    if (!encrypted) {
+        DEBUG_PRINTLN("[TlsSessionCache] Failed to encrypt sessions");
+        return false;
+    }
+
+    if (!sd.dirExists(CACHE_DIR)) {
+        sd.createDir(CACHE_DIR);
+    }
+
+    if (!sd.writeFile(CACHE_FILE, ciphertext)) {
+        DEBUG_PRINTLN("[TlsSessionCache] Failed to write session file");
+        return false;
+    }
+
+    DEBUG_PRINTLN("[TlsSessionCache] Sessions persisted");
+    return true;
+}
+
+bool TlsSessionCache::restore() {
+    SDCardDriver& sd = SDCardDriver::getInstance();
+    if (!sd.fileExists(CACHE_FILE)) {
+        return false;
+    }
+
+    String ciphertext = sd.readFile(CACHE_FILE);
+    if (ciphertext.length() == 0) {
+        return false;
+    }
+
+    uint8_t key[32];
+    if (!deriveStorageKey(key)) {
+        return false;
+    }
+
+    String plaintext;
+    bool decrypted = CryptoUtils::decrypt(ciphertext, key, plaintext);
+    memset(key, 0, sizeof(key));
+    if (!decrypted) {
+        DEBUG_PRINTLN("[TlsSessionCache] Failed to decrypt session file, discarding");
+        sd.deleteFile(CACHE_FILE);
+        return false;
+    }
+
+    int restored = 0;
+    int lineStart = 0;
+    while (lineStart < (int)plaintext.length() && restored < TLS_SESSION_CACHE_SIZE) {
+        int lineEnd = plaintext.indexOf('\n', lineStart);
+        if (lineEnd < 0) lineEnd = plaintext.length();
+
+        String line = plaintext.substring(lineStart, lineEnd);
+        lineStart = lineEnd + 1;
+
+        int firstSpace = line.indexOf(' ');
+        int secondSpace = line.indexOf(' ', firstSpace + 1);
+        int thirdSpace = line.indexOf(' ', secondSpace + 1);
+        if (firstSpace <= 0 || secondSpace <= firstSpace || thirdSpace <= secondSpace) continue;
+
+        // Time spent powered off isn't known, so this is an upper bound;
+        // the server still rejects a ticket it considers stale
+        uint32_t remaining = (uint32_t)line.substring(secondSpace + 1, thirdSpace).toInt();
+        if (remaining == 0 || remaining > TLS_SESSION_TTL_MS) continue;
+
+        String encoded = line.substring(thirdSpace + 1);
+        size_t maxLength = (encoded.length() * 3) / 4;
+        if (maxLength == 0 || maxLength > TLS_SESSION_MAX_BYTES) continue;
+
+        uint8_t* data = (uint8_t*)malloc(maxLength);
+        if (!data) break;
+
+        int length = CryptoUtils::base64Decode(encoded, data, maxLength);
+        if (length <= 0) {
+            free(data);
+            continue;
+        }
+
+        Entry& entry = m_entries[restored++];
+        entry.host = line.substring(0, firstSpace);
+        entry.port = (uint16_t)line.substring(firstSpace + 1, secondSpace).toInt();
+        entry.data = data;
+        entry.length = length;
+        // Back-date so the session expires when it would have without the reboot
+        entry.storedAt = millis() - (TLS_SESSION_TTL_MS - remaining);
+    }
+
+    DEBUG_PRINTF("[TlsSessionCache] Restored %d sessions\n", restored);
+    return restored > 0;
+}
+
+bool TlsSessionCache::deriveStorageKey(uint8_t* key) {
+    if (m_keyReady) {
+        memcpy(key, m_storageKey, sizeof(m_storageKey));
+        return true;
+    }
+
+    // Random per-device secret kept in NVS, so a copied SD card is useless
+    // without the board. Created on first use.
+    uint8_t secret[32];
+    Preferences prefs;
+    if (!prefs.begin(TLS_SESSION_NVS_NAMESPACE, false)) {
+        DEBUG_PRINTLN("[TlsSessionCache] NVS unavailable, no storage key");
+        return false;
+    }
+    if (prefs.getBytes("secret", secret, sizeof(secret)) != sizeof(secret)) {
+        CryptoUtils::generateSalt(secret, sizeof(secret));
+        if (prefs.putBytes("secret", secret, sizeof(secret)) != sizeof(secret)) {
+            prefs.end();
+            memset(secret, 0, sizeof(secret));
+            DEBUG_PRINTLN("[TlsSessionCache] Failed to store device secret");
+            return false;
+        }
+    }
+    prefs.end();
+
+    // The secret is already full-entropy, so one hash (no PBKDF2 stretching)
+    // is enough; derived once per boot and kept for later persists
+    String material = CryptoUtils::bytesToHex(secret, sizeof(secret)) + CACHE_KEY_SALT;
+    memset(secret, 0, sizeof(secret));
+    bool derived = CryptoUtils::sha256(material, m_storageKey);
+    for (unsigned int i = 0; i < material.length(); i++) {
+        material.setCharAt(i, '\0');
+    }
+    if (!derived) {
+        DEBUG_PRINTLN("[TlsSessionCache] Failed to derive storage key");
+        return false;
+    }
+
+    m_keyReady = true;
+    memcpy(key, m_storageKey, sizeof(m_storageKey));
+    return true;
+}
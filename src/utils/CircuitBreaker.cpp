@@ -0,0 +1,102 @@
+/**
+ * @file CircuitBreaker.cpp
+ * @brief Implementation of CircuitBreaker
+ */
+
+#include "utils/CircuitBreaker.h"
+#include "esp_random.h"
+
+CircuitBreaker::CircuitBreaker()
+    : m_state(CircuitState::CLOSED)
+    , m_failures(0)
+    , m_backoff(0)
+    , m_closedAt(0)
+    , m_retryAt(0)
+    , m_rejected(0) {
+}
+
+bool CircuitBreaker::allowRequest() {
+    switch (m_state) {
+        case CircuitState::CLOSED:
+            return true;
+
+        case CircuitState::OPEN:
+            if ((int32_t)(millis() - m_retryAt) >= 0) {
+                m_state = CircuitState::HALF_OPEN;
+                return true;
+            }
+            m_rejected++;
+            return false;
+
+        case CircuitState::HALF_OPEN:
+            // The probe is still out; everything else waits for its verdict
+            m_rejected++;
+            return false;
+    }
+    return true;
+}
+
+void CircuitBreaker::recordSuccess() {
+    if (m_state != CircuitState::CLOSED) {
+        m_closedAt = millis();
+    }
+    m_state = CircuitState::CLOSED;
+    m_failures = 0;
+}
+
+void CircuitBreaker::recordFailure() {
+    if (m_failures < 255) {
+        m_failures++;
+    }
+
+    // A failed probe reopens at once; a closed breaker tolerates a few blips
+    if (m_state == CircuitState::HALF_OPEN || m_failures >= CIRCUIT_FAILURE_THRESHOLD) {
+        open(nextBackoff());
+    }
+}
+
+void CircuitBreaker::trip() {
+    open(nextBackoff());
+}
+
+void CircuitBreaker::openFor(uint32_t delayMs) {
+    open(min(delayMs, (uint32_t)CIRCUIT_OPEN_MAX_MS));
+}
+
+void CircuitBreaker::cancelProbe() {
+    if (m_state == CircuitState::HALF_OPEN) {
+        open(0);
+    }
+}
+
+void CircuitBreaker::reset() {
+    m_state = CircuitState::CLOSED;
+    m_failures = 0;
+    m_backoff = 0;
+    m_closedAt = 0;
+    m_retryAt = 0;
+}
+
+uint32_t CircuitBreaker::getRetryDelay() const {
+    if (m_state != CircuitState::OPEN) return 0;
+
+    int32_t remaining = (int32_t)(m_retryAt - millis());
+    return remaining > 0 ? (uint32_t)remaining : 0;
+}
+
+uint32_t CircuitBreaker::nextBackoff() {
+    // Keep escalating while the service fails again soon after a probe got
+    // through (e.g. HTTP 200 carrying an auth error); start over after a
+    // healthy stretch
+    bool escalate = m_backoff > 0 &&
+                    (m_state != CircuitState::CLOSED || millis() - m_closedAt < m_backoff * 2);
+    m_backoff = escalate ? min((uint32_t)CIRCUIT_OPEN_MAX_MS, m_backoff * 2) : CIRCUIT_OPEN_MIN_MS;
+
+    uint32_t span = m_backoff * CIRCUIT_JITTER_PERCENT / 100;
+    return m_backoff - span + (esp_random() % (2 * span + 1));
+}
+
+void CircuitBreaker::open(uint32_t delayMs) {
+    m_state = CircuitState::OPEN;
+    m_retryAt = millis() + delayMs;
+}
@@ -0,0 +1,82 @@
+/**
+ * @file CommandCoalescer.cpp
+ * @brief Implementation of CommandCoalescer
+ */
+
+#include "utils/CommandCoalescer.h"
+
+CommandCoalescer::CommandCoalescer(uint32_t minIntervalMs)
+    : m_send(nullptr)
+    , m_context(nullptr)
+    , m_minInterval(minIntervalMs)
+    , m_pendingValue(0.0f)
+    , m_hasPending(false)
+    , m_lastSentValue(0.0f)
+    , m_hasLastSent(false)
+    , m_inFlight(false)
+    , m_lastSendTime(0)
+    , m_submitted(0)
+    , m_sent(0) {
+}
+
+void CommandCoalescer::setTarget(CoalescedSendFunction send, void* context) {
+    m_send = send;
+    m_context = context;
+    m_hasLastSent = false;
+}
+
+void CommandCoalescer::submit(float value) {
+    m_pendingValue = value;
+    m_hasPending = true;
+    m_submitted++;
+
+    update();
+}
+
+void CommandCoalescer::update() {
+    if (!m_hasPending || m_inFlight) {
+        return;
+    }
+
+    if (m_sent > 0 && millis() - m_lastSendTime < m_minInterval) {
+        return;
+    }
+
+    send();
+}
+
+void CommandCoalescer::flush() {
+    // A value submitted while a request is in flight is picked up by the
+    // next update() once it completes
+    if (m_hasPending && !m_inFlight) {
+        send();
+    }
+}
+
+void CommandCoalescer::cancel() {
+    m_hasPending = false;
+}
+
+void CommandCoalescer::send() {
+    float value = m_pendingValue;
+    m_hasPending = false;
+
+    // The slider often settles on the value we just sent
+    if (m_hasLastSent && value == m_lastSentValue) {
+        return;
+    }
+
+    if (!m_send) {
+        return;
+    }
+
+    m_inFlight = true;
+    m_lastSendTime = millis();
+    bool accepted = m_send(value, m_context);
+    m_inFlight = false;
+    m_sent++;
+
+    // On failure forget the last value so the same value can be retried
+    m_hasLastSent = accepted;
+    m_lastSentValue = value;
+}
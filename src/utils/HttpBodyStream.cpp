@@ -0,0 +1,158 @@
+/**
+ * @file HttpBodyStream.cpp
+ * @brief Implementation of HttpBodyStream
+ */
+
+#include "utils/HttpBodyStream.h"
+#include "config/Config.h"
+
+HttpBodyStream::HttpBodyStream(Client& source, int contentLength, bool chunked)
+    : m_source(source)
+    , m_contentLength(contentLength)
+    , m_chunked(chunked)
+    , m_chunkRemaining(0)
+    , m_bytesRead(0)
+    , m_complete(false)
+    , m_peeked(-1) {
+    setTimeout(HTTP_TIMEOUT_MS);
+
+    if (!m_chunked) {
+        if (m_contentLength == 0) {
+            m_complete = true;
+        } else if (m_contentLength > 0) {
+            m_chunkRemaining = (size_t)m_contentLength;
+        }
+    }
+}
+
+int HttpBodyStream::available() {
+    if (m_peeked >= 0) return 1;
+    if (m_complete) return 0;
+
+    int sourceAvailable = m_source.available();
+    if (m_chunked || m_contentLength >= 0) {
+        // Chunk headers are consumed lazily, so only report bytes known to be body
+        return (int)min((size_t)sourceAvailable, m_chunkRemaining);
+    }
+    return sourceAvailable;
+}
+
+int HttpBodyStream::read() {
+    if (m_peeked >= 0) {
+        int c = m_peeked;
+        m_peeked = -1;
+        return c;
+    }
+
+    if (!ensureData()) {
+        return -1;
+    }
+
+    int c = sourceRead();
+    if (c < 0) {
+        // Connection dropped mid-body
+        m_complete = true;
+        return -1;
+    }
+
+    m_bytesRead++;
+    if (m_chunked || m_contentLength >= 0) {
+        m_chunkRemaining--;
+        if (!m_chunked && m_chunkRemaining == 0) {
+            m_complete = true;
+        }
+    }
+    return c;
+}
+
+int HttpBodyStream::peek() {
+    if (m_peeked < 0) {
+        m_peeked = read();
+    }
+    return m_peeked;
+}
+
+size_t HttpBodyStream::readBytes(char* buffer, size_t length) {
+    size_t count = 0;
+    while (count < length) {
+        int c = read();
+        if (c < 0) break;
+        buffer[count++] = (char)c;
+    }
+    return count;
+}
+
+bool HttpBodyStream::drain(size_t maxBytes) {
+    size_t discarded = 0;
+    while (!m_complete && discarded < maxBytes) {
+        if (read() < 0) break;
+        discarded++;
+    }
+    return m_complete;
+}
+
+bool HttpBodyStream::ensureData() {
+    if (m_complete) return false;
+
+    if (m_chunked) {
+        if (m_chunkRemaining == 0 && !readChunkHeader()) {
+            m_complete = true;
+            return false;
+        }
+    }
+    return true;
+}
+
+bool HttpBodyStream::readChunkHeader() {
+    char line[24];
+
+    // Every chunk after the first is preceded by the CRLF that ended the previous one
+    if (m_bytesRead > 0) {
+        if (!sourceReadLine(line, sizeof(line)) || line[0] != '\0') {
+            DEBUG_PRINTLN("[HttpBodyStream] Malformed chunk trailer");
+            return false;
+        }
+    }
+
+    if (!sourceReadLine(line, sizeof(line))) {
+        return false;
+    }
+
+    // Size is hex, optionally followed by ";extensions"
+    size_t chunkSize = strtoul(line, nullptr, 16);
+    if (chunkSize == 0) {
+        // Last chunk: consume (empty) trailer section up to the final CRLF
+        while (sourceReadLine(line, sizeof(line)) && line[0] != '\0') {
+        }
+        return false;
+    }
+
+    m_chunkRemaining = chunkSize;
+    return true;
+}
+
+int HttpBodyStream::sourceRead() {
+    uint32_t startTime = millis();
+    do {
+        int c = m_source.read();
+        if (c >= 0) return c;
+        // Closed by the peer: nothing more will arrive (ends close-delimited bodies)
+        if (!m_source.connected() && m_source.available() <= 0) return -1;
+        delay(1);
+    } while (millis() - startTime < _timeout);
+    return -1;
+}
+
+bool HttpBodyStream::sourceReadLine(char* buffer, size_t length) {
+    size_t count = 0;
+    while (true) {
+        int c = sourceRead();
+        if (c < 0) return false;
+        if (c == '\n') break;
+        if (c != '\r' && count < length - 1) {
+            buffer[count++] = (char)c;
+        }
+    }
+    buffer[count] = '\0';
+    return true;
+}
@@ -0,0 +1,262 @@
+/**
+ * @file InflateStream.cpp
+ * @brief Implementation of InflateStream
+ */
+
+#include "utils/InflateStream.h"
+#include "config/Config.h"
+#include <esp_heap_caps.h>
+
+// gzip header flags (RFC 1952, 2.3.1)
+#define GZIP_FLAG_HCRC      0x02
+#define GZIP_FLAG_EXTRA     0x04
+#define GZIP_FLAG_NAME      0x08
+#define GZIP_FLAG_COMMENT   0x10
+
+static void* allocateBuffer(size_t size) {
+    void* buffer = heap_caps_malloc(size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (!buffer) {
+        buffer = malloc(size);
+    }
+    return buffer;
+}
+
+InflateStream::InflateStream()
+    : m_source(nullptr)
+    , m_decompressor(nullptr)
+    , m_window(nullptr)
+    , m_input(nullptr)
+    , m_inputPos(0)
+    , m_inputLen(0)
+    , m_windowPos(0)
+    , m_outputPos(0)
+    , m_outputAvailable(0)
+    , m_flags(0)
+    , m_sourceEnded(true)
+    , m_done(true)
+    , m_error(false)
+    , m_bytesOut(0) {
+    setTimeout(HTTP_TIMEOUT_MS);
+}
+
+InflateStream::~InflateStream() {
+    free(m_decompressor);
+    free(m_window);
+    free(m_input);
+}
+
+bool InflateStream::allocate() {
+    if (isAllocated()) {
+        return true;
+    }
+
+    m_decompressor = (tinfl_decompressor*)allocateBuffer(sizeof(tinfl_decompressor));
+    m_window = (uint8_t*)allocateBuffer(TINFL_LZ_DICT_SIZE);
+    m_input = (uint8_t*)allocateBuffer(INFLATE_INPUT_BUFFER_SIZE);
+
+    if (!m_decompressor || !m_window || !m_input) {
+        DEBUG_PRINTLN("[InflateStream] Out of memory for inflate buffers");
+        free(m_decompressor);
+        free(m_window);
+        free(m_input);
+        m_decompressor = nullptr;
+        m_window = nullptr;
+        m_input = nullptr;
+        return false;
+    }
+
+    DEBUG_PRINTF("[InflateStream] Buffers allocated (%u bytes)\n",
+                 (unsigned)(sizeof(tinfl_decompressor) + TINFL_LZ_DICT_SIZE + INFLATE_INPUT_BUFFER_SIZE));
+    return true;
+}
+
+bool InflateStream::begin(Stream& source, InflateFormat format) {
+    m_source = &source;
+    m_inputPos = 0;
+    m_inputLen = 0;
+    m_windowPos = 0;
+    m_outputPos = 0;
+    m_outputAvailable = 0;
+    m_sourceEnded = false;
+    m_done = false;
+    m_error = false;
+    m_bytesOut = 0;
+
+    if (!isAllocated()) {
+        m_error = true;
+        return false;
+    }
+
+    tinfl_init(m_decompressor);
+
+    if (format == InflateFormat::GZIP) {
+        m_flags = 0;
+        if (!skipGzipHeader()) {
+            DEBUG_PRINTLN("[InflateStream] Invalid gzip header");
+            m_error = true;
+            return false;
+        }
+        return true;
+    }
+
+    // "deflate" is supposed to be zlib-wrapped, but some servers send raw
+    // deflate; a zlib header has CM=8 and a 16-bit check value divisible by 31
+    int cmf = sourceRead();
+    int flg = sourceRead();
+    if (cmf < 0 || flg < 0) {
+        m_error = true;
+        return false;
+    }
+    m_input[0] = (uint8_t)cmf;
+    m_input[1] = (uint8_t)flg;
+    m_inputLen = 2;
+
+    bool zlib = (cmf & 0x0F) == 8 && ((cmf << 8) | flg) % 31 == 0;
+    m_flags = zlib ? (TINFL_FLAG_PARSE_ZLIB_HEADER | TINFL_FLAG_COMPUTE_ADLER32) : 0;
+    return true;
+}
+
+bool InflateStream::parseEncoding(const String& encoding, InflateFormat& format) {
+    String value = encoding;
+    value.trim();
+
+    if (value.equalsIgnoreCase("gzip") || value.equalsIgnoreCase("x-gzip")) {
+        format = InflateFormat::GZIP;
+        return true;
+    }
+    if (value.equalsIgnoreCase("deflate")) {
+        format = InflateFormat::DEFLATE;
+        return true;
+    }
+    return false;
+}
+
+int InflateStream::available() {
+    return (int)m_outputAvailable;
+}
+
+int InflateStream::read() {
+    if (m_outputAvailable == 0 && !fill()) {
+        return -1;
+    }
+
+    uint8_t c = m_window[m_outputPos++];
+    m_outputAvailable--;
+    return c;
+}
+
+int InflateStream::peek() {
+    if (m_outputAvailable == 0 && !fill()) {
+        return -1;
+    }
+    return m_window[m_outputPos];
+}
+
+size_t InflateStream::readBytes(char* buffer, size_t length) {
+    size_t count = 0;
+    while (count < length) {
+        if (m_outputAvailable == 0 && !fill()) {
+            break;
+        }
+
+        size_t n = min(length - count, m_outputAvailable);
+        memcpy(buffer + count, m_window + m_outputPos, n);
+        m_outputPos += n;
+        m_outputAvailable -= n;
+        count += n;
+    }
+    return count;
+}
+
+bool InflateStream::skipGzipHeader() {
+    uint8_t header[10];
+    for (size_t i = 0; i < sizeof(header); i++) {
+        int c = sourceRead();
+        if (c < 0) return false;
+        header[i] = (uint8_t)c;
+    }
+
+    // Magic, then compression method 8 (deflate)
+    if (header[0] != 0x1F || header[1] != 0x8B || header[2] != 8) {
+        return false;
+    }
+
+    uint8_t flags = header[3];
+    if (flags & GZIP_FLAG_EXTRA) {
+        int lo = sourceRead();
+        int hi = sourceRead();
+        if (lo < 0 || hi < 0) return false;
+        for (int remaining = lo | (hi << 8); remaining > 0; remaining--) {
+            if (sourceRead() < 0) return false;
+        }
+    }
+
+    // Original file name and comment are zero-terminated
+    if (flags & GZIP_FLAG_NAME) {
+        int c;
+        while ((c = sourceRead()) > 0) {
+        }
+        if (c < 0) return false;
+    }
+    if (flags & GZIP_FLAG_COMMENT) {
+        int c;
+        while ((c = sourceRead()) > 0) {
+        }
+        if (c < 0) return false;
+    }
+
+    if (flags & GZIP_FLAG_HCRC) {
+        if (sourceRead() < 0 || sourceRead() < 0) return false;
+    }
+    return true;
+}
+
+bool InflateStream::fill() {
+    while (m_outputAvailable == 0) {
+        if (m_done || m_error) {
+            return false;
+        }
+
+        if (m_inputPos == m_inputLen && !m_sourceEnded) {
+            // Block for one byte, then take whatever else already arrived
+            int c = sourceRead();
+            if (c < 0) {
+                m_sourceEnded = true;
+                m_inputPos = 0;
+                m_inputLen = 0;
+            } else {
+                m_input[0] = (uint8_t)c;
+                size_t more = (size_t)max(0, m_source->available());
+                more = min(more, (size_t)INFLATE_INPUT_BUFFER_SIZE - 1);
+                m_inputLen = 1 + (more > 0 ? m_source->readBytes((char*)m_input + 1, more) : 0);
+                m_inputPos = 0;
+            }
+        }
+
+        size_t inBytes = m_inputLen - m_inputPos;
+        size_t outBytes = TINFL_LZ_DICT_SIZE - m_windowPos;
+        uint32_t flags = m_flags | (m_sourceEnded ? 0 : TINFL_FLAG_HAS_MORE_INPUT);
+
+        tinfl_status status = tinfl_decompress(m_decompressor, m_input + m_inputPos, &inBytes,
+                                               m_window, m_window + m_windowPos, &outBytes, flags);
+
+        m_inputPos += inBytes;
+        m_outputPos = m_windowPos;
+        m_outputAvailable = outBytes;
+        m_windowPos = (m_windowPos + outBytes) & (TINFL_LZ_DICT_SIZE - 1);
+        m_bytesOut += outBytes;
+
+        if (status == TINFL_STATUS_DONE) {
+            // The gzip trailer (CRC32, ISIZE) is left for the body drain
+            m_done = true;
+        } else if (status < 0) {
+            DEBUG_PRINTF("[InflateStream] Inflate failed (%d) after %u bytes\n", (int)status, (unsigned)m_bytesOut);
+            m_error = true;
+        }
+    }
+    return true;
+}
+
+int InflateStream::sourceRead() {
+    return m_source ? m_source->read() : -1;
+}
@@ -0,0 +1,72 @@
+/**
+ * @file JsonStreamReader.cpp
+ * @brief Implementation of JsonStreamReader
+ */
+
+#include "utils/JsonStreamReader.h"
+#include "config/Config.h"
+
+int JsonStreamReader::forEachArrayElement(Stream& input, const char* arrayKey, const JsonDocument& filter,
+                                          size_t elementCapacity, ElementCallback callback, void* context) {
+    if (!findArrayStart(input, arrayKey)) {
+        DEBUG_PRINTF("[JsonStreamReader] Array not found: %s\n", arrayKey ? arrayKey : "(root)");
+        return -1;
+    }
+
+    // Empty array
+    if (!skipWhitespace(input)) return -1;
+    if (input.peek() == ']') {
+        input.read();
+        return 0;
+    }
+
+    DynamicJsonDocument element(elementCapacity);
+    int count = 0;
+
+    while (true) {
+        DeserializationError error = deserializeJson(element, input, DeserializationOption::Filter(filter));
+        if (error) {
+            // NoMemory leaves the stream mid-element, so there's no way to resync
+            DEBUG_PRINTF("[JsonStreamReader] Element %d parse error: %s\n", count, error.c_str());
+            return -1;
+        }
+
+        count++;
+        if (!callback(element.as<JsonObject>(), context)) {
+            break;
+        }
+
+        // Next element or end of array
+        if (!skipWhitespace(input)) return -1;
+        int c = input.read();
+        if (c == ']') break;
+        if (c != ',') {
+            DEBUG_PRINTF("[JsonStreamReader] Unexpected '%c' after element %d\n", (char)c, count);
+            return -1;
+        }
+    }
+
+    return count;
+}
+
+bool JsonStreamReader::skipWhitespace(Stream& input) {
+    while (true) {
+        int c = input.peek();
+        if (c < 0) return false;
+        if (c != ' ' && c != '\t' && c != '\r' && c != '\n') return true;
+        input.read();
+    }
+}
+
+bool JsonStreamReader::findArrayStart(Stream& input, const char* arrayKey) {
+    if (arrayKey) {
+        // Keys appear before their value, so a plain scan is enough for the
+        // flat top-level responses we read (Slack "messages", "channels", ...)
+        String needle = String("\"") + arrayKey + "\"";
+        if (!input.find(needle.c_str())) return false;
+        if (!input.find(":")) return false;
+    }
+
+    if (!skipWhitespace(input)) return false;
+    return input.read() == '[';
+}
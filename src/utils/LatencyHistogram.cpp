@@ -0,0 +1,68 @@
+/**
+ * @file LatencyHistogram.cpp
+ * @brief Implementation of LatencyHistogram
+ */
+
+#include "utils/LatencyHistogram.h"
+
+static const uint32_t BUCKET_BOUNDS[LatencyHistogram::BUCKET_COUNT] = {
+    50, 100, 250, 500, 1000, 2000, UINT32_MAX
+};
+
+LatencyHistogram::LatencyHistogram() {
+    reset();
+}
+
+void LatencyHistogram::record(uint32_t ms) {
+    for (int i = 0; i < BUCKET_COUNT; i++) {
+        if (ms <= BUCKET_BOUNDS[i]) {
+            m_buckets[i]++;
+            break;
+        }
+    }
+
+    m_count++;
+    m_sum += ms;
+    if (ms > m_max) {
+        m_max = ms;
+    }
+}
+
+void LatencyHistogram::reset() {
+    for (int i = 0; i < BUCKET_COUNT; i++) {
+        m_buckets[i] = 0;
+    }
+    m_count = 0;
+    m_sum = 0;
+    m_max = 0;
+}
+
+uint32_t LatencyHistogram::getBucketBound(int index) {
+    if (index < 0 || index >= BUCKET_COUNT) return 0;
+    return BUCKET_BOUNDS[index];
+}
+
+uint32_t LatencyHistogram::getPercentile(uint8_t percent) const {
+    if (m_count == 0) return 0;
+
+    uint32_t target = ((uint64_t)m_count * percent + 99) / 100;
+    uint32_t seen = 0;
+    for (int i = 0; i < BUCKET_COUNT; i++) {
+        seen += m_buckets[i];
+        if (seen >= target) {
+            // Last bucket is open-ended, report the observed max instead
+            return (i == BUCKET_COUNT - 1) ? m_max : BUCKET_BOUNDS[i];
+        }
+    }
+    return m_max;
+}
+
+String LatencyHistogram::toString() const {
+    char buffer[128];
+    snprintf(buffer, sizeof(buffer), "n=%u avg=%u max=%u [<=50:%u <=100:%u <=250:%u <=500:%u <=1s:%u <=2s:%u >2s:%u]",
+             (unsigned)m_count, (unsigned)getAverage(), (unsigned)m_max,
+             (unsigned)m_buckets[0], (unsigned)m_buckets[1], (unsigned)m_buckets[2],
+             (unsigned)m_buckets[3], (unsigned)m_buckets[4], (unsigned)m_buckets[5],
+             (unsigned)m_buckets[6]);
+    return String(buffer);
+}
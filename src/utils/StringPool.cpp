@@ -0,0 +1,230 @@
+/**
+ * @file StringPool.cpp
+ * @brief Implementation of StringPool
+ */
+
+#include "utils/StringPool.h"
+#include "config/Config.h"
+#include <esp_heap_caps.h>
+
+static void* allocatePoolBuffer(size_t size) {
+    void* buffer = heap_caps_malloc(size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (!buffer) {
+        buffer = malloc(size);
+    }
+    return buffer;
+}
+
+StringPool::StringPool()
+    : m_arena(nullptr)
+    , m_arenaSize(0)
+    , m_arenaUsed(0)
+    , m_garbage(0)
+    , m_entries(nullptr)
+    , m_maxStrings(0)
+    , m_buckets(nullptr)
+    , m_bucketMask(0)
+    , m_freeHead(0)
+    , m_nextUnused(1)
+    , m_stringCount(0)
+    , m_overflows(0) {
+}
+
+StringPool::~StringPool() {
+    free(m_arena);
+    free(m_entries);
+    free(m_buckets);
+}
+
+bool StringPool::allocate(size_t arenaSize, uint16_t maxStrings) {
+    if (m_arena) {
+        return true;
+    }
+    if (arenaSize == 0 || arenaSize > MAX_ARENA || maxStrings == 0 || maxStrings == 0xFFFF) {
+        return false;
+    }
+
+    uint32_t bucketCount = 1;
+    while (bucketCount < maxStrings && bucketCount < 0x8000) {
+        bucketCount <<= 1;
+    }
+
+    m_arena = (char*)allocatePoolBuffer(arenaSize);
+    m_entries = (Entry*)allocatePoolBuffer(sizeof(Entry) * ((size_t)maxStrings + 1));
+    m_buckets = (uint16_t*)allocatePoolBuffer(sizeof(uint16_t) * bucketCount);
+
+    if (!m_arena || !m_entries || !m_buckets) {
+        DEBUG_PRINTLN("[StringPool] Out of memory");
+        free(m_arena);
+        free(m_entries);
+        free(m_buckets);
+        m_arena = nullptr;
+        m_entries = nullptr;
+        m_buckets = nullptr;
+        return false;
+    }
+
+    memset(m_entries, 0, sizeof(Entry) * ((size_t)maxStrings + 1));
+    memset(m_buckets, 0, sizeof(uint16_t) * bucketCount);
+    m_arenaSize = arenaSize;
+    m_maxStrings = maxStrings;
+    m_bucketMask = (uint16_t)(bucketCount - 1);
+    return true;
+}
+
+uint16_t StringPool::intern(const char* text, size_t length) {
+    if (!m_arena || !text || length == 0) {
+        return EMPTY_ID;
+    }
+    if (length > MAX_LENGTH) {
+        // Don't split a UTF-8 sequence
+        length = MAX_LENGTH;
+        while (length > 0 && ((uint8_t)text[length] & 0xC0) == 0x80) {
+            length--;
+        }
+    }
+
+    uint32_t hash = hashText(text, length);
+    uint16_t& head = m_buckets[hash & m_bucketMask];
+    for (uint16_t id = head; id != 0; id = m_entries[id].next) {
+        const Entry& entry = m_entries[id];
+        if (entry.length == length && memcmp(m_arena + entry.offset, text, length) == 0) {
+            m_entries[id].refs++;
+            return id;
+        }
+    }
+
+    // New string: needs an id and length + 1 arena bytes
+    uint16_t id = m_freeHead;
+    if (id == 0 && m_nextUnused > m_maxStrings) {
+        m_overflows++;
+        return EMPTY_ID;
+    }
+    // Text taken from the arena itself (a substring of a pooled string) must not be moved by compaction
+    bool fromArena = text >= m_arena && text < m_arena + m_arenaSize;
+    if (!reserve(length + 1, !fromArena)) {
+        m_overflows++;
+        return EMPTY_ID;
+    }
+
+    if (id != 0) {
+        m_freeHead = m_entries[id].next;
+    } else {
+        id = m_nextUnused++;
+    }
+
+    Entry& entry = m_entries[id];
+    entry.offset = (uint32_t)m_arenaUsed;
+    entry.length = (uint32_t)length;
+    entry.refs = 1;
+    memcpy(m_arena + m_arenaUsed, text, length);
+    m_arena[m_arenaUsed + length] = '\0';
+    m_arenaUsed += length + 1;
+
+    // reserve() may have compacted, but chains only hold ids, so head is still valid
+    entry.next = head;
+    head = id;
+    m_stringCount++;
+    return id;
+}
+
+void StringPool::retain(uint16_t id) {
+    if (id != EMPTY_ID && id <= m_maxStrings && m_entries[id].refs > 0) {
+        m_entries[id].refs++;
+    }
+}
+
+void StringPool::release(uint16_t id) {
+    if (id == EMPTY_ID || id > m_maxStrings || m_entries[id].refs == 0) {
+        return;
+    }
+
+    Entry& entry = m_entries[id];
+    if (--entry.refs > 0) {
+        return;
+    }
+
+    // Unlink from the hash chain (the characters are still in the arena)
+    uint16_t* link = &m_buckets[hashText(m_arena + entry.offset, entry.length) & m_bucketMask];
+    while (*link != id) {
+        link = &m_entries[*link].next;
+    }
+    *link = entry.next;
+
+    if ((size_t)entry.offset + entry.length + 1 == m_arenaUsed) {
+        // Newest string: its bytes can be handed out again right away
+        m_arenaUsed = entry.offset;
+    } else {
+        m_garbage += entry.length + 1;
+    }
+    entry.next = m_freeHead;
+    m_freeHead = id;
+    m_stringCount--;
+}
+
+const char* StringPool::get(uint16_t id) const {
+    if (id == EMPTY_ID || id > m_maxStrings || m_entries[id].refs == 0) {
+        return "";
+    }
+    return m_arena + m_entries[id].offset;
+}
+
+uint16_t StringPool::length(uint16_t id) const {
+    if (id == EMPTY_ID || id > m_maxStrings || m_entries[id].refs == 0) {
+        return 0;
+    }
+    return m_entries[id].length;
+}
+
+size_t StringPool::getFootprint() const {
+    if (!m_arena) {
+        return 0;
+    }
+    return m_arenaSize + sizeof(Entry) * ((size_t)m_maxStrings + 1) + sizeof(uint16_t) * ((size_t)m_bucketMask + 1);
+}
+
+bool StringPool::reserve(size_t bytes, bool mayCompact) {
+    if (m_arenaUsed + bytes <= m_arenaSize) {
+        return true;
+    }
+    if (!mayCompact || m_arenaUsed - m_garbage + bytes > m_arenaSize) {
+        DEBUG_PRINTLN("[StringPool] Arena full");
+        return false;
+    }
+    compact();
+    return m_arenaUsed + bytes <= m_arenaSize;
+}
+
+void StringPool::compact() {
+    char* fresh = (char*)allocatePoolBuffer(m_arenaSize);
+    if (!fresh) {
+        return;
+    }
+
+    // Ids stay put; only offsets change
+    size_t used = 0;
+    for (uint16_t id = 1; id < m_nextUnused; id++) {
+        Entry& entry = m_entries[id];
+        if (entry.refs == 0) {
+            continue;
+        }
+        memcpy(fresh + used, m_arena + entry.offset, entry.length + 1);
+        entry.offset = (uint32_t)used;
+        used += entry.length + 1;
+    }
+
+    DEBUG_PRINTF("[StringPool] Compacted %u -> %u bytes\n", (unsigned)m_arenaUsed, (unsigned)used);
+    free(m_arena);
+    m_arena = fresh;
+    m_arenaUsed = used;
+    m_garbage = 0;
+}
+
+uint32_t StringPool::hashText(const char* text, size_t length) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < length; i++) {
+        hash ^= (uint8_t)text[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
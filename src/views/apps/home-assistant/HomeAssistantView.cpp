@@ -16,6 +16,22 @@ static void selectLights() {
     }
 }
 
+static void onSliderChanged(float value) {
+    if (g_homeAssistantView) {
+        g_homeAssistantView->handleSliderChanged(value);
+    }
+}
+
+static void onSliderReleased(float value) {
+    if (g_homeAssistantView) {
+        g_homeAssistantView->handleSliderReleased(value);
+    }
+}
+
+static void onDeviceChanged(uint16_t slot, void* context) {
+    static_cast<HomeAssistantView*>(context)->handleDeviceChanged(slot);
+}
+
 HomeAssistantView::HomeAssistantView()
     : m_controller(nullptr)
     , m_grid(nullptr)
@@ -23,8 +39,8 @@ HomeAssistantView::HomeAssistantView()
     , m_mode(HomeAssistantViewMode::DEVICE_TYPES)
     , m_selectedType(HomeAssistantDeviceType::LIGHT)
     , m_selectedDeviceIndex(-1)
-    , m_devices(nullptr)
-    , m_deviceCount(0)
+    , m_selectedEntityId("")
+    , m_deviceVersion(0)
     , m_isDragging(false)
     , m_showSlider(false)
     , m_lastUpdate(0) {
@@ -40,9 +56,6 @@ HomeAssistantView::~HomeAssistantView() {
     if (m_slider) {
         delete m_slider;
     }
-    if (m_devices) {
-        delete[] m_devices;
-    }
 }
 
 void HomeAssistantView::onEnter() {
@@ -51,6 +64,7 @@ void HomeAssistantView::onEnter() {
     m_isActive = true;
     g_homeAssistantView = this;
     m_controller = &HomeAssistantController::getInstance();
+    m_controller->addChangeListener(onDeviceChanged, this);
     
     // Create hexagonal grid
     if (!m_grid) {
@@ -68,15 +82,23 @@ void HomeAssistantView::onExit() {
     DEBUG_PRINTLN("[HomeAssistantView] Exiting...");
     m_isActive = false;
     g_homeAssistantView = nullptr;
+    if (m_controller) {
+        m_controller->removeChangeListener(onDeviceChanged, this);
+    }
 }
 
 void HomeAssistantView::update() {
-    // Refresh devices every 10 seconds when in control view
+    // Devices are read straight from the controller, so optimistic updates,
+    // confirmations and rollbacks show up without copying; only a change in
+    // the set of devices invalidates the span
+    if (m_controller && m_mode != HomeAssistantViewMode::DEVICE_TYPES &&
+        m_controller->getDeviceVersion() != m_deviceVersion) {
+        reloadDeviceList();
+    }
+
     if (m_mode == HomeAssistantViewMode::DEVICE_CONTROL) {
-        uint32_t currentTime = millis();
-        if (currentTime - m_lastUpdate >= 10000) {
-            // TODO: Refresh selected device state
-            m_lastUpdate = currentTime;
+        if (m_showSlider && m_slider) {
+            m_slider->update(TouchController::getInstance().getCurrentTouch());
         }
     }
 }
@@ -106,6 +128,17 @@ void HomeAssistantView::render() {
             renderDeviceControl();
             break;
     }
+
+    // Devices may be stale while the server is backed off
+    if (m_controller && m_controller->isDegraded()) {
+        char degradedStr[32];
+        snprintf(degradedStr, sizeof(degradedStr), "Offline - retry in %us",
+                 (unsigned)((m_controller->getRetryDelay() + 999) / 1000));
+        sprite->setTextColor(COLOR_WARNING);
+        sprite->setTextDatum(TC_DATUM);
+        sprite->setTextSize(1);
+        sprite->drawString(degradedStr, SCREEN_CENTER_X, 30);
+    }
 }
 
 void HomeAssistantView::renderDeviceTypes() {
@@ -169,15 +202,16 @@ void HomeAssistantView::renderDeviceList() {
     // Draw back hint
     sprite->setTextColor(TFT_DARKGREY);
     sprite->setTextDatum(BC_DATUM);
-    sprite->drawString("Swipe down to go back", SCREEN_CENTER_X, SCREEN_HEIGHT - 10);
+    sprite->drawString("Long press: All on/off • Swipe down: Back", SCREEN_CENTER_X, SCREEN_HEIGHT - 10);
 }
 
 void HomeAssistantView::renderDeviceControl() {
-    if (m_selectedDeviceIndex < 0 || m_selectedDeviceIndex >= m_deviceCount) {
+    const HomeAssistantDevice* selected = getSelectedDevice();
+    if (!selected) {
         return;
     }
 
-    const HomeAssistantDevice& device = m_devices[m_selectedDeviceIndex];
+    const HomeAssistantDevice& device = *selected;
 
     // Render based on device type
     switch (device.type) {
@@ -199,9 +233,10 @@ void HomeAssistantView::renderDeviceControl() {
 }
 
 void HomeAssistantView::renderLightControl() {
-    if (m_selectedDeviceIndex < 0 || m_selectedDeviceIndex >= m_deviceCount) return;
+    const HomeAssistantDevice* selected = getSelectedDevice();
+    if (!selected) return;
     
-    const HomeAssistantDevice& device = m_devices[m_selectedDeviceIndex];
+    const HomeAssistantDevice& device = *selected;
     DisplayDriver& display = DisplayDriver::getInstance();
     TFT_eSprite* sprite = display.getSprite();
     
@@ -211,7 +246,7 @@ void HomeAssistantView::renderLightControl() {
     sprite->setTextColor(TFT_WHITE);
     sprite->setTextDatum(TC_DATUM);
     sprite->setTextSize(1);
-    sprite->drawString(device.friendlyName.c_str(), SCREEN_CENTER_X, 20);
+    sprite->drawString(device.getFriendlyName().c_str(), SCREEN_CENTER_X, 20);
 
     // Draw light bulb icon
     int16_t iconY = SCREEN_CENTER_Y - 40;
@@ -225,12 +260,12 @@ void HomeAssistantView::renderLightControl() {
     sprite->fillCircle(SCREEN_CENTER_X, iconY, iconRadius, bulbColor);
     
     // Draw brightness if on
-    if (device.state == HomeAssistantDeviceState::ON && device.brightness > 0) {
+    if (device.state == HomeAssistantDeviceState::ON && device.getBrightness() > 0) {
         sprite->setTextColor(TFT_BLACK);
         sprite->setTextDatum(MC_DATUM);
         sprite->setTextSize(2);
         char brightnessStr[5];
-        snprintf(brightnessStr, sizeof(brightnessStr), "%d%%", (device.brightness * 100) / 255);
+        snprintf(brightnessStr, sizeof(brightnessStr), "%d%%", (device.getBrightness() * 100) / 255);
         sprite->drawString(brightnessStr, SCREEN_CENTER_X, iconY);
     }
 
@@ -253,9 +288,10 @@ void HomeAssistantView::renderLightControl() {
 }
 
 void HomeAssistantView::renderClimateControl() {
-    if (m_selectedDeviceIndex < 0 || m_selectedDeviceIndex >= m_deviceCount) return;
+    const HomeAssistantDevice* selected = getSelectedDevice();
+    if (!selected) return;
     
-    const HomeAssistantDevice& device = m_devices[m_selectedDeviceIndex];
+    const HomeAssistantDevice& device = *selected;
     DisplayDriver& display = DisplayDriver::getInstance();
     TFT_eSprite* sprite = display.getSprite();
     
@@ -265,7 +301,7 @@ void HomeAssistantView::renderClimateControl() {
     sprite->setTextColor(TFT_WHITE);
     sprite->setTextDatum(TC_DATUM);
     sprite->setTextSize(1);
-    sprite->drawString(device.friendlyName.c_str(), SCREEN_CENTER_X, 20);
+    sprite->drawString(device.getFriendlyName().c_str(), SCREEN_CENTER_X, 20);
 
     // Draw thermometer icon
     int16_t iconY = SCREEN_CENTER_Y - 30;
@@ -279,29 +315,25 @@ void HomeAssistantView::renderClimateControl() {
     sprite->setTextDatum(MC_DATUM);
     sprite->setTextSize(2);
     char tempStr[10];
-    snprintf(tempStr, sizeof(tempStr), "%.1f°C", device.temperature);
+    snprintf(tempStr, sizeof(tempStr), "%.1f°C", device.getTemperature());
     sprite->drawString(tempStr, SCREEN_CENTER_X, iconY + 50);
 
     // Draw target temperature
     sprite->setTextColor(TFT_ORANGE);
     sprite->setTextSize(1);
-    snprintf(tempStr, sizeof(tempStr), "Target: %.1f°C", device.targetTemperature);
+    snprintf(tempStr, sizeof(tempStr), "Target: %.1f°C", device.getTargetTemperature());
     sprite->drawString(tempStr, SCREEN_CENTER_X, iconY + 80);
 
-    // Draw slider if shown
-    if (m_showSlider && m_slider) {
-        m_slider->render();
-    }
-
     sprite->setTextColor(TFT_DARKGREY);
     sprite->setTextDatum(BC_DATUM);
     sprite->drawString("Tap: Adjust temperature", SCREEN_CENTER_X, SCREEN_HEIGHT - 10);
 }
 
 void HomeAssistantView::renderMediaPlayerControl() {
-    if (m_selectedDeviceIndex < 0 || m_selectedDeviceIndex >= m_deviceCount) return;
+    const HomeAssistantDevice* selected = getSelectedDevice();
+    if (!selected) return;
     
-    const HomeAssistantDevice& device = m_devices[m_selectedDeviceIndex];
+    const HomeAssistantDevice& device = *selected;
     DisplayDriver& display = DisplayDriver::getInstance();
     TFT_eSprite* sprite = display.getSprite();
     
@@ -311,7 +343,7 @@ void HomeAssistantView::renderMediaPlayerControl() {
     sprite->setTextColor(TFT_WHITE);
     sprite->setTextDatum(TC_DATUM);
     sprite->setTextSize(1);
-    sprite->drawString(device.friendlyName.c_str(), SCREEN_CENTER_X, 20);
+    sprite->drawString(device.getFriendlyName().c_str(), SCREEN_CENTER_X, 20);
 
     // Draw speaker icon
     int16_t iconY = SCREEN_CENTER_Y - 40;
@@ -323,14 +355,14 @@ void HomeAssistantView::renderMediaPlayerControl() {
     sprite->drawString("♪", SCREEN_CENTER_X, iconY);
 
     // Draw media info
-    if (device.mediaTitle.length() > 0) {
+    if (device.getMediaTitle().length() > 0) {
         sprite->setTextColor(TFT_LIGHTGREY);
         sprite->setTextSize(1);
-        sprite->drawString(device.mediaTitle.c_str(), SCREEN_CENTER_X, iconY + iconRadius + 20);
+        sprite->drawString(device.getMediaTitle().c_str(), SCREEN_CENTER_X, iconY + iconRadius + 20);
         
-        if (device.mediaArtist.length() > 0) {
+        if (device.getMediaArtist().length() > 0) {
             sprite->setTextColor(TFT_DARKGREY);
-            sprite->drawString(device.mediaArtist.c_str(), SCREEN_CENTER_X, iconY + iconRadius + 40);
+            sprite->drawString(device.getMediaArtist().c_str(), SCREEN_CENTER_X, iconY + iconRadius + 40);
         }
     }
 
@@ -345,9 +377,10 @@ void HomeAssistantView::renderMediaPlayerControl() {
 }
 
 void HomeAssistantView::renderSensorDisplay() {
-    if (m_selectedDeviceIndex < 0 || m_selectedDeviceIndex >= m_deviceCount) return;
+    const HomeAssistantDevice* selected = getSelectedDevice();
+    if (!selected) return;
     
-    const HomeAssistantDevice& device = m_devices[m_selectedDeviceIndex];
+    const HomeAssistantDevice& device = *selected;
     DisplayDriver& display = DisplayDriver::getInstance();
     TFT_eSprite* sprite = display.getSprite();
     
@@ -357,19 +390,19 @@ void HomeAssistantView::renderSensorDisplay() {
     sprite->setTextColor(TFT_WHITE);
     sprite->setTextDatum(TC_DATUM);
     sprite->setTextSize(1);
-    sprite->drawString(device.friendlyName.c_str(), SCREEN_CENTER_X, 40);
+    sprite->drawString(device.getFriendlyName().c_str(), SCREEN_CENTER_X, 40);
 
     // Draw sensor value
     sprite->setTextColor(TFT_CYAN);
     sprite->setTextDatum(MC_DATUM);
     sprite->setTextSize(3);
-    sprite->drawString(device.sensorValue.c_str(), SCREEN_CENTER_X, SCREEN_CENTER_Y);
+    sprite->drawString(device.getSensorValue().c_str(), SCREEN_CENTER_X, SCREEN_CENTER_Y);
 
     // Draw unit
-    if (device.unit.length() > 0) {
+    if (device.getUnit().length() > 0) {
         sprite->setTextColor(TFT_LIGHTGREY);
         sprite->setTextSize(1);
-        sprite->drawString(device.unit.c_str(), SCREEN_CENTER_X, SCREEN_CENTER_Y + 40);
+        sprite->drawString(device.getUnit().c_str(), SCREEN_CENTER_X, SCREEN_CENTER_Y + 40);
     }
 
     sprite->setTextColor(TFT_DARKGREY);
@@ -399,6 +432,8 @@ void HomeAssistantView::handleTouch(TouchEvent event) {
         case HomeAssistantViewMode::DEVICE_LIST:
             if (event == TouchEvent::TAP && m_grid) {
                 m_grid->handleTap(currentTouch.x, currentTouch.y);
+            } else if (event == TouchEvent::LONG_PRESS) {
+                toggleGroupPower();
             } else if (event == TouchEvent::SWIPE_DOWN) {
                 // Back to device types
                 m_mode = HomeAssistantViewMode::DEVICE_TYPES;
@@ -410,8 +445,12 @@ void HomeAssistantView::handleTouch(TouchEvent event) {
             if (event == TouchEvent::TAP) {
                 toggleDevicePower();
             } else if (event == TouchEvent::LONG_PRESS) {
-                // Show slider
-                m_showSlider = !m_showSlider;
+                // Show slider (only for devices it can control)
+                const HomeAssistantDevice* device = getSelectedDevice();
+                if (device && (device->type == HomeAssistantDeviceType::LIGHT ||
+                               device->type == HomeAssistantDeviceType::MEDIA_PLAYER)) {
+                    m_showSlider = !m_showSlider;
+                }
             } else if (event == TouchEvent::SWIPE_DOWN) {
                 // Back to device list
                 m_mode = HomeAssistantViewMode::DEVICE_LIST;
@@ -448,20 +487,37 @@ void HomeAssistantView::loadDeviceList(HomeAssistantDeviceType type) {
     m_grid->clear();
     m_selectedType = type;
 
-    // Load devices of this type
-    const int MAX_DEVICES = 20;
-    if (m_devices) {
-        delete[] m_devices;
-    }
-    m_devices = new HomeAssistantDevice[MAX_DEVICES];
-    m_deviceCount = m_controller->getDevicesByType(type, m_devices, MAX_DEVICES);
+    // Span over the controller's devices, no copies
+    m_devices = m_controller->getDevicesByType(type);
+    m_deviceVersion = m_controller->getDeviceVersion();
 
-    // Create icon for each device
-    for (int i = 0; i < m_deviceCount; i++) {
+    // Create icon for each device (the grid only has room for so many)
+    int iconCount = min(m_devices.size(), HA_VIEW_MAX_DEVICES);
+    for (int i = 0; i < iconCount; i++) {
         createDeviceIcon(m_devices[i]);
     }
 
-    DEBUG_PRINTF("[HomeAssistantView] Loaded %d devices\n", m_deviceCount);
+    DEBUG_PRINTF("[HomeAssistantView] Loaded %d devices\n", m_devices.size());
+}
+
+void HomeAssistantView::reloadDeviceList() {
+    // Devices were added or removed; the span is stale, the selection (by id) is not
+    loadDeviceList(m_selectedType);
+
+    if (m_mode == HomeAssistantViewMode::DEVICE_CONTROL && !getSelectedDevice()) {
+        DEBUG_PRINTLN("[HomeAssistantView] Selected device removed");
+        m_mode = HomeAssistantViewMode::DEVICE_LIST;
+        m_selectedDeviceIndex = -1;
+        m_selectedEntityId = "";
+        m_showSlider = false;
+    }
+}
+
+const HomeAssistantDevice* HomeAssistantView::getSelectedDevice() {
+    if (!m_controller || m_selectedEntityId.length() == 0) {
+        return nullptr;
+    }
+    return m_controller->getDevice(m_selectedEntityId);
 }
 
 void HomeAssistantView::createDeviceTypeIcon(HomeAssistantDeviceType type, const char* label) {
@@ -499,17 +555,8 @@ void HomeAssistantView::createDeviceTypeIcon(HomeAssistantDeviceType type, const
 
 void HomeAssistantView::createDeviceIcon(const HomeAssistantDevice& device) {
     GridItem item;
-    item.label = device.friendlyName.c_str();
     item.icon = nullptr;
-    
-    // Color based on state
-    if (device.state == HomeAssistantDeviceState::ON) {
-        item.backgroundColor = TFT_GREEN;
-    } else if (device.state == HomeAssistantDeviceState::OFF) {
-        item.backgroundColor = TFT_DARKGREY;
-    } else {
-        item.backgroundColor = TFT_RED;
-    }
+    applyDeviceIcon(item, device);
 
     int deviceIndex = m_grid->getItemCount();
     item.userData = (void*)(intptr_t)deviceIndex;
@@ -522,6 +569,38 @@ void HomeAssistantView::createDeviceIcon(const HomeAssistantDevice& device) {
     m_grid->addItem(item);
 }
 
+void HomeAssistantView::applyDeviceIcon(GridItem& item, const HomeAssistantDevice& device) {
+    item.label = device.getFriendlyName().c_str();
+
+    // Color based on state
+    if (device.state == HomeAssistantDeviceState::ON) {
+        item.backgroundColor = TFT_GREEN;
+    } else if (device.state == HomeAssistantDeviceState::OFF) {
+        item.backgroundColor = TFT_DARKGREY;
+    } else {
+        item.backgroundColor = TFT_RED;
+    }
+}
+
+void HomeAssistantView::handleDeviceChanged(uint16_t slot) {
+    // Only the changed icon is touched; a stale span is rebuilt by update() instead
+    if (m_mode != HomeAssistantViewMode::DEVICE_LIST || !m_grid || !m_controller ||
+        m_controller->getDeviceVersion() != m_deviceVersion) {
+        return;
+    }
+
+    int iconCount = min(m_devices.size(), HA_VIEW_MAX_DEVICES);
+    for (int i = 0; i < iconCount; i++) {
+        if (m_devices.slotAt(i) == slot) {
+            GridItem* item = m_grid->getItem(i);
+            if (item) {
+                applyDeviceIcon(*item, m_devices[i]);
+            }
+            return;
+        }
+    }
+}
+
 void HomeAssistantView::selectDeviceType(HomeAssistantDeviceType type) {
     DEBUG_PRINTF("[HomeAssistantView] Selected device type: %d\n", (int)type);
     m_mode = HomeAssistantViewMode::DEVICE_LIST;
@@ -531,39 +610,118 @@ void HomeAssistantView::selectDeviceType(HomeAssistantDeviceType type) {
 void HomeAssistantView::selectDevice(int deviceIndex) {
     DEBUG_PRINTF("[HomeAssistantView] Selected device: %d\n", deviceIndex);
     m_selectedDeviceIndex = deviceIndex;
+    m_selectedEntityId = "";
+    if (deviceIndex >= 0 && deviceIndex < m_devices.size()) {
+        m_selectedEntityId = m_devices[deviceIndex].getEntityId();
+    }
     m_mode = HomeAssistantViewMode::DEVICE_CONTROL;
     m_showSlider = false;
     
     // Create slider if needed
     if (!m_slider) {
         m_slider = new CircularSlider(SCREEN_CENTER_X, SCREEN_CENTER_Y, 100, 80);
+        m_slider->setRange(0.0f, 1.0f);
+        m_slider->setOnValueChanged(onSliderChanged);
+        m_slider->setOnReleased(onSliderReleased);
+    }
+
+    const HomeAssistantDevice* selected = getSelectedDevice();
+    if (selected) {
+        const HomeAssistantDevice& device = *selected;
+        if (device.type == HomeAssistantDeviceType::MEDIA_PLAYER) {
+            m_slider->setMode(SliderMode::VOLUME);
+            m_slider->setValue(device.getVolume());
+        } else {
+            m_slider->setMode(SliderMode::BRIGHTNESS);
+            m_slider->setValue(device.getBrightness() / 255.0f);
+        }
+    }
+}
+
+void HomeAssistantView::handleSliderChanged(float value) {
+    const HomeAssistantDevice* device = getSelectedDevice();
+    if (!device) return;
+
+    // Climate has no slider control yet (see updateTemperature); anything
+    // else would turn a drag into a service call its domain rejects
+    switch (device->type) {
+        case HomeAssistantDeviceType::LIGHT:
+            updateBrightness(value);
+            break;
+        case HomeAssistantDeviceType::MEDIA_PLAYER:
+            updateVolume(value);
+            break;
+        default:
+            break;
+    }
+}
+
+void HomeAssistantView::handleSliderReleased(float value) {
+    handleSliderChanged(value);
+
+    // Always deliver the value the finger stopped on
+    if (m_controller) {
+        m_controller->flushControls();
     }
 }
 
 void HomeAssistantView::toggleDevicePower() {
-    if (m_selectedDeviceIndex < 0 || m_selectedDeviceIndex >= m_deviceCount || !m_controller) {
+    const HomeAssistantDevice* selected = getSelectedDevice();
+    if (!selected) {
         return;
     }
 
-    HomeAssistantDevice& device = m_devices[m_selectedDeviceIndex];
+    const HomeAssistantDevice& device = *selected;
     bool turnOn = (device.state == HomeAssistantDeviceState::OFF);
 
     DEBUG_PRINTF("[HomeAssistantView] Toggle device %s: %s\n", 
-                 device.entityId.c_str(), turnOn ? "ON" : "OFF");
+                 device.getEntityId().c_str(), turnOn ? "ON" : "OFF");
 
-    m_controller->toggleDevice(device.entityId.c_str(), turnOn);
-    
-    // Update local state
-    device.state = turnOn ? HomeAssistantDeviceState::ON : HomeAssistantDeviceState::OFF;
+    // Optimistic: the controller patches its device immediately and
+    // rolls back if Home Assistant rejects the call
+    if (turnOn) {
+        m_controller->turnOn(device.getEntityId());
+    } else {
+        m_controller->turnOff(device.getEntityId());
+    }
+}
+
+void HomeAssistantView::toggleGroupPower() {
+    if (!m_controller || m_devices.isEmpty()) {
+        return;
+    }
+
+    // Sensors have nothing to switch
+    if (m_selectedType == HomeAssistantDeviceType::SENSOR) {
+        return;
+    }
+
+    // Anything on means "all off", like a room switch
+    bool anyOn = false;
+    int deviceCount = m_devices.size();
+    String* entityIds = new String[deviceCount];
+    for (int i = 0; i < deviceCount; i++) {
+        entityIds[i] = m_devices[i].getEntityId();
+        if (m_devices[i].state == HomeAssistantDeviceState::ON) {
+            anyOn = true;
+        }
+    }
+
+    int queued = m_controller->setPowerForEntities(entityIds, deviceCount, !anyOn);
+    delete[] entityIds;
+    DEBUG_PRINTF("[HomeAssistantView] Group %s: %d/%d devices\n", anyOn ? "OFF" : "ON", queued, deviceCount);
+
+    // Rebuild the icons from the optimistic states
+    loadDeviceList(m_selectedType);
 }
 
 void HomeAssistantView::updateBrightness(float value) {
-    if (m_selectedDeviceIndex < 0 || m_selectedDeviceIndex >= m_deviceCount) return;
+    const HomeAssistantDevice* device = getSelectedDevice();
+    if (!device) return;
     
-    HomeAssistantDevice& device = m_devices[m_selectedDeviceIndex];
-    device.brightness = (uint8_t)(value * 255);
-    
-    // TODO: Send to Home Assistant
+    // Coalesced: one request per interval while dragging, final value on release.
+    // The controller patches its device right away, so the next frame shows it.
+    m_controller->requestBrightness(device->getEntityId(), (uint8_t)(value * 255));
 }
 
 void HomeAssistantView::updateHue(float value) {
@@ -575,12 +733,11 @@ void HomeAssistantView::updateTemperature(float value) {
 }
 
 void HomeAssistantView::updateVolume(float value) {
-    if (m_selectedDeviceIndex < 0 || m_selectedDeviceIndex >= m_deviceCount) return;
-    
-    HomeAssistantDevice& device = m_devices[m_selectedDeviceIndex];
-    device.volume = value;
+    const HomeAssistantDevice* device = getSelectedDevice();
+    if (!device) return;
     
-    // TODO: Send to Home Assistant
+    // Coalesced: one request per interval while dragging, final value on release
+    m_controller->requestMediaPlayerVolume(device->getEntityId(), value);
 }
 
 PageView* createHomeAssistantView() {
@@ -8,7 +8,6 @@
 
 SlackView::SlackView()
     : m_controller(nullptr)
-    , m_notifications(nullptr)
     , m_notificationCount(0)
     , m_currentIndex(0)
     , m_lastUpdate(0) {
@@ -18,9 +17,6 @@ SlackView::SlackView()
 }
 
 SlackView::~SlackView() {
-    if (m_notifications) {
-        delete[] m_notifications;
-    }
 }
 
 void SlackView::onEnter() {
@@ -82,8 +78,14 @@ void SlackView::render() {
     }
 
     // Render notification or empty state
-    if (m_notificationCount > 0 && m_currentIndex < m_notificationCount) {
-        renderNotification(m_notifications[m_currentIndex]);
+    // Handles resolve into the controller's buffer; one evicted since the last load renders as empty
+    const SlackNotification* current = nullptr;
+    if (m_controller && m_notificationCount > 0 && m_currentIndex < m_notificationCount) {
+        current = m_controller->findNotification(m_handles[m_currentIndex]);
+    }
+
+    if (current) {
+        renderNotification(*current);
         
         // Draw pagination indicators
         if (m_notificationCount > 1) {
@@ -102,6 +104,17 @@ void SlackView::render() {
     sprite->setTextDatum(BC_DATUM);
     sprite->setTextSize(1);
     sprite->drawString("Swipe left/right • Tap to dismiss", SCREEN_CENTER_X, SCREEN_HEIGHT - 5);
+
+    // Token expired or API down: polling is paused until the next probe
+    if (m_controller && m_controller->isDegraded()) {
+        char degradedStr[32];
+        snprintf(degradedStr, sizeof(degradedStr), "Offline - retry in %us",
+                 (unsigned)((m_controller->getRetryDelay() + 999) / 1000));
+        sprite->setTextColor(COLOR_WARNING);
+        sprite->setTextDatum(TC_DATUM);
+        sprite->setTextSize(1);
+        sprite->drawString(degradedStr, SCREEN_CENTER_X, 30);
+    }
 }
 
 void SlackView::renderNotification(const SlackNotification& notif) {
@@ -248,18 +261,15 @@ void SlackView::handleTouch(TouchEvent event) {
 void SlackView::loadNotifications() {
     if (!m_controller) return;
 
-    // Clean up old notifications
-    if (m_notifications) {
-        delete[] m_notifications;
-        m_notifications = nullptr;
+    // Only handles are kept; the notifications themselves stay in the controller
+    m_notificationCount = 0;
+    int count = m_controller->getNotificationCount();
+    for (int i = 0; i < count && m_notificationCount < SLACK_NOTIFICATION_CAPACITY; i++) {
+        const SlackNotification* notif = m_controller->getNotification(i);
+        if (notif && !notif->isRead) {
+            m_handles[m_notificationCount++] = m_controller->getNotificationHandle(i);
+        }
     }
-
-    // Allocate array for notifications
-    const int MAX_NOTIFICATIONS = 20;
-    m_notifications = new SlackNotification[MAX_NOTIFICATIONS];
-
-    // Get notifications from controller
-    m_notificationCount = m_controller->getNotifications(m_notifications, MAX_NOTIFICATIONS);
     m_currentIndex = 0;
     m_lastUpdate = millis();
 
@@ -283,15 +293,15 @@ void SlackView::previousNotification() {
 void SlackView::dismissCurrentNotification() {
     if (m_notificationCount == 0 || !m_controller) return;
 
-    DEBUG_PRINTF("[SlackView] Dismissing notification: %s\n", 
-                 m_notifications[m_currentIndex].channelName.c_str());
+    const SlackNotification* notif = m_controller->findNotification(m_handles[m_currentIndex]);
+    DEBUG_PRINTF("[SlackView] Dismissing notification: %s\n", notif ? notif->channelName.c_str() : "(evicted)");
 
-    // Mark as read (TODO: implement in controller)
-    // m_controller->markAsRead(m_notifications[m_currentIndex].id);
+    // Read notifications stay buffered but are left out of the next load
+    m_controller->markAsRead(m_handles[m_currentIndex]);
 
-    // Remove from array
+    // Remove from list
     for (int i = m_currentIndex; i < m_notificationCount - 1; i++) {
-        m_notifications[i] = m_notifications[i + 1];
+        m_handles[i] = m_handles[i + 1];
     }
     m_notificationCount--;
 
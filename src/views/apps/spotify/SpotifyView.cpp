@@ -11,9 +11,7 @@ SpotifyView::SpotifyView()
     , m_volumeSlider(nullptr)
     , m_seekSlider(nullptr)
     , m_currentTab(SpotifyTab::PLAYBACK)
-    , m_isDragging(false)
-    , m_lastUpdate(0)
-    , m_updateInterval(1000) {
+    , m_isDragging(false) {
     
     m_isActive = false;
     m_lastTouch = {0, 0, false, 0};
@@ -68,18 +66,13 @@ void SpotifyView::update() {
         return;
     }
 
-    // Update now playing periodically
-    uint32_t currentTime = millis();
-    if (currentTime - m_lastUpdate >= m_updateInterval) {
-        updateNowPlaying();
-        m_lastUpdate = currentTime;
-    }
+    // Now playing is polled by the controller (interval follows visibility and playback)
 
     // Update seek slider position if playing
     SpotifyTrack* track = m_controller->getCurrentTrack();
-    if (track && track->isPlaying()) {
-        // Estimate position (update from server less frequently)
-        int estimatedPosition = track->getPosition() + (currentTime - m_lastUpdate);
+    if (track && track->isPlaying() && !m_isDragging) {
+        // Playback clock, extrapolated locally between server syncs
+        int estimatedPosition = track->getEstimatedPosition();
         if (m_seekSlider) {
             float progress = (float)estimatedPosition / (float)track->getDuration();
             m_seekSlider->setValue(progress);
@@ -131,6 +124,17 @@ void SpotifyView::render() {
     
     sprite->setTextColor(m_currentTab == SpotifyTab::SEEK ? TFT_WHITE : TFT_DARKGREY);
     sprite->drawString("SEEK", SCREEN_CENTER_X + 60, tabY);
+
+    // Shown while the Web API is backed off
+    if (m_controller && m_controller->isDegraded()) {
+        char degradedStr[32];
+        snprintf(degradedStr, sizeof(degradedStr), "Offline - retry in %us",
+                 (unsigned)((m_controller->getRetryDelay() + 999) / 1000));
+        sprite->setTextColor(COLOR_WARNING);
+        sprite->setTextDatum(TC_DATUM);
+        sprite->setTextSize(1);
+        sprite->drawString(degradedStr, SCREEN_CENTER_X, 15);
+    }
 }
 
 void SpotifyView::renderAlbumArt() {
@@ -253,9 +257,11 @@ void SpotifyView::renderSeekSlider() {
     SpotifyTrack* track = m_controller->getCurrentTrack();
     if (!track || !track->isValid()) return;
 
-    // Update slider value
-    float progress = (float)track->getPosition() / (float)track->getDuration();
-    m_seekSlider->setValue(progress);
+    // Follow the playback clock, except while the finger owns the slider
+    if (!m_isDragging) {
+        float progress = (float)track->getEstimatedPosition() / (float)track->getDuration();
+        m_seekSlider->setValue(progress);
+    }
 
     // Render slider
     m_seekSlider->render();
@@ -276,8 +282,7 @@ void SpotifyView::updateNowPlaying() {
         return;
     }
 
-    DEBUG_PRINTLN("[SpotifyView] Updating now playing...");
-    m_controller->updateNowPlaying();
+    m_controller->refreshNowPlaying();
 }
 
 void SpotifyView::handleTouch(TouchEvent event) {
@@ -291,12 +296,16 @@ void SpotifyView::handleTouch(TouchEvent event) {
             }
             break;
 
+        case TouchEvent::DRAG_START:
+            m_isDragging = true;
+            break;
+
         case TouchEvent::DRAG_MOVE:
             if (m_currentTab == SpotifyTab::VOLUME && m_volumeSlider) {
                 if (m_volumeSlider->handleDrag(currentTouch.x, currentTouch.y)) {
-                    // Update volume on Spotify
+                    // Update volume on Spotify (coalesced, latest value wins)
                     int volume = (int)(m_volumeSlider->getValue() * 100);
-                    m_controller->setVolume(volume);
+                    m_controller->requestVolume(volume);
                 }
             } else if (m_currentTab == SpotifyTab::SEEK && m_seekSlider) {
                 if (m_seekSlider->handleDrag(currentTouch.x, currentTouch.y)) {
@@ -304,12 +313,18 @@ void SpotifyView::handleTouch(TouchEvent event) {
                     SpotifyTrack* track = m_controller->getCurrentTrack();
                     if (track) {
                         int position = (int)(m_seekSlider->getValue() * track->getDuration());
-                        m_controller->seek(position);
+                        m_controller->requestSeek(position);
                     }
                 }
             }
             break;
 
+        case TouchEvent::DRAG_END:
+            m_isDragging = false;
+            // Make sure the value the finger stopped on is what Spotify ends up with
+            m_controller->flushControls();
+            break;
+
         case TouchEvent::SWIPE_LEFT:
             // Next tab
             if (m_currentTab == SpotifyTab::PLAYBACK) {
@@ -40,7 +40,8 @@ CircularSlider::CircularSlider(int16_t centerX, int16_t centerY, int16_t radius,
     , m_enabled(true)
     , m_isDragging(false)
     , m_hasChanged(false)
-    , m_onValueChanged(nullptr) {
+    , m_onValueChanged(nullptr)
+    , m_onReleased(nullptr) {
 }
 
 CircularSlider::~CircularSlider() {
@@ -124,6 +125,10 @@ void CircularSlider::setOnValueChanged(void (*callback)(float value)) {
     m_onValueChanged = callback;
 }
 
+void CircularSlider::setOnReleased(void (*callback)(float value)) {
+    m_onReleased = callback;
+}
+
 void CircularSlider::setEnabled(bool enabled) {
     m_enabled = enabled;
     if (!enabled) {
@@ -145,17 +150,23 @@ void CircularSlider::update(const TouchPoint& touchPoint) {
         }
         
         // Update angle based on touch position
+        float previousValue = m_value;
         calculateAngleFromTouch(touchPoint.x, touchPoint.y);
         calculateValueFromAngle();
         
-        m_hasChanged = true;
-        
-        // Call callback if value changed
-        if (m_onValueChanged) {
-            m_onValueChanged(m_value);
+        // Call callback if value changed (a finger held still reports every frame)
+        if (m_value != previousValue) {
+            m_hasChanged = true;
+            if (m_onValueChanged) {
+                m_onValueChanged(m_value);
+            }
         }
     } else if (m_isDragging && !isTouching) {
         m_isDragging = false;
+
+        if (m_onReleased) {
+            m_onReleased(m_value);
+        }
     }
 
     // Smooth value animation (optional)
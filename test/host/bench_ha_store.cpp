@@ -0,0 +1,275 @@
+/**
+ * @file bench_ha_store.cpp
+ * @brief Host benchmark: memory and lookup cost of the Home Assistant entity store
+ *
+ * Fills a HomeAssistantEntityStore with synthetic entities shaped like a
+ * real installation (mostly sensors, ids derived from friendly names, a
+ * share of renamed entities whose ids no longer match) and compares the
+ * interned record against the previous String-based record. The previous
+ * record can't be built on the host, so its cost is modelled on the ESP32
+ * Arduino String: 16 bytes inline, up to 14 characters stored in place,
+ * longer text in a heap block of (length + 16) & ~15 bytes plus an 8-byte
+ * allocator header.
+ *
+ * "Per entity" is the record plus the strings it owns (heap blocks before,
+ * live pooled bytes with their table entries after). The store's id index,
+ * hashes and type order have no counterpart in the old linear list and are
+ * reported separately, and once more in the all-in figure.
+ *
+ * Exits non-zero if an entity reads back wrong, the store fills up, or the
+ * per-entity reduction is below 4x.
+ *
+ * Not part of the PlatformIO build. From the repository root:
+ *
+ *   g++ -std=gnu++17 -O2 -Itest/host/stubs -Iinclude test/host/bench_ha_store.cpp \
+ *       src/utils/StringPool.cpp src/models/home-assistant/HomeAssistantDevice.cpp \
+ *       src/models/home-assistant/HomeAssistantEntityStore.cpp -o bench_ha_store
+ *   ./bench_ha_store [entities] [renamed %]
+ */
+
+#include "models/home-assistant/HomeAssistantEntityStore.h"
+
+#include <cctype>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+
+static const double TARGET_REDUCTION = 4.0;
+
+// Layout of the previous HomeAssistantDevice with 32-bit ESP32 Strings.
+// Its enums were only forward-declared there, so they were int-sized.
+struct alignas(4) EspString {
+    uint8_t bytes[16];
+};
+
+struct LegacyDevice {
+    EspString entityId;
+    EspString friendlyName;
+    int32_t type;
+    int32_t state;
+    uint8_t brightness;
+    uint8_t colorR;
+    uint8_t colorG;
+    uint8_t colorB;
+    uint16_t colorTemp;
+    bool hasColor;
+    bool hasColorTemp;
+    float temperature;
+    float targetTemperature;
+    EspString hvacMode;
+    EspString mediaTitle;
+    EspString mediaArtist;
+    float volume;
+    EspString sensorValue;
+    EspString unit;
+};
+
+static size_t espStringHeap(size_t length) {
+    return length <= 14 ? 0 : ((length + 16) & ~(size_t)15) + 8;
+}
+
+// Home Assistant's default object id for a name
+static std::string slugify(const std::string& name) {
+    std::string slug;
+    bool gap = false;
+    for (char c : name) {
+        if (std::isalnum((unsigned char)c) && (unsigned char)c < 0x80) {
+            if (gap && !slug.empty()) {
+                slug += '_';
+            }
+            slug += (char)std::tolower((unsigned char)c);
+            gap = false;
+        } else {
+            gap = true;
+        }
+    }
+    return slug;
+}
+
+struct DomainMix {
+    const char* domain;
+    HomeAssistantDeviceType type;
+    int weight;
+    const char* things[3];
+};
+
+// Rough shape of a few thousand-entity installations: sensor-heavy, some unsupported domains
+static const DomainMix mix[] = {
+    { "sensor", HomeAssistantDeviceType::SENSOR, 45, { "Temperature", "Humidity", "Power" } },
+    { "light", HomeAssistantDeviceType::LIGHT, 12, { "Ceiling Light", "Lamp", "Led Strip" } },
+    { "switch", HomeAssistantDeviceType::SWITCH, 10, { "Plug", "Heater Switch", "Fountain" } },
+    { "binary_sensor", HomeAssistantDeviceType::UNKNOWN, 12, { "Motion", "Door", "Window" } },
+    { "automation", HomeAssistantDeviceType::UNKNOWN, 5, { "Lights Off", "Morning Routine", "Alarm" } },
+    { "cover", HomeAssistantDeviceType::COVER, 5, { "Blind", "Curtain", "Garage Door" } },
+    { "climate", HomeAssistantDeviceType::CLIMATE, 3, { "Thermostat", "Radiator", "Air Conditioner" } },
+    { "media_player", HomeAssistantDeviceType::MEDIA_PLAYER, 3, { "Speaker", "TV", "Soundbar" } },
+    { "fan", HomeAssistantDeviceType::FAN, 3, { "Fan", "Ceiling Fan", "Air Purifier" } },
+    { "lock", HomeAssistantDeviceType::LOCK, 2, { "Front Door Lock", "Back Door Lock", "Gate Lock" } },
+};
+
+struct Expected {
+    std::string id;
+    std::string sensorValue;
+};
+
+int main(int argc, char** argv) {
+    int count = 2000;
+    if (argc > 1) {
+        count = constrain(atoi(argv[1]), 1, 0x7FFF);
+    }
+    int renamedPercent = 15;
+    if (argc > 2) {
+        renamedPercent = constrain(atoi(argv[2]), 0, 100);
+    }
+
+    static const char* rooms[] = { "Living Room", "Kitchen", "Bedroom", "Office", "Garage", "Hallway", "Bathroom" };
+    static const char* units[] = { "°C", "%", "W", "kWh", "lx", "ppm", "" };
+    static const char* texts[] = { "unavailable", "unknown", "on", "idle", "2026-10-17T08:00:00+00:00" };
+    static const char* models[] = { "hue_color_lamp", "tradfri_bulb", "shelly_plug_s", "aqara_sensor", "zwave_node" };
+
+    HomeAssistantEntityStore store;
+    if (!store.allocate((uint16_t)count)) {
+        std::printf("allocation failed\n");
+        return 1;
+    }
+
+    int totalWeight = 0;
+    for (const DomainMix& entry : mix) {
+        totalWeight += entry.weight;
+    }
+
+    std::mt19937 random(42);
+    std::vector<Expected> expected;
+    size_t legacyHeap = 0;
+    int renamed = 0;
+    for (int i = 0; i < count; i++) {
+        int pick = random() % totalWeight;
+        const DomainMix* domain = mix;
+        while (pick >= domain->weight) {
+            pick -= domain->weight;
+            domain++;
+        }
+
+        std::string name = std::string(rooms[random() % 7]) + " " + domain->things[random() % 3] + " " + std::to_string(i);
+        std::string objectId = slugify(name);
+        if ((int)(random() % 100) < renamedPercent) {
+            // Renamed after discovery: the id still carries the original name
+            objectId = std::string(models[random() % 5]) + "_" + std::to_string(i);
+            renamed++;
+        }
+        std::string id = std::string(domain->domain) + "." + objectId;
+
+        HomeAssistantDevice* device = store.findOrInsert(String(id), domain->type);
+        if (!device) {
+            std::printf("store full at %d\n", i);
+            return 1;
+        }
+        device->setFriendlyName(String(name));
+        legacyHeap += espStringHeap(id.size()) + espStringHeap(name.size());
+
+        Expected entity = { id, "" };
+        switch (domain->type) {
+            case HomeAssistantDeviceType::SENSOR: {
+                std::string value;
+                std::string unit;
+                if (random() % 10 == 0) {
+                    value = texts[random() % 5];
+                } else {
+                    char buffer[16];
+                    int tenths = (int)(random() % 20000) - 2000;
+                    std::snprintf(buffer, sizeof(buffer), random() % 3 ? "%d.%d" : "%d",
+                                  random() % 3 ? tenths / 10 : tenths, std::abs(tenths % 10));
+                    value = buffer;
+                    unit = units[random() % 7];
+                }
+                device->setSensorValue(String(value));
+                device->setUnit(String(unit));
+                legacyHeap += espStringHeap(value.size()) + espStringHeap(unit.size());
+                entity.sensorValue = value;
+                break;
+            }
+            case HomeAssistantDeviceType::MEDIA_PLAYER: {
+                std::string title = "Some Song Title Number " + std::to_string(random() % 50);
+                std::string artist = "Artist " + std::to_string(random() % 20);
+                device->setMediaTitle(String(title));
+                device->setMediaArtist(String(artist));
+                legacyHeap += espStringHeap(title.size()) + espStringHeap(artist.size());
+                break;
+            }
+            case HomeAssistantDeviceType::CLIMATE:
+                device->setHvacMode(String("heat"));
+                device->setTemperature(21.5f);
+                break;
+            case HomeAssistantDeviceType::LIGHT:
+                device->setBrightness(128);
+                device->setColor(255, 180, 90);
+                device->setColorTemp(370);
+                break;
+            default:
+                break;
+        }
+        expected.push_back(entity);
+    }
+
+    // Everything must read back as it was written
+    int wrong = 0;
+    for (const Expected& entity : expected) {
+        const HomeAssistantDevice* device = store.find(String(entity.id));
+        if (!device || device->getEntityId() != String(entity.id) ||
+            (device->type == HomeAssistantDeviceType::SENSOR && device->getSensorValue() != String(entity.sensorValue))) {
+            if (wrong++ < 5) {
+                std::printf("read back wrong: %s\n", entity.id.c_str());
+            }
+        }
+    }
+
+    const StringPool& pool = HomeAssistantString::pool();
+    // Entry table and hash buckets are sized per possible string; charge the used share
+    double perString = (double)(pool.getFootprint() - pool.getArenaSize()) / (pool.getMaxStrings() + 1);
+    size_t arenaLive = pool.getArenaUsed() - pool.getGarbage();
+    double pooledPerEntity = (arenaLive + perString * pool.getStringCount()) / count;
+    double before = sizeof(LegacyDevice) + (double)legacyHeap / count;
+    double after = sizeof(HomeAssistantDevice) + pooledPerEntity;
+    double storePerEntity = (double)(store.getFootprint() - sizeof(HomeAssistantDevice) * store.capacity()) / count;
+
+    std::printf("entities:            %d (%d renamed, ids not derivable from the name)\n", count, renamed);
+    std::printf("record:              %zu B before (modelled), %zu B after\n",
+                sizeof(LegacyDevice), sizeof(HomeAssistantDevice));
+    std::printf("strings:             %.1f B/entity heap before (modelled), %.1f B/entity pooled after\n",
+                (double)legacyHeap / count, pooledPerEntity);
+    std::printf("pool:                %u strings, %zu B live, %zu B garbage, %zu B reserved\n",
+                pool.getStringCount(), arenaLive, pool.getGarbage(), pool.getArenaSize());
+    std::printf("per entity:          %.1f B before, %.1f B after (%.2fx, target %.1fx)\n",
+                before, after, before / after, TARGET_REDUCTION);
+    std::printf("store index/hashes:  %.1f B/entity (not in the old layout)\n", storePerEntity);
+    std::printf("all-in:              %.1f B before, %.1f B after (%.2fx)\n",
+                before, after + storePerEntity, before / (after + storePerEntity));
+    std::printf("reserved footprint:  store %zu B + pool %zu B\n", store.getFootprint(), pool.getFootprint());
+
+    const int rounds = 200;
+    int hits = 0;
+    std::vector<String> ids;
+    for (const Expected& entity : expected) {
+        ids.push_back(String(entity.id));
+    }
+    auto start = std::chrono::steady_clock::now();
+    for (int round = 0; round < rounds; round++) {
+        for (const String& id : ids) {
+            hits += store.find(id) != nullptr;
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+    std::printf("lookups:             %.0f ns each (%d hits)\n",
+                std::chrono::duration<double, std::nano>(end - start).count() / (rounds * count), hits);
+
+    if (wrong > 0) {
+        std::printf("FAIL: %d entities read back wrong\n", wrong);
+        return 1;
+    }
+    if (before / after < TARGET_REDUCTION) {
+        std::printf("FAIL: per-entity reduction below %.1fx\n", TARGET_REDUCTION);
+        return 1;
+    }
+    return 0;
+}
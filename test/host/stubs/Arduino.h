@@ -0,0 +1,48 @@
+/**
+ * @file Arduino.h
+ * @brief Minimal host stand-in for the Arduino core (host benchmarks only)
+ *
+ * Just enough of String, Serial and the helpers the model and utility
+ * sources use, so they build with a desktop compiler.
+ */
+
+#ifndef HOST_ARDUINO_STUB_H
+#define HOST_ARDUINO_STUB_H
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <string>
+
+class String {
+public:
+    String(const char* text = "") : m_text(text ? text : "") {}
+    String(const std::string& text) : m_text(text) {}
+
+    const char* c_str() const { return m_text.c_str(); }
+    unsigned int length() const { return (unsigned int)m_text.size(); }
+    bool operator==(const String& other) const { return m_text == other.m_text; }
+    bool operator!=(const String& other) const { return m_text != other.m_text; }
+    char operator[](unsigned int index) const { return m_text[index]; }
+    String operator+(const String& other) const { return String(m_text + other.m_text); }
+
+private:
+    std::string m_text;
+};
+
+struct HostSerial {
+    template <typename... Args>
+    void printf(const char* format, Args... args) { std::printf(format, args...); }
+    void printf(const char* text) { std::fputs(text, stdout); }
+    void print(const char* text) { std::fputs(text, stdout); }
+    void println(const char* text) { std::puts(text); }
+};
+inline HostSerial Serial;
+
+template <class T> T constrain(T value, T low, T high) {
+    return value < low ? low : (value > high ? high : value);
+}
+
+#endif // HOST_ARDUINO_STUB_H
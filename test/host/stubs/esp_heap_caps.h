@@ -0,0 +1,17 @@
+/**
+ * @file esp_heap_caps.h
+ * @brief Host stand-in for the ESP-IDF capability allocator (host benchmarks only)
+ */
+
+#ifndef HOST_ESP_HEAP_CAPS_STUB_H
+#define HOST_ESP_HEAP_CAPS_STUB_H
+
+#include <cstdlib>
+
+#define MALLOC_CAP_SPIRAM   (1 << 10)
+#define MALLOC_CAP_8BIT     (1 << 2)
+
+inline void* heap_caps_malloc(size_t size, unsigned int) { return malloc(size); }
+inline void heap_caps_free(void* ptr) { free(ptr); }
+
+#endif // HOST_ESP_HEAP_CAPS_STUB_H
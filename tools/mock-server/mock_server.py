@@ -0,0 +1,104 @@
+#!/usr/bin/env python3
+"""Serve mock Spotify, Slack and Home Assistant APIs for exercising the firmware.
+
+Each service listens on its own port; point the controllers at it through
+their base-URL settings (see README.md). Python 3.8+, no dependencies.
+"""
+
+import argparse
+import asyncio
+
+from mockapi.homeassistant import HomeAssistant
+from mockapi.http import MockServer, ServiceKnobs
+from mockapi.slack import Slack
+from mockapi.spotify import Spotify
+
+SERVICES = ("ha", "spotify", "slack")
+
+
+def parse_args():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--host", default="0.0.0.0", help="listen address (default: all interfaces)")
+    parser.add_argument("--ha-port", type=int, default=8123)
+    parser.add_argument("--spotify-port", type=int, default=8124)
+    parser.add_argument("--slack-port", type=int, default=8125)
+    parser.add_argument("--only", choices=SERVICES, action="append", help="run only these services (repeatable)")
+    parser.add_argument("--verbose", "-v", action="store_true", help="log every request")
+
+    faults = parser.add_argument_group("faults and transport (all services; override with --<service>-<knob>)")
+    faults.add_argument("--latency-ms", type=float, default=0, help="added to every response")
+    faults.add_argument("--jitter-ms", type=float, default=0, help="+/- random spread on the latency")
+    faults.add_argument("--error-rate", type=float, default=0.0, help="share of requests failed (0..1)")
+    faults.add_argument("--error-status", type=int, default=503, help="status of injected failures")
+    faults.add_argument("--retry-after", type=int, default=5, help="Retry-After seconds on injected 429/503")
+    faults.add_argument("--no-compress", action="store_true", help="never gzip/deflate responses")
+    faults.add_argument("--chunked", action="store_true", help="send bodies with chunked transfer encoding")
+    faults.add_argument("--ws-lifetime-s", type=float, default=0, help="drop WebSockets after this long")
+    for service in SERVICES:
+        faults.add_argument("--%s-latency-ms" % service, type=float)
+        faults.add_argument("--%s-error-rate" % service, type=float)
+        faults.add_argument("--%s-ws-lifetime-s" % service, type=float)
+
+    ha = parser.add_argument_group("Home Assistant")
+    ha.add_argument("--ha-entities", type=int, default=200, help="synthetic entity count (e.g. 5000)")
+    ha.add_argument("--ha-states-file", help="serve a recorded /api/states dump instead")
+    ha.add_argument("--ha-token", default="", help="required access token (default: accept any)")
+    ha.add_argument("--ha-churn", type=float, default=0.0, help="sensor updates per second pushed to subscribers")
+    ha.add_argument("--ha-etag", action="store_true", help="send ETags on /api/states (real HA doesn't)")
+
+    spotify = parser.add_argument_group("Spotify")
+    spotify.add_argument("--spotify-token", default="", help="required bearer token (default: accept any)")
+    spotify.add_argument("--spotify-tracks", type=int, default=50)
+    spotify.add_argument("--spotify-idle", action="store_true", help="start with no active device (204)")
+
+    slack = parser.add_argument_group("Slack")
+    slack.add_argument("--slack-token", default="", help="required bearer token (default: accept any)")
+    slack.add_argument("--slack-users", type=int, default=300)
+    slack.add_argument("--slack-channels", type=int, default=20)
+    slack.add_argument("--slack-history", type=int, default=200, help="messages spread over the last day")
+    slack.add_argument("--slack-message-rate", type=float, default=0.0, help="Socket Mode events per second")
+    slack.add_argument("--slack-public-url", help="ws://host:port handed out by apps.connections.open")
+    return parser.parse_args()
+
+
+def knobs_for(args, service):
+    knobs = ServiceKnobs(args.latency_ms, args.jitter_ms, args.error_rate, args.error_status, args.retry_after,
+                         not args.no_compress, args.chunked, args.ws_lifetime_s)
+    for knob in ("latency_ms", "error_rate", "ws_lifetime_s"):
+        value = getattr(args, "%s_%s" % (service, knob))
+        if value is not None:
+            setattr(knobs, knob, value)
+    return knobs
+
+
+async def main():
+    args = parse_args()
+    enabled = set(args.only or SERVICES)
+    services = []
+    if "ha" in enabled:
+        services.append(("ha", args.ha_port, HomeAssistant(args.ha_entities, args.ha_token, args.ha_churn,
+                                                           args.ha_states_file, etag=args.ha_etag)))
+    if "spotify" in enabled:
+        services.append(("spotify", args.spotify_port, Spotify(args.spotify_token, args.spotify_tracks,
+                                                               args.spotify_idle)))
+    if "slack" in enabled:
+        services.append(("slack", args.slack_port, Slack(args.slack_token, args.slack_users, args.slack_channels,
+                                                         args.slack_history, args.slack_message_rate,
+                                                         public_url=args.slack_public_url)))
+
+    servers = []
+    for name, port, service in services:
+        server = MockServer(name, service, knobs_for(args, name), args.verbose)
+        servers.append(await server.start(args.host, port))
+        print("%-8s http://%s:%d  %s" % (name, args.host, port, service.stats()))
+        if hasattr(service, "churn"):
+            asyncio.ensure_future(service.churn())
+
+    await asyncio.gather(*(server.serve_forever() for server in servers))
+
+
+if __name__ == "__main__":
+    try:
+        asyncio.run(main())
+    except KeyboardInterrupt:
+        pass
@@ -0,0 +1 @@
+"""Local stand-ins for the Spotify, Slack and Home Assistant APIs (stdlib only)."""
@@ -0,0 +1,310 @@
+"""Home Assistant REST and WebSocket API subset used by HomeAssistantController.
+
+REST: /api/config, /api/states, /api/states/<id>, /api/services/<domain>/<service>,
+/api/template (area_entities(...) joins only). WebSocket /api/websocket:
+auth, subscribe_events (state_changed), subscribe_trigger (state platform),
+unsubscribe_events and ping. Service calls and the optional background
+churn are pushed to live subscriptions.
+"""
+
+import asyncio
+import datetime
+import json
+import random
+import re
+
+from .http import Response, error_response, json_response
+
+AREAS = ["Living Room", "Kitchen", "Bedroom", "Office", "Garage", "Hallway", "Kid's Room", "Garden"]
+
+# Share of each domain in synthetic installs (sensors dominate real ones)
+DOMAIN_WEIGHTS = [
+    ("sensor", 40), ("binary_sensor", 15), ("light", 15), ("switch", 10), ("climate", 4),
+    ("media_player", 4), ("cover", 5), ("fan", 3), ("lock", 4),
+]
+
+SENSOR_KINDS = [("temperature", "°C", 15.0, 28.0), ("humidity", "%", 30.0, 70.0), ("power", "W", 0.0, 2500.0),
+                ("energy", "kWh", 0.0, 9000.0), ("illuminance", "lx", 0.0, 1200.0), ("co2", "ppm", 400.0, 1600.0)]
+
+TEMPLATE_AREA = re.compile(r"area_entities\('((?:[^'\\]|\\.)*)'\)")
+
+
+def now_iso():
+    return datetime.datetime.now(datetime.timezone.utc).isoformat()
+
+
+def slugify(text):
+    return re.sub(r"[^a-z0-9]+", "_", text.lower()).strip("_")
+
+
+class HomeAssistant:
+    def __init__(self, entity_count=200, token="", churn_per_s=0.0, states_file=None, seed=1, etag=False):
+        self.token = token
+        self.churn_per_s = churn_per_s
+        self.etag = etag
+        self.random = random.Random(seed)
+        self.states = {}
+        self.areas = {}
+        self.sessions = {}          # Authenticated WebSocket sessions by id
+        self.events_sent = 0
+        self.service_calls = 0
+        if states_file:
+            self._load(states_file)
+        else:
+            self._generate(entity_count)
+
+    # ---- model ---------------------------------------------------------------
+
+    def _generate(self, count):
+        domains = [name for name, weight in DOMAIN_WEIGHTS for _ in range(weight)]
+        for index in range(count):
+            domain = domains[index % len(domains)] if index < len(domains) else self.random.choice(domains)
+            area = AREAS[index % len(AREAS)]
+            entity_id = "%s.%s_%d" % (domain, slugify(area), index)
+            state, attributes = self._initial_state(domain, area, index)
+            self._set(entity_id, state, attributes)
+            self.areas[entity_id] = area
+
+    def _load(self, path):
+        # A recorded GET /api/states dump; areas are assigned round-robin
+        with open(path, encoding="utf-8") as source:
+            for index, record in enumerate(json.load(source)):
+                self.states[record["entity_id"]] = record
+                self.areas[record["entity_id"]] = AREAS[index % len(AREAS)]
+
+    def _initial_state(self, domain, area, index):
+        name = "%s %s %d" % (area, domain.replace("_", " ").title(), index)
+        attributes = {"friendly_name": name}
+        if domain == "sensor":
+            kind, unit, low, high = SENSOR_KINDS[index % len(SENSOR_KINDS)]
+            attributes.update({"unit_of_measurement": unit, "device_class": kind, "state_class": "measurement"})
+            return "%.1f" % self.random.uniform(low, high), attributes
+        if domain == "light":
+            on = self.random.random() < 0.4
+            attributes.update({"supported_color_modes": ["color_temp", "rgb"], "color_mode": "rgb",
+                               "min_mireds": 153, "max_mireds": 500})
+            if on:
+                attributes.update({"brightness": self.random.randint(20, 255), "rgb_color": [255, 180, 90],
+                                   "color_temp": 370})
+            return ("on" if on else "off"), attributes
+        if domain == "climate":
+            attributes.update({"hvac_modes": ["off", "heat", "cool", "auto"], "current_temperature": 20.5,
+                               "temperature": 21.0, "min_temp": 7, "max_temp": 35})
+            return "heat", attributes
+        if domain == "media_player":
+            attributes.update({"volume_level": 0.35, "media_title": "Track %d" % index,
+                               "media_artist": "Artist %d" % (index % 17), "is_volume_muted": False})
+            return "playing", attributes
+        if domain == "cover":
+            attributes.update({"current_position": 100})
+            return "open", attributes
+        if domain == "lock":
+            return "locked", attributes
+        if domain == "binary_sensor":
+            attributes.update({"device_class": "motion"})
+            return "off", attributes
+        return ("on" if self.random.random() < 0.3 else "off"), attributes
+
+    def _set(self, entity_id, state, attributes):
+        old = self.states.get(entity_id)
+        stamp = now_iso()
+        changed = old is None or old["state"] != state
+        new = {
+            "entity_id": entity_id,
+            "state": state,
+            "attributes": attributes,
+            "last_changed": stamp if changed else old["last_changed"],
+            "last_updated": stamp,
+            "context": {"id": "%026x" % self.random.getrandbits(104), "parent_id": None, "user_id": None},
+        }
+        self.states[entity_id] = new
+        return old, new
+
+    def stats(self):
+        return {"entities": len(self.states), "ws_live": len(self.sessions),
+                "events_sent": self.events_sent, "service_calls": self.service_calls}
+
+    # ---- REST ----------------------------------------------------------------
+
+    async def handle(self, request):
+        if self.token and request.bearer() != self.token:
+            return Response(401, "401: Unauthorized", "text/plain")
+
+        path = request.path
+        if path == "/api/" and request.method == "GET":
+            return json_response({"message": "API running."})
+        if path == "/api/config" and request.method == "GET":
+            return json_response({
+                "location_name": "Mock Home", "latitude": 52.37, "longitude": 4.89, "elevation": 0,
+                "unit_system": {"length": "km", "mass": "g", "temperature": "°C", "volume": "L"},
+                "time_zone": "Europe/Amsterdam", "version": "2024.6.0", "state": "RUNNING",
+                "components": ["light", "switch", "sensor", "climate", "media_player", "cover", "fan", "lock"],
+            })
+        if path == "/api/states" and request.method == "GET":
+            return json_response(list(self.states.values()), etag=self.etag)
+        if path.startswith("/api/states/") and request.method == "GET":
+            state = self.states.get(path[len("/api/states/"):])
+            return json_response(state) if state else error_response(404, "Entity not found.")
+        if path.startswith("/api/services/") and request.method == "POST":
+            parts = path.split("/")
+            if len(parts) != 5:
+                return error_response(400, "Invalid service path")
+            return await self._call_service(parts[3], parts[4], request.json())
+        if path == "/api/template" and request.method == "POST":
+            return self._render_template(request.json().get("template", ""))
+        return error_response(404, "Not found")
+
+    async def _call_service(self, domain, service, data):
+        self.service_calls += 1
+        targets = data.get("entity_id", [])
+        if isinstance(targets, str):
+            targets = [targets]
+
+        changed = []
+        for entity_id in targets:
+            current = self.states.get(entity_id)
+            if not current:
+                continue
+            state, attributes = self._apply_service(current, domain, service, data)
+            old, new = self._set(entity_id, state, attributes)
+            changed.append(new)
+            await self._publish(old, new)
+        return json_response(changed)
+
+    def _apply_service(self, current, domain, service, data):
+        state = current["state"]
+        attributes = dict(current["attributes"])
+        if service == "turn_on":
+            state = "on"
+            if "brightness" in data:
+                attributes["brightness"] = int(data["brightness"])
+            if "brightness_pct" in data:
+                attributes["brightness"] = round(int(data["brightness_pct"]) * 255 / 100)
+            if "rgb_color" in data:
+                attributes["rgb_color"] = list(data["rgb_color"])
+            if "color_temp" in data:
+                attributes["color_temp"] = int(data["color_temp"])
+            if domain == "light":
+                attributes.setdefault("brightness", 255)
+        elif service == "turn_off":
+            state = "off"
+            for key in ("brightness", "rgb_color", "color_temp"):
+                attributes.pop(key, None)
+        elif service == "toggle":
+            state = "off" if state == "on" else "on"
+        elif service == "set_temperature":
+            attributes["temperature"] = float(data.get("temperature", attributes.get("temperature", 21.0)))
+        elif service == "set_hvac_mode":
+            state = data.get("hvac_mode", state)
+        elif service == "volume_set":
+            attributes["volume_level"] = float(data.get("volume_level", 0))
+        elif service in ("media_play", "media_pause", "media_play_pause"):
+            playing = service == "media_play" or (service == "media_play_pause" and state != "playing")
+            state = "playing" if playing else "paused"
+        elif service in ("open_cover", "close_cover"):
+            state = "open" if service == "open_cover" else "closed"
+            attributes["current_position"] = 100 if state == "open" else 0
+        elif service in ("lock", "unlock"):
+            state = "locked" if service == "lock" else "unlocked"
+        return state, attributes
+
+    def _render_template(self, template):
+        # Only the shape resolveSubscriptionAreas() sends:
+        # {{ (area_entities('A') + area_entities('B')) | join(',') }}
+        names = [re.sub(r"\\(.)", r"\1", match) for match in TEMPLATE_AREA.findall(template)]
+        if not names and "area_entities" in template:
+            return error_response(400, "Error rendering template: TemplateSyntaxError")
+        wanted = set(names) | set(slugify(name) for name in names)
+        members = [entity_id for entity_id, area in self.areas.items()
+                   if area in wanted or slugify(area) in wanted]
+        return Response(200, ",".join(members), "text/plain; charset=utf-8")
+
+    # ---- WebSocket -------------------------------------------------------------
+
+    async def websocket(self, request, socket):
+        if request.path != "/api/websocket":
+            await socket.close(1008)
+            return
+
+        session = {"socket": socket, "events": None, "trigger": None}
+        await socket.send_json({"type": "auth_required", "ha_version": "2024.6.0"})
+        authed = False
+        try:
+            while True:
+                text = await socket.recv()
+                if text is None:
+                    return
+                message = json.loads(text)
+                kind = message.get("type")
+                if not authed:
+                    if kind == "auth" and (not self.token or message.get("access_token") == self.token):
+                        authed = True
+                        self.sessions[id(session)] = session
+                        await socket.send_json({"type": "auth_ok", "ha_version": "2024.6.0"})
+                    else:
+                        await socket.send_json({"type": "auth_invalid", "message": "Invalid access token or password"})
+                        return
+                    continue
+
+                msg_id = message.get("id")
+                if kind == "subscribe_events":
+                    session["events"] = msg_id
+                    await socket.send_json({"id": msg_id, "type": "result", "success": True, "result": None})
+                elif kind == "subscribe_trigger":
+                    entity_ids = message.get("trigger", {}).get("entity_id", [])
+                    if isinstance(entity_ids, str):
+                        entity_ids = [entity_ids]
+                    session["trigger"] = (msg_id, set(entity_ids))
+                    await socket.send_json({"id": msg_id, "type": "result", "success": True, "result": None})
+                elif kind == "unsubscribe_events":
+                    subscription = message.get("subscription")
+                    if session["events"] == subscription:
+                        session["events"] = None
+                    if session["trigger"] and session["trigger"][0] == subscription:
+                        session["trigger"] = None
+                    await socket.send_json({"id": msg_id, "type": "result", "success": True, "result": None})
+                elif kind == "ping":
+                    await socket.send_json({"id": msg_id, "type": "pong"})
+                else:
+                    await socket.send_json({"id": msg_id, "type": "result", "success": False,
+                                            "error": {"code": "unknown_command", "message": "Unknown command."}})
+        finally:
+            self.sessions.pop(id(session), None)
+
+    async def _publish(self, old, new):
+        for session in list(self.sessions.values()):
+            socket = session["socket"]
+            if session["events"] is not None:
+                self.events_sent += 1
+                await socket.send_json({
+                    "id": session["events"], "type": "event",
+                    "event": {"event_type": "state_changed",
+                              "data": {"entity_id": new["entity_id"], "old_state": old, "new_state": new},
+                              "origin": "LOCAL", "time_fired": new["last_updated"]},
+                })
+            trigger = session["trigger"]
+            if trigger and new["entity_id"] in trigger[1]:
+                self.events_sent += 1
+                await socket.send_json({
+                    "id": trigger[0], "type": "event",
+                    "event": {"variables": {"trigger": {"id": "0", "idx": "0", "platform": "state",
+                                                        "entity_id": new["entity_id"], "from_state": old,
+                                                        "to_state": new, "for": None}},
+                              "context": new["context"]},
+                })
+
+    async def churn(self):
+        """Background sensor updates at churn_per_s, pushed to subscribers."""
+        sensors = [entity_id for entity_id in self.states if entity_id.startswith("sensor.")]
+        if self.churn_per_s <= 0 or not sensors:
+            return
+        while True:
+            await asyncio.sleep(1.0 / self.churn_per_s)
+            entity_id = self.random.choice(sensors)
+            current = self.states[entity_id]
+            try:
+                value = float(current["state"]) * self.random.uniform(0.97, 1.03)
+            except ValueError:
+                value = 0.0
+            old, new = self._set(entity_id, "%.1f" % value, current["attributes"])
+            await self._publish(old, new)
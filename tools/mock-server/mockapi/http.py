@@ -0,0 +1,377 @@
+"""Minimal asyncio HTTP/1.1 + WebSocket server (stdlib only).
+
+Supports what the firmware's ApiService and the WebSockets client use:
+keep-alive, Content-Length or chunked bodies, gzip/deflate when asked,
+ETag / If-None-Match, and RFC 6455 text frames with ping/pong and close.
+Latency and error injection are applied per request from ServiceKnobs.
+"""
+
+import asyncio
+import base64
+import gzip
+import hashlib
+import json
+import random
+import struct
+import time
+import zlib
+from urllib.parse import parse_qsl, urlsplit
+
+WS_GUID = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11"
+
+REASONS = {
+    200: "OK", 201: "Created", 204: "No Content", 304: "Not Modified", 400: "Bad Request",
+    401: "Unauthorized", 404: "Not Found", 405: "Method Not Allowed", 429: "Too Many Requests",
+    500: "Internal Server Error", 502: "Bad Gateway", 503: "Service Unavailable",
+}
+
+
+class ServiceKnobs:
+    """Per-service fault and transport settings (changeable at runtime via /_mock/config)."""
+
+    def __init__(self, latency_ms=0, jitter_ms=0, error_rate=0.0, error_status=503, retry_after=5,
+                 compress=True, chunked=False, ws_lifetime_s=0.0):
+        self.latency_ms = latency_ms
+        self.jitter_ms = jitter_ms
+        self.error_rate = error_rate
+        self.error_status = error_status
+        self.retry_after = retry_after
+        self.compress = compress
+        self.chunked = chunked
+        self.ws_lifetime_s = ws_lifetime_s
+
+    def as_dict(self):
+        return dict(self.__dict__)
+
+    def update(self, values):
+        for key, value in values.items():
+            if key in self.__dict__:
+                setattr(self, key, type(getattr(self, key))(value))
+
+
+class Stats:
+    def __init__(self):
+        self.requests = 0
+        self.errors_injected = 0
+        self.bytes_out = 0
+        self.bytes_out_raw = 0
+        self.connections = 0
+        self.ws_sessions = 0
+        self.ws_messages_out = 0
+        self.not_modified = 0
+
+    def as_dict(self):
+        return dict(self.__dict__)
+
+
+class Request:
+    def __init__(self, method, target, headers, body):
+        self.method = method
+        parts = urlsplit(target)
+        self.path = parts.path
+        self.query = dict(parse_qsl(parts.query, keep_blank_values=True))
+        self.headers = headers
+        self.body = body
+
+    def json(self):
+        if not self.body:
+            return {}
+        return json.loads(self.body.decode("utf-8"))
+
+    def form(self):
+        """Body parameters (Slack accepts form-encoded or JSON) merged over the query."""
+        values = dict(self.query)
+        content_type = self.headers.get("content-type", "")
+        if self.body:
+            if "json" in content_type:
+                values.update(self.json())
+            else:
+                values.update(parse_qsl(self.body.decode("utf-8"), keep_blank_values=True))
+        return values
+
+    def bearer(self):
+        auth = self.headers.get("authorization", "")
+        return auth[7:] if auth.lower().startswith("bearer ") else ""
+
+
+class Response:
+    def __init__(self, status=200, body=b"", content_type="application/json", headers=None, etag=False):
+        self.status = status
+        self.body = body if isinstance(body, bytes) else body.encode("utf-8")
+        self.headers = dict(headers or {})
+        if self.body or status not in (204, 304):
+            self.headers.setdefault("Content-Type", content_type)
+        self.etag = etag
+
+
+def json_response(value, status=200, headers=None, etag=False):
+    # Compact separators, like the real services
+    return Response(status, json.dumps(value, separators=(",", ":"), ensure_ascii=False), headers=headers,
+                    etag=etag)
+
+
+def error_response(status, message):
+    return json_response({"message": message}, status)
+
+
+class WebSocket:
+    """Server side of one WebSocket connection (text frames only)."""
+
+    def __init__(self, reader, writer, stats):
+        self._reader = reader
+        self._writer = writer
+        self._stats = stats
+        self.closed = False
+
+    async def recv(self):
+        """Next text message, or None once the peer closed."""
+        message = b""
+        while not self.closed:
+            try:
+                header = await self._reader.readexactly(2)
+            except (asyncio.IncompleteReadError, ConnectionError):
+                self.closed = True
+                return None
+            fin = header[0] & 0x80
+            opcode = header[0] & 0x0F
+            length = header[1] & 0x7F
+            if length == 126:
+                length = struct.unpack("!H", await self._reader.readexactly(2))[0]
+            elif length == 127:
+                length = struct.unpack("!Q", await self._reader.readexactly(8))[0]
+            mask = await self._reader.readexactly(4) if header[1] & 0x80 else None
+            payload = await self._reader.readexactly(length)
+            if mask:
+                payload = bytes(b ^ mask[i % 4] for i, b in enumerate(payload))
+
+            if opcode == 0x8:
+                await self._send_frame(0x8, payload[:2])
+                self.closed = True
+                return None
+            if opcode == 0x9:
+                await self._send_frame(0xA, payload)
+                continue
+            if opcode == 0xA:
+                continue
+            message += payload
+            if fin:
+                return message.decode("utf-8", errors="replace")
+        return None
+
+    async def send(self, text):
+        if self.closed:
+            return
+        self._stats.ws_messages_out += 1
+        await self._send_frame(0x1, text.encode("utf-8"))
+
+    async def send_json(self, value):
+        await self.send(json.dumps(value, separators=(",", ":"), ensure_ascii=False))
+
+    async def close(self, code=1000):
+        if not self.closed:
+            await self._send_frame(0x8, struct.pack("!H", code))
+            self.closed = True
+        self._writer.close()
+
+    async def _send_frame(self, opcode, payload):
+        length = len(payload)
+        if length < 126:
+            header = struct.pack("!BB", 0x80 | opcode, length)
+        elif length < 65536:
+            header = struct.pack("!BBH", 0x80 | opcode, 126, length)
+        else:
+            header = struct.pack("!BBQ", 0x80 | opcode, 127, length)
+        try:
+            self._writer.write(header + payload)
+            await self._writer.drain()
+            self._stats.bytes_out += len(header) + length
+        except ConnectionError:
+            self.closed = True
+
+
+class MockServer:
+    """One listening port: routes HTTP requests and WebSocket upgrades to a service."""
+
+    def __init__(self, name, service, knobs, verbose=False):
+        self.name = name
+        self.service = service
+        self.knobs = knobs
+        self.stats = Stats()
+        self.verbose = verbose
+
+    async def start(self, host, port):
+        return await asyncio.start_server(self._handle_connection, host, port)
+
+    async def _handle_connection(self, reader, writer):
+        self.stats.connections += 1
+        try:
+            while True:
+                request = await self._read_request(reader)
+                if request is None:
+                    break
+
+                if request.headers.get("upgrade", "").lower() == "websocket":
+                    await self._upgrade(request, reader, writer)
+                    return
+
+                response = await self._respond(request)
+                keep_alive = request.headers.get("connection", "").lower() != "close"
+                await self._write_response(writer, request, response, keep_alive)
+                if not keep_alive:
+                    break
+        except (ConnectionError, asyncio.IncompleteReadError):
+            pass
+        finally:
+            writer.close()
+
+    async def _read_request(self, reader):
+        line = await reader.readline()
+        if not line:
+            return None
+        try:
+            method, target, _ = line.decode("latin-1").split(" ", 2)
+        except ValueError:
+            return None
+
+        headers = {}
+        while True:
+            line = await reader.readline()
+            if line in (b"\r\n", b"\n", b""):
+                break
+            name, _, value = line.decode("latin-1").partition(":")
+            headers[name.strip().lower()] = value.strip()
+
+        body = b""
+        if "content-length" in headers:
+            body = await reader.readexactly(int(headers["content-length"]))
+        elif headers.get("transfer-encoding", "").lower() == "chunked":
+            while True:
+                size = int((await reader.readline()).split(b";")[0], 16)
+                if size == 0:
+                    await reader.readline()
+                    break
+                body += await reader.readexactly(size)
+                await reader.readline()
+        return Request(method.upper(), target, headers, body)
+
+    async def _respond(self, request):
+        self.stats.requests += 1
+        started = time.monotonic()
+
+        if request.path.startswith("/_mock/"):
+            response = self._control(request)
+        else:
+            knobs = self.knobs
+            delay = knobs.latency_ms + (random.uniform(-knobs.jitter_ms, knobs.jitter_ms) if knobs.jitter_ms else 0)
+            if delay > 0:
+                await asyncio.sleep(delay / 1000.0)
+
+            if knobs.error_rate > 0 and random.random() < knobs.error_rate:
+                self.stats.errors_injected += 1
+                headers = {"Retry-After": str(knobs.retry_after)} if knobs.error_status in (429, 503) else {}
+                response = json_response({"message": "injected failure"}, knobs.error_status, headers)
+            else:
+                try:
+                    response = await self.service.handle(request)
+                except Exception as error:  # A broken handler should show up as a 500, not kill the socket
+                    response = error_response(500, "mock handler failed: %r" % error)
+
+        if self.verbose:
+            print("[%s] %s %s -> %d (%.0f ms, %d B)" % (self.name, request.method, request.path, response.status,
+                                                       (time.monotonic() - started) * 1000, len(response.body)))
+        return response
+
+    def _control(self, request):
+        if request.path == "/_mock/stats":
+            stats = self.stats.as_dict()
+            stats.update(self.service.stats())
+            return json_response(stats)
+        if request.path == "/_mock/config":
+            if request.method == "POST":
+                self.knobs.update(request.json())
+            return json_response(self.knobs.as_dict())
+        return error_response(404, "unknown control endpoint")
+
+    async def _write_response(self, writer, request, response, keep_alive):
+        body = response.body
+        headers = dict(response.headers)
+
+        if response.etag and response.status == 200:
+            etag = '"%s"' % hashlib.sha1(body).hexdigest()[:16]
+            headers["ETag"] = etag
+            if request.headers.get("if-none-match") == etag:
+                self.stats.not_modified += 1
+                response = Response(304)
+                body = b""
+
+        if request.method == "HEAD" or response.status in (204, 304) or response.status < 200:
+            body = b""
+        self.stats.bytes_out_raw += len(body)
+
+        accepted = request.headers.get("accept-encoding", "")
+        if body and self.knobs.compress and len(body) >= 256:
+            if "gzip" in accepted:
+                body = gzip.compress(body, 6)
+                headers["Content-Encoding"] = "gzip"
+            elif "deflate" in accepted:
+                body = zlib.compress(body, 6)
+                headers["Content-Encoding"] = "deflate"
+
+        status = response.status
+        lines = ["HTTP/1.1 %d %s" % (status, REASONS.get(status, "Status"))]
+        lines += ["%s: %s" % item for item in headers.items()]
+        lines.append("Connection: %s" % ("keep-alive" if keep_alive else "close"))
+
+        bodyless = request.method == "HEAD" or status in (204, 304)
+        if bodyless:
+            payload = b""
+        elif self.knobs.chunked:
+            lines.append("Transfer-Encoding: chunked")
+            payload = b""
+            for offset in range(0, len(body), 1024):
+                chunk = body[offset:offset + 1024]
+                payload += b"%x\r\n%s\r\n" % (len(chunk), chunk)
+            payload += b"0\r\n\r\n"
+        else:
+            lines.append("Content-Length: %d" % len(body))
+            payload = body
+
+        data = ("\r\n".join(lines) + "\r\n\r\n").encode("latin-1") + payload
+        writer.write(data)
+        await writer.drain()
+        self.stats.bytes_out += len(data)
+
+    async def _upgrade(self, request, reader, writer):
+        handler = getattr(self.service, "websocket", None)
+        key = request.headers.get("sec-websocket-key", "")
+        if not handler or not key:
+            await self._write_response(writer, request, error_response(404, "no websocket here"), False)
+            return
+
+        accept = base64.b64encode(hashlib.sha1((key + WS_GUID).encode("ascii")).digest()).decode("ascii")
+        writer.write(("HTTP/1.1 101 Switching Protocols\r\nUpgrade: websocket\r\nConnection: Upgrade\r\n"
+                      "Sec-WebSocket-Accept: %s\r\n\r\n" % accept).encode("latin-1"))
+        await writer.drain()
+
+        self.stats.ws_sessions += 1
+        socket = WebSocket(reader, writer, self.stats)
+        if self.verbose:
+            print("[%s] WebSocket %s opened" % (self.name, request.path))
+
+        session = asyncio.ensure_future(handler(request, socket))
+        lifetime = self.knobs.ws_lifetime_s
+        try:
+            if lifetime > 0:
+                await asyncio.wait_for(asyncio.shield(session), lifetime)
+            else:
+                await session
+        except asyncio.TimeoutError:
+            # Simulated server-side drop, to exercise client reconnects
+            drop = getattr(self.service, "before_drop", None)
+            if drop:
+                await drop(socket)
+            session.cancel()
+        finally:
+            await socket.close()
+            if self.verbose:
+                print("[%s] WebSocket %s closed" % (self.name, request.path))
@@ -0,0 +1,226 @@
+"""Slack Web API and Socket Mode subset used by SlackController.
+
+Web API (under /api): auth.test, conversations.list, conversations.history
+(oldest / limit / cursor paging), users.list (limit / cursor paging),
+chat.postMessage and apps.connections.open. Every body starts with "ok",
+as the controller's streaming parser expects.
+
+Socket Mode (/link): hello, then events_api envelopes at message_rate per
+second (a message, and an app_mention for every fifth one). Each event is
+also appended to the channel history, so polling after a drop finds it.
+Acks are counted; before a simulated drop a refresh_requested disconnect
+is sent, like Slack does before rotating a connection.
+"""
+
+import asyncio
+import base64
+import itertools
+import json
+import random
+import time
+
+from .http import json_response
+
+WORDS = ("deploy build review lunch standup release ticket merge flaky test cache latency heap "
+         "socket retry backoff firmware display battery wifi").split()
+
+
+def ok_response(**fields):
+    # "ok" first: the controller finds it with a forward-only scan
+    return json_response(dict(ok=True, **fields))
+
+
+def slack_error(error):
+    return json_response({"ok": False, "error": error})
+
+
+def encode_cursor(offset):
+    return base64.urlsafe_b64encode(("offset:%d" % offset).encode("ascii")).decode("ascii")
+
+
+def decode_cursor(cursor):
+    try:
+        return int(base64.urlsafe_b64decode(cursor).decode("ascii").split(":", 1)[1])
+    except (ValueError, IndexError):
+        return 0
+
+
+class Slack:
+    def __init__(self, token="", user_count=300, channel_count=20, history=200, message_rate=0.0,
+                 seed=3, public_url=None):
+        self.token = token
+        self.message_rate = message_rate
+        self.public_url = public_url    # ws://host:port for apps.connections.open; from Host header if unset
+        self.random = random.Random(seed)
+        self.user_id = "U000SELF"
+        self.users = [self._user(index) for index in range(user_count)]
+        self.channels = [self._channel(index) for index in range(channel_count)]
+        self.clock = time.time() - 86400
+        self.history = {channel["id"]: [] for channel in self.channels}
+        for _ in range(history):
+            self._new_message(self.random.choice(self.channels)["id"], advance=86400.0 / max(history, 1))
+        self.tickets = set()
+        self.envelopes = itertools.count(1)
+        self.sockets = set()
+        self.acks = 0
+        self.posted = 0
+
+    # ---- model ---------------------------------------------------------------
+
+    def _user(self, index):
+        first = "user%d" % index
+        return {
+            "id": "U%07d" % index, "team_id": "T0MOCK", "name": first, "deleted": index % 37 == 36,
+            "real_name": "Mock User %d" % index,
+            "profile": {"display_name": first if index % 3 else "", "real_name": "Mock User %d" % index,
+                        "status_text": "", "status_emoji": "",
+                        "image_48": "https://avatars.example/%d_48.png" % index,
+                        "image_192": "https://avatars.example/%d_192.png" % index},
+            "is_bot": False, "tz": "Europe/Amsterdam", "updated": 1700000000,
+        }
+
+    def _channel(self, index):
+        if index % 4 == 3:
+            user = self.random.choice(self.users)["id"] if self.users else "U0000000"
+            return {"id": "D%07d" % index, "is_im": True, "user": user, "is_member": True, "created": 1700000000}
+        return {"id": "C%07d" % index, "name": "channel-%d" % index, "is_channel": True, "is_im": False,
+                "is_member": index % 5 != 4, "is_archived": False, "created": 1700000000,
+                "topic": {"value": "Mock topic %d" % index}, "purpose": {"value": ""}, "num_members": 12}
+
+    def _new_message(self, channel_id, advance=None, mention=False):
+        # ts strictly increases, as the controller's cursor comparison relies on it
+        if advance is None:
+            self.clock = max(self.clock + 0.000001, time.time())
+        else:
+            self.clock += advance
+        user = self.random.choice(self.users)["id"] if self.users else "U0000000"
+        text = " ".join(self.random.choice(WORDS) for _ in range(self.random.randint(3, 25)))
+        if mention:
+            text = "<@%s> %s" % (self.user_id, text)
+        message = {"type": "message", "user": user, "text": text, "ts": "%.6f" % self.clock, "team": "T0MOCK"}
+        if self.random.random() < 0.05:
+            message["subtype"] = "channel_join"
+        self.history[channel_id].append(message)
+        return message
+
+    def stats(self):
+        return {"messages": sum(len(messages) for messages in self.history.values()), "posted": self.posted,
+                "socket_sessions": len(self.sockets), "acks": self.acks}
+
+    # ---- Web API ---------------------------------------------------------------
+
+    async def handle(self, request):
+        if not request.path.startswith("/api/"):
+            return json_response({"ok": False, "error": "unknown_method"}, 404)
+        method = request.path[len("/api/"):]
+        params = request.form()
+
+        token = request.bearer() or params.get("token", "")
+        if self.token and token != self.token:
+            return slack_error("invalid_auth")
+
+        if method == "auth.test":
+            return ok_response(url="https://mock.slack.example/", team="Mock Team", user="self",
+                               team_id="T0MOCK", user_id=self.user_id)
+
+        if method == "conversations.list":
+            return ok_response(channels=self.channels, response_metadata={"next_cursor": ""})
+
+        if method == "conversations.history":
+            messages = self.history.get(params.get("channel", ""))
+            if messages is None:
+                return slack_error("channel_not_found")
+            oldest = float(params.get("oldest") or 0)
+            limit = min(int(params.get("limit") or 100), 999)
+            # Newest first, like Slack
+            newer = [message for message in reversed(messages) if float(message["ts"]) > oldest]
+            start = decode_cursor(params.get("cursor", "")) if params.get("cursor") else 0
+            page = newer[start:start + limit]
+            more = start + limit < len(newer)
+            return ok_response(messages=page, has_more=more, pin_count=0,
+                               response_metadata={"next_cursor": encode_cursor(start + limit) if more else ""})
+
+        if method == "users.list":
+            limit = min(int(params.get("limit") or 200), 1000)
+            start = decode_cursor(params.get("cursor", "")) if params.get("cursor") else 0
+            page = self.users[start:start + limit]
+            more = start + limit < len(self.users)
+            return ok_response(members=page, cache_ts=int(time.time()),
+                               response_metadata={"next_cursor": encode_cursor(start + limit) if more else ""})
+
+        if method == "chat.postMessage":
+            channel = params.get("channel", "")
+            if channel not in self.history:
+                return slack_error("channel_not_found")
+            message = self._new_message(channel)
+            message.pop("subtype", None)
+            message.update(user=self.user_id, text=params.get("text", ""))
+            self.posted += 1
+            return ok_response(channel=channel, ts=message["ts"], message=message)
+
+        if method == "apps.connections.open":
+            ticket = "%016x" % self.random.getrandbits(64)
+            self.tickets.add(ticket)
+            base = self.public_url or "ws://%s" % request.headers.get("host", "127.0.0.1:8125")
+            return ok_response(url="%s/link/?ticket=%s&app_id=AMOCK" % (base, ticket))
+
+        return slack_error("unknown_method")
+
+    # ---- Socket Mode -------------------------------------------------------------
+
+    async def websocket(self, request, socket):
+        if not request.path.startswith("/link") or request.query.get("ticket") not in self.tickets:
+            await socket.send_json({"type": "disconnect", "reason": "link_disabled"})
+            return
+        self.tickets.discard(request.query["ticket"])
+
+        self.sockets.add(socket)
+        await socket.send_json({"type": "hello", "num_connections": 1,
+                                "connection_info": {"app_id": "AMOCK"},
+                                "debug_info": {"host": "mock-socket", "approximate_connection_time": 18060}})
+        emitter = asyncio.ensure_future(self._emit(socket))
+        try:
+            while True:
+                text = await socket.recv()
+                if text is None:
+                    return
+                try:
+                    if json.loads(text).get("envelope_id"):
+                        self.acks += 1
+                except ValueError:
+                    pass
+        finally:
+            emitter.cancel()
+            self.sockets.discard(socket)
+
+    async def before_drop(self, socket):
+        await socket.send_json({"type": "disconnect", "reason": "refresh_requested",
+                                "debug_info": {"host": "mock-socket"}})
+
+    async def _emit(self, socket):
+        if self.message_rate <= 0 or not self.channels:
+            return
+        count = 0
+        while True:
+            await asyncio.sleep(1.0 / self.message_rate)
+            count += 1
+            channel = self.random.choice(self.channels)
+            mention = count % 5 == 0 and not channel["is_im"]
+            message = self._new_message(channel["id"], mention=mention)
+            event = dict(message, channel=channel["id"], channel_type="im" if channel["is_im"] else "channel",
+                         event_ts=message["ts"])
+            await self._envelope(socket, event)
+            if mention:
+                await self._envelope(socket, dict(event, type="app_mention"))
+
+    async def _envelope(self, socket, event):
+        await socket.send_json({
+            "envelope_id": "mock-%d" % next(self.envelopes),
+            "type": "events_api",
+            "accepts_response_payload": False,
+            "retry_attempt": 0,
+            "retry_reason": "",
+            "payload": {"token": "mock", "team_id": "T0MOCK", "api_app_id": "AMOCK", "type": "event_callback",
+                        "event_id": "Ev%d" % self.random.getrandbits(40), "event_time": int(time.time()),
+                        "event": event},
+        })
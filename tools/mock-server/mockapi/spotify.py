@@ -0,0 +1,138 @@
+"""Spotify Web API player subset used by SpotifyController.
+
+GET /v1/me/player/currently-playing (200 with an ETag, or 204 when idle)
+and the playback commands: PUT play / pause / volume / seek / shuffle /
+repeat, POST next / previous. Playback runs on a clock, so progress
+advances and tracks end like on a real player.
+"""
+
+import random
+import time
+
+from .http import Response, error_response, json_response
+
+ARTISTS = ["The Mock Ups", "Stub & Fixture", "Latency", "Null Pointer", "Keep-Alive", "Chunked Encoding"]
+
+
+class Spotify:
+    def __init__(self, token="", track_count=50, idle=False, seed=2, market_count=180):
+        self.token = token
+        self.random = random.Random(seed)
+        # available_markets padding makes the real payload ~10 KB; keep it comparable
+        markets = ["M%d" % index for index in range(market_count)]
+        self.tracks = [self._track(index, markets) for index in range(track_count)]
+        self.index = 0
+        self.playing = not idle
+        self.active = not idle
+        self.position_ms = 0
+        self.resumed_at = time.monotonic()
+        self.volume = 50
+        self.shuffle = False
+        self.repeat = "off"
+        self.commands = 0
+        self.changed_at = int(time.time() * 1000)
+
+    def _track(self, index, markets):
+        artist = ARTISTS[index % len(ARTISTS)]
+        album = "Album %d" % (index // 10)
+        return {
+            "album": {
+                "album_type": "album", "artists": [{"name": artist, "id": "artist%d" % index}],
+                "available_markets": markets, "id": "album%d" % (index // 10), "name": album,
+                "images": [{"height": size, "width": size,
+                            "url": "https://i.scdn.co/image/mock%d_%d" % (index // 10, size)}
+                           for size in (640, 300, 64)],
+                "release_date": "2020-01-01", "total_tracks": 10, "type": "album",
+            },
+            "artists": [{"name": artist, "id": "artist%d" % index, "type": "artist"}],
+            "available_markets": markets,
+            "disc_number": 1,
+            "duration_ms": self.random.randint(150000, 320000),
+            "explicit": False,
+            "external_ids": {"isrc": "MOCK%08d" % index},
+            "id": "track%06d" % index,
+            "name": "Song %d" % index,
+            "popularity": self.random.randint(0, 100),
+            "track_number": index % 10 + 1,
+            "type": "track",
+            "uri": "spotify:track:track%06d" % index,
+        }
+
+    def stats(self):
+        return {"track": self.tracks[self.index]["id"], "playing": self.playing, "commands": self.commands}
+
+    def _progress(self):
+        """Advance the playback clock, moving to the next track at the end."""
+        if self.playing:
+            now = time.monotonic()
+            self.position_ms += int((now - self.resumed_at) * 1000)
+            self.resumed_at = now
+            while self.position_ms >= self.tracks[self.index]["duration_ms"]:
+                self.position_ms -= self.tracks[self.index]["duration_ms"]
+                if self.repeat != "track":
+                    self.index = (self.index + 1) % len(self.tracks)
+        return self.position_ms
+
+    def _skip(self, step):
+        self._progress()
+        if step < 0 and self.position_ms > 3000:
+            self.position_ms = 0
+            return
+        self.index = (self.index + step) % len(self.tracks)
+        self.position_ms = 0
+
+    async def handle(self, request):
+        if self.token and request.bearer() != self.token:
+            return json_response({"error": {"status": 401, "message": "Invalid access token"}}, 401)
+
+        path = request.path
+        if not path.startswith("/v1/me/player"):
+            return error_response(404, "Service not found")
+        action = path[len("/v1/me/player"):]
+
+        if action == "/currently-playing" and request.method in ("GET", "HEAD"):
+            if not self.active:
+                return Response(204)
+            progress = self._progress()
+            return json_response({
+                # Last state change, not now: an unchanged paused player gets a 304
+                "timestamp": self.changed_at,
+                "context": {"type": "playlist", "uri": "spotify:playlist:mock"},
+                "progress_ms": progress,
+                "item": self.tracks[self.index],
+                "currently_playing_type": "track",
+                "actions": {"disallows": {"resuming": self.playing}},
+                "is_playing": self.playing,
+            }, etag=True)
+
+        self.commands += 1
+        if action == "/play" and request.method == "PUT":
+            self._progress()
+            self.active = True
+            self.playing = True
+            self.resumed_at = time.monotonic()
+        elif action == "/pause" and request.method == "PUT":
+            self._progress()
+            self.playing = False
+        elif action == "/next" and request.method == "POST":
+            self._skip(1)
+        elif action == "/previous" and request.method == "POST":
+            self._skip(-1)
+        elif action == "/seek" and request.method == "PUT":
+            self._progress()
+            self.position_ms = int(request.query.get("position_ms", 0))
+        elif action == "/volume" and request.method == "PUT":
+            self.volume = int(request.query.get("volume_percent", self.volume))
+        elif action == "/shuffle" and request.method == "PUT":
+            self.shuffle = request.query.get("state") == "true"
+        elif action == "/repeat" and request.method == "PUT":
+            self.repeat = request.query.get("state", "off")
+        else:
+            self.commands -= 1
+            return error_response(404, "Service not found")
+
+        self.changed_at = int(time.time() * 1000)
+        if not self.active:
+            return json_response({"error": {"status": 404, "message": "Player command failed: No active device found",
+                                            "reason": "NO_ACTIVE_DEVICE"}}, 404)
+        return Response(204)